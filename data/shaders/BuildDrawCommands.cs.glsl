@@ -0,0 +1,78 @@
+#version 460 core
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+struct TInstanceGroup
+{
+    uint IndexCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint FirstObject;
+    uint BatchIndex;
+    uint BatchFirstInstanceGroup;
+    uint _padding1;
+    uint _padding2;
+};
+
+struct TDrawElementsIndirectCommand
+{
+    uint IndexCount;
+    uint InstanceCount;
+    uint FirstIndex;
+    int BaseVertex;
+    uint BaseInstance;
+};
+
+layout (binding = 4, std430) restrict readonly buffer TInstanceGroupsBuffer
+{
+    TInstanceGroup InstanceGroups[];
+};
+
+layout (binding = 5, std430) restrict readonly buffer TInstanceCountsBuffer
+{
+    uint InstanceCounts[];
+};
+
+layout (binding = 6, std430) restrict writeonly buffer TDrawCommandsBuffer
+{
+    TDrawElementsIndirectCommand DrawCommands[];
+};
+
+layout (binding = 7, std430) restrict buffer TDrawCountsBuffer
+{
+    uint DrawCounts[];
+};
+
+layout (location = 0) uniform uint u_instance_group_count;
+layout (location = 1) uniform uint u_batch_count;
+layout (location = 2) uniform uint u_bucket_instance_stride;
+layout (location = 3) uniform uint u_depth_bucket_count;
+layout (location = 4) uniform uint u_first_view_bucket_index;
+
+void main()
+{
+    uint instanceGroupIndex = gl_GlobalInvocationID.x;
+    uint viewBucketIndex = u_first_view_bucket_index + gl_GlobalInvocationID.y;
+    if (instanceGroupIndex >= u_instance_group_count)
+    {
+        return;
+    }
+
+    uint instanceCount = InstanceCounts[viewBucketIndex * u_instance_group_count + instanceGroupIndex];
+    if (instanceCount == 0)
+    {
+        return;
+    }
+
+    // one instanced draw per visible group, compacted into the batch's slice of this view and depth bucket
+    TInstanceGroup instanceGroup = InstanceGroups[instanceGroupIndex];
+    uint viewIndex = viewBucketIndex / u_depth_bucket_count;
+    uint depthBucket = viewBucketIndex % u_depth_bucket_count;
+    uint drawIndex = atomicAdd(DrawCounts[(viewIndex * u_batch_count + instanceGroup.BatchIndex) * u_depth_bucket_count + depthBucket], 1);
+    DrawCommands[viewBucketIndex * u_bucket_instance_stride + instanceGroup.BatchFirstInstanceGroup + drawIndex] = TDrawElementsIndirectCommand(
+        instanceGroup.IndexCount,
+        instanceCount,
+        instanceGroup.FirstIndex,
+        instanceGroup.BaseVertex,
+        viewBucketIndex * u_bucket_instance_stride + instanceGroup.FirstObject);
+}
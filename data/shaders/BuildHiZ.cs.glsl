@@ -0,0 +1,41 @@
+#version 460 core
+
+layout (local_size_x = 8, local_size_y = 8, local_size_z = 1) in;
+
+layout (binding = 0) uniform sampler2D s_depth;
+layout (binding = 0, r32f) uniform restrict readonly image2D s_source_level;
+layout (binding = 1, r32f) uniform restrict writeonly image2D s_target_level;
+
+layout (location = 0) uniform int u_is_first_level;
+
+void main()
+{
+    ivec2 targetSize = imageSize(s_target_level);
+    ivec2 target = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(target, targetSize)))
+    {
+        return;
+    }
+
+    if (u_is_first_level != 0)
+    {
+        imageStore(s_target_level, target, vec4(texelFetch(s_depth, target, 0).r));
+        return;
+    }
+
+    // keep the farthest depth of the footprint, odd sized levels fold their last row and column into the last texel
+    ivec2 sourceSize = imageSize(s_source_level);
+    ivec2 sourceFirst = target * 2;
+    ivec2 sourceLast = min(sourceFirst + 1 + ivec2(equal(target, targetSize - 1)) * (sourceSize & 1), sourceSize - 1);
+
+    float farthestDepth = 0.0;
+    for (int y = sourceFirst.y; y <= sourceLast.y; ++y)
+    {
+        for (int x = sourceFirst.x; x <= sourceLast.x; ++x)
+        {
+            farthestDepth = max(farthestDepth, imageLoad(s_source_level, ivec2(x, y)).r);
+        }
+    }
+
+    imageStore(s_target_level, target, vec4(farthestDepth));
+}
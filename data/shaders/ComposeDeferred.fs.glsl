@@ -6,8 +6,8 @@ layout(location = 0) out vec4 o_color;
 
 layout(binding = 0) uniform sampler2D s_texture_depth;
 layout(binding = 1) uniform sampler2D s_texture_gbuffer_albedo;
-layout(binding = 2) uniform sampler2D s_texture_gbuffer_normal_ao;
-layout(binding = 3) uniform sampler2D s_texture_gbuffer_velocity_roughness_metallic;
+layout(binding = 2) uniform sampler2D s_texture_gbuffer_normal; // octahedral
+layout(binding = 3) uniform sampler2D s_texture_gbuffer_ao_roughness_metallic;
 layout(binding = 4) uniform sampler2D s_texture_gbuffer_emissive;
 
 layout(binding = 5) uniform sampler2D s_shadow_maps[8];
@@ -21,6 +21,8 @@ layout(location = 0) uniform mat4 u_camera_inverse_view_projection;
 layout(location = 4) uniform vec4 u_camera_position;
 layout(location = 5) uniform vec3 u_sun_position;
 layout(location = 6) uniform vec2 u_screen_size;
+layout(location = 7) uniform mat4 u_camera_view;
+layout(location = 11) uniform uint u_global_light_count;
 
 struct TGpuGlobalLight {
     mat4 ShadowViewProjectionMatrix;
@@ -33,7 +35,16 @@ layout(binding = 1, std140) uniform GlobalLights {
     TGpuGlobalLight Lights[8];
 } u_global_lights;
 
+#include "Include.LightClusters.glsl"
+
+layout (binding = 1, std430) restrict readonly buffer TLightClustersBuffer
+{
+    uint LightClusterCounts[LIGHT_CLUSTER_COUNT];
+    uint LightClusterIndices[]; // LIGHT_CLUSTER_MAX_LIGHTS per cluster, filled by LightClusters.cs.glsl
+};
+
 #include "Include.Pi.glsl"
+#include "Include.BasicFunctions.glsl"
 
 vec3 FresnelSchlick(float cosTheta, vec3 F0) {
     return F0 + (1.0 - F0) * pow(clamp(1.0 - cosTheta, 0.0, 1.0), 5.0);
@@ -211,16 +222,16 @@ void main()
     }
 
     vec4 albedo = texelFetch(s_texture_gbuffer_albedo, uv_ss, 0);
-    vec4 normal_ao = texelFetch(s_texture_gbuffer_normal_ao, uv_ss, 0);
-    vec4 velocity_roughness_metallic = texelFetch(s_texture_gbuffer_velocity_roughness_metallic, uv_ss, 0);
+    vec2 encodedNormal = texelFetch(s_texture_gbuffer_normal, uv_ss, 0).rg;
+    vec3 ao_roughness_metallic = texelFetch(s_texture_gbuffer_ao_roughness_metallic, uv_ss, 0).rgb;
     vec3 emissive = texelFetch(s_texture_gbuffer_emissive, uv_ss, 0).rgb;
 
-    float roughness = velocity_roughness_metallic.b;
-    float metallic = velocity_roughness_metallic.a;
+    float roughness = ao_roughness_metallic.g;
+    float metallic = ao_roughness_metallic.b;
 
     vec3 fragmentPosition_ws = ReconstructFragmentWorldPositionFromDepth(depth, u_screen_size, u_camera_inverse_view_projection);
     vec3 V = normalize(u_camera_position.xyz - fragmentPosition_ws);
-    vec3 N = normalize(normal_ao.xyz);
+    vec3 N = DecodeOctahedral(encodedNormal);
     vec3 R = reflect(-V, N);
 
     float alpha     = roughness * roughness;
@@ -234,7 +245,7 @@ void main()
 
     // direct lighting
     vec3 directLighting = vec3(0.0);
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i < int(u_global_light_count); i++) {
         TGpuGlobalLight light = u_global_lights.Lights[i];
         if (light.Properties.x == 1) {
             vec3 L = normalize(-light.Direction.xyz);
@@ -253,6 +264,18 @@ void main()
         }
     }
 
+    // local lights, only the ones binned into this pixel's cluster
+    float viewDepth = -(u_camera_view * vec4(fragmentPosition_ws, 1.0)).z;
+    uint cluster = GetLightClusterIndex(GetLightClusterTile(ivec2(floor(gl_FragCoord.xy)), textureSize(s_texture_depth, 0)), GetLightClusterSlice(viewDepth));
+    uint clusterLightCount = LightClusterCounts[cluster];
+    for (uint i = 0u; i < clusterLightCount; i++) {
+        TGpuLocalLight light = LocalLights[LightClusterIndices[cluster * LIGHT_CLUSTER_MAX_LIGHTS + i]];
+        vec3 L = normalize(light.position_radius.xyz - fragmentPosition_ws);
+        vec3 lightColor = light.color_intensity.rgb * light.color_intensity.a;
+        float attenuation = GetLocalLightAttenuation(light, fragmentPosition_ws);
+        directLighting += lighting_ggx(lightColor, F0, L, V, N, albedo.rgb, metallic, alpha, alpha2, k2, attenuation);
+    }
+
     // IBL
     float NdotV = max(dot(N, V), 0.0);
 
@@ -269,7 +292,7 @@ void main()
     // dpecular ambient - split-sum approximation
     vec3 ambientSpecular = prefilteredColor * (F_ambient * brdfLUT.x + brdfLUT.y);
 
-    float ambientOcclusion = 1.0f;//normal_ao.w;
+    float ambientOcclusion = 1.0f;//ao_roughness_metallic.r;
     vec3 ambient = (ambientDiffuse + ambientSpecular) * ambientOcclusion;
 
     vec3 color = ambient + directLighting + emissive;
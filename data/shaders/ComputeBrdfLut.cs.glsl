@@ -0,0 +1,71 @@
+#version 460 core
+
+#include "Include.Pi.glsl"
+const uint NumSamples = 1024;
+
+// x: NdotV, y: roughness. r: scale, g: bias applied to F0 in the split sum approximation
+layout(binding = 0, rg16f) restrict writeonly uniform image2D s_brdf_lut;
+
+#include "Include.Hammersley.glsl"
+
+// Importance sample the GGX distribution around +Z, returns the half vector in tangent space.
+vec3 SampleGGX(vec2 u, float roughness) {
+    float alpha = roughness * roughness;
+
+    float cosTheta = sqrt((1.0 - u.y) / (1.0 + (alpha * alpha - 1.0) * u.y));
+    float sinTheta = sqrt(1.0 - cosTheta * cosTheta);
+    float phi = TwoPI * u.x;
+
+    return vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+}
+
+// Schlick-GGX with k = alpha / 2, the remapping used for image based lighting.
+float GeometrySchlickGGX(float NdotX, float roughness) {
+    float k = (roughness * roughness) * 0.5;
+    return NdotX / (NdotX * (1.0 - k) + k);
+}
+
+float GeometrySmith(float NdotV, float NdotL, float roughness) {
+    return GeometrySchlickGGX(NdotV, roughness) * GeometrySchlickGGX(NdotL, roughness);
+}
+
+layout(local_size_x = 32, local_size_y = 32, local_size_z = 1) in;
+void main(void)
+{
+    ivec2 outputSize = imageSize(s_brdf_lut);
+    if(gl_GlobalInvocationID.x >= outputSize.x || gl_GlobalInvocationID.y >= outputSize.y)
+    {
+        return;
+    }
+
+    // texel centers, so sampling with (NdotV, roughness) hits the value computed for it
+    vec2 uv = (vec2(gl_GlobalInvocationID.xy) + 0.5) / vec2(outputSize);
+    float NdotV = uv.x;
+    float roughness = uv.y;
+
+    vec3 V = vec3(sqrt(1.0 - NdotV * NdotV), 0.0, NdotV);
+
+    float scale = 0.0;
+    float bias = 0.0;
+    for(uint i = 0; i < NumSamples; ++i)
+    {
+        vec3 H = SampleGGX(Hammersley(i, NumSamples), roughness);
+        vec3 L = 2.0 * dot(V, H) * H - V;
+
+        float NdotL = max(L.z, 0.0);
+        if(NdotL > 0.0)
+        {
+            float NdotH = max(H.z, 0.0);
+            float VdotH = max(dot(V, H), 0.0);
+
+            float G = GeometrySmith(NdotV, NdotL, roughness);
+            float GVisibility = (G * VdotH) / (NdotH * NdotV);
+            float Fc = pow(1.0 - VdotH, 5.0);
+
+            scale += (1.0 - Fc) * GVisibility;
+            bias += Fc * GVisibility;
+        }
+    }
+
+    imageStore(s_brdf_lut, ivec2(gl_GlobalInvocationID.xy), vec4(scale / float(NumSamples), bias / float(NumSamples), 0.0, 1.0));
+}
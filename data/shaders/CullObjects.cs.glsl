@@ -0,0 +1,165 @@
+#version 460 core
+
+#include "Include.ObjectBuffer.glsl"
+
+layout (local_size_x = 64, local_size_y = 1, local_size_z = 1) in;
+
+struct TDrawRecord
+{
+    vec4 LocalBoundingSphere; // xyz = center, w = radius
+    uint InstanceGroupIndex;
+    uint InstanceGroupFirstObject;
+    uint _padding1;
+    uint _padding2;
+};
+
+struct TCullView
+{
+    mat4 ViewProjection;
+    vec4 Planes[6];
+    uvec4 Properties; // IsEnabled, IsCullingEnabled, IsOcclusionCullingEnabled, IsCpuOcclusionCullingEnabled
+};
+
+layout (binding = 4, std430) restrict readonly buffer TDrawRecordsBuffer
+{
+    TDrawRecord DrawRecords[];
+};
+
+layout (binding = 5, std430) restrict readonly buffer TCullViewsBuffer
+{
+    TCullView CullViews[];
+};
+
+layout (binding = 6, std430) restrict writeonly buffer TInstanceIndicesBuffer
+{
+    uint InstanceIndices[];
+};
+
+layout (binding = 7, std430) restrict buffer TInstanceCountsBuffer
+{
+    uint InstanceCounts[];
+};
+
+// one bit per object, cleared when the cpu occlusion buffer hides it
+layout (binding = 8, std430) restrict readonly buffer TObjectVisibilityBuffer
+{
+    uint ObjectVisibility[];
+};
+
+layout (location = 0) uniform uint u_object_count;
+layout (location = 1) uniform uint u_instance_group_count;
+layout (location = 2) uniform uint u_bucket_instance_stride;
+layout (location = 3) uniform uint u_depth_bucket_count;
+layout (location = 4) uniform uint u_first_view_index;
+
+// farthest depth per texel of the depth pre-pass, see BuildHiZ.cs.glsl
+layout (binding = 0) uniform sampler2D s_hiz;
+
+// buckets start at 8, 64, 512... units away from the near plane, drawing them in order is near to far
+uint GetDepthBucket(uint viewIndex, vec3 center)
+{
+    vec4 nearPlane = CullViews[viewIndex].Planes[4];
+    float distanceToNearPlane = max(dot(nearPlane.xyz, center) + nearPlane.w, 1.0);
+    return min(uint(log2(distanceToNearPlane) / 3.0), u_depth_bucket_count - 1);
+}
+
+bool IsSphereInsideView(uint viewIndex, vec3 center, float radius)
+{
+    for (int planeIndex = 0; planeIndex < 6; ++planeIndex)
+    {
+        vec4 plane = CullViews[viewIndex].Planes[planeIndex];
+        if (dot(plane.xyz, center) + plane.w < -radius)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// conservative, the box around the sphere has to lie behind the farthest depth of every Hi-Z texel it covers
+bool IsSphereOccluded(uint viewIndex, vec3 center, float radius)
+{
+    mat4 viewProjection = CullViews[viewIndex].ViewProjection;
+    vec2 minUv = vec2(1.0);
+    vec2 maxUv = vec2(0.0);
+    float nearestDepth = 1.0;
+    for (int cornerIndex = 0; cornerIndex < 8; ++cornerIndex)
+    {
+        vec3 corner = center + radius * vec3(
+            (cornerIndex & 1) != 0 ? 1.0 : -1.0,
+            (cornerIndex & 2) != 0 ? 1.0 : -1.0,
+            (cornerIndex & 4) != 0 ? 1.0 : -1.0);
+        vec4 clipCorner = viewProjection * vec4(corner, 1.0);
+        if (clipCorner.w <= 0.0)
+        {
+            return false;
+        }
+
+        vec3 ndcCorner = clipCorner.xyz / clipCorner.w;
+        minUv = min(minUv, ndcCorner.xy * 0.5 + 0.5);
+        maxUv = max(maxUv, ndcCorner.xy * 0.5 + 0.5);
+        nearestDepth = min(nearestDepth, ndcCorner.z * 0.5 + 0.5);
+    }
+
+    if (nearestDepth <= 0.0)
+    {
+        return false;
+    }
+
+    // pick the level where the rectangle spans at most 2x2 texels
+    ivec2 hizSize = textureSize(s_hiz, 0);
+    ivec2 minTexel = clamp(ivec2(minUv * vec2(hizSize)), ivec2(0), hizSize - 1);
+    ivec2 maxTexel = clamp(ivec2(maxUv * vec2(hizSize)), ivec2(0), hizSize - 1);
+    ivec2 extent = maxTexel - minTexel;
+    int level = min(findMSB(max(extent.x, extent.y)) + 1, textureQueryLevels(s_hiz) - 1);
+
+    ivec2 levelSize = textureSize(s_hiz, level);
+    minTexel = min(minTexel >> level, levelSize - 1);
+    maxTexel = min(maxTexel >> level, levelSize - 1);
+    float farthestDepth = max(
+        max(texelFetch(s_hiz, minTexel, level).r, texelFetch(s_hiz, ivec2(maxTexel.x, minTexel.y), level).r),
+        max(texelFetch(s_hiz, ivec2(minTexel.x, maxTexel.y), level).r, texelFetch(s_hiz, maxTexel, level).r));
+
+    return nearestDepth > farthestDepth;
+}
+
+void main()
+{
+    uint objectIndex = gl_GlobalInvocationID.x;
+    uint viewIndex = u_first_view_index + gl_GlobalInvocationID.y;
+    if (objectIndex >= u_object_count || CullViews[viewIndex].Properties.x == 0)
+    {
+        return;
+    }
+
+    TDrawRecord drawRecord = DrawRecords[objectIndex];
+    mat4 worldMatrix = Objects[objectIndex].WorldMatrix;
+    vec3 center = (worldMatrix * vec4(drawRecord.LocalBoundingSphere.xyz, 1.0)).xyz;
+    if (CullViews[viewIndex].Properties.y != 0)
+    {
+        float maxScaleSquared = max(
+            dot(worldMatrix[0].xyz, worldMatrix[0].xyz),
+            max(dot(worldMatrix[1].xyz, worldMatrix[1].xyz), dot(worldMatrix[2].xyz, worldMatrix[2].xyz)));
+
+        float radius = drawRecord.LocalBoundingSphere.w * sqrt(maxScaleSquared);
+        if (!IsSphereInsideView(viewIndex, center, radius))
+        {
+            return;
+        }
+
+        if (CullViews[viewIndex].Properties.w != 0 && (ObjectVisibility[objectIndex >> 5] & (1u << (objectIndex & 31u))) == 0)
+        {
+            return;
+        }
+
+        if (CullViews[viewIndex].Properties.z != 0 && IsSphereOccluded(viewIndex, center, radius))
+        {
+            return;
+        }
+    }
+
+    // survivors are appended to their instance group's run of object indices for this view and depth bucket
+    uint viewBucketIndex = viewIndex * u_depth_bucket_count + GetDepthBucket(viewIndex, center);
+    uint instanceIndex = atomicAdd(InstanceCounts[viewBucketIndex * u_instance_group_count + drawRecord.InstanceGroupIndex], 1);
+    InstanceIndices[viewBucketIndex * u_bucket_instance_stride + drawRecord.InstanceGroupFirstObject + instanceIndex] = objectIndex;
+}
@@ -1,6 +1,7 @@
 #version 460 core
 
 #include "Include.VertexTypes.glsl"
+#include "Include.InstanceBuffer.glsl"
 
 layout (location = 0) out gl_PerVertex
 {
@@ -25,18 +26,17 @@ layout(binding = 1, std430) restrict readonly buffer TGpuVertexPositionBuffer
     TVertexPosition VertexPositions[];
 };
 
-layout(location = 0) uniform mat4 u_object_world_matrix;
-
 void main()
 {
     TVertexPosition vertex_position = VertexPositions[gl_VertexID];
+    mat4 object_world_matrix = GetInstanceObject().WorldMatrix;
 /*
     gl_Position = u_camera_information.ProjectionMatrix *
                   u_camera_information.ViewMatrix *
-                  u_object_world_matrix *
+                  object_world_matrix *
                   vec4(PackedToVec3(vertex_position.Position), 1.0);
 */
     gl_Position = u_camera_information.CurrentJitteredViewProjectionMatrix *
-                  u_object_world_matrix *
+                  object_world_matrix *
                   vec4(PackedToVec3(vertex_position.Position), 1.0);
 }
@@ -1,9 +1,12 @@
 #version 460 core
 
-//#extension GL_ARB_bindless_texture : enable
+#extension GL_ARB_bindless_texture : require
 #extension GL_NV_gpu_shader5 : enable
 #extension GL_ARB_gpu_shader_int64 : enable
 
+#include "Include.BasicFunctions.glsl"
+#include "Include.VirtualTexture.glsl"
+
 layout(location = 0) in mat3 v_tbn;
 layout(location = 4) in vec3 v_normal;
 layout(location = 5) in vec3 v_tangent;
@@ -12,39 +15,33 @@ layout(location = 7) in vec4 v_current_world_position;
 layout(location = 8) in vec4 v_previous_world_position;
 layout(location = 9) flat in uint v_material_id;
 
+// rgba8 srgb, rg16 snorm octahedral, rg16f ndc delta, r11g11b10f, rgba8
 layout(location = 0) out vec4 o_color;
-layout(location = 1) out vec4 o_normal_ao;
-layout(location = 2) out vec4 o_velocity_roughness_metalness;
-layout(location = 3) out vec4 o_emissive;
+layout(location = 1) out vec2 o_normal;
+layout(location = 2) out vec2 o_velocity;
+layout(location = 3) out vec3 o_emissive;
+layout(location = 4) out vec4 o_ao_roughness_metalness;
 
 //layout(binding = 0) uniform sampler2D u_sampler_shadow;
 //layout(binding = 1) uniform sampler2D u_sampler_grid;
 
-layout(binding = 8) uniform sampler2D u_texture_base_color;
-layout(binding = 9) uniform sampler2D u_texture_normal;
-layout(binding = 10) uniform sampler2D u_texture_arm;
-layout(binding = 11) uniform sampler2D u_texture_emissive;
-
-layout(location = 5) uniform vec4 u_factors;
-layout(location = 6) uniform vec4 u_material_emissive;
-layout(location = 7) uniform uint u_texture_flags;
-
 struct TGpuMaterial
 {
     vec4 base_color;
-    vec4 factors; // normal strength, metalness, roughness, emission strength
+    vec4 factors; // normal strength, roughness, metalness, emission strength
     vec4 emissive_color;
 
     uint64_t base_texture_handle;
     uint64_t normal_texture_handle;
-    uint64_t occlusion_texture_handle;
+    uint64_t arm_texture_handle;
     uint64_t metallic_roughness_texture_handle;
 
     uint64_t emissive_texture_handle;
-    uint64_t _padding1;
+    uint texture_flags;
+    uint virtual_texture; // with texture flag 16
 };
 
-layout (binding = 4, std430) readonly buffer TGpuMaterialBuffer
+layout (binding = 4, std430) restrict readonly buffer TGpuMaterialBuffer
 {
     TGpuMaterial GpuMaterials[];
 };
@@ -56,39 +53,47 @@ vec3 normalMap(mat3 tbn, vec3 N) {
 
 void main()
 {
+    // before any branch, derivatives are undefined in non uniform control flow
+    vec2 uvDx = dFdx(v_uv);
+    vec2 uvDy = dFdy(v_uv);
+
     TGpuMaterial material = GpuMaterials[v_material_id];
 
-    bool hasBaseColorTexture = (u_texture_flags & 1u) != 0u;
-    bool hasNormalTexture = (u_texture_flags & 2u) != 0u;
-    bool hasArmTexture = (u_texture_flags & 4u) != 0u;
-    bool hasEmissiveTexture = (u_texture_flags & 8u) != 0u;
+    bool hasBaseColorTexture = (material.texture_flags & 1u) != 0u;
+    bool hasNormalTexture = (material.texture_flags & 2u) != 0u;
+    bool hasArmTexture = (material.texture_flags & 4u) != 0u;
+    bool hasEmissiveTexture = (material.texture_flags & 8u) != 0u;
+    bool hasVirtualBaseColorTexture = (material.texture_flags & 16u) != 0u;
 
-    vec3 ao_roughness_metalness = vec3(1.0, u_factors.g, u_factors.b);
+    vec3 ao_roughness_metalness = vec3(1.0, material.factors.g, material.factors.b);
     if (hasArmTexture) {
-        ao_roughness_metalness = texture(u_texture_arm, v_uv).rgb;
+        ao_roughness_metalness = texture(sampler2D(material.arm_texture_handle), v_uv).rgb;
     }
 
     o_color = vec4(0.5, 0.5, 0.5, 1.0);
     if (hasBaseColorTexture) {
-        o_color = vec4(texture(u_texture_base_color, v_uv).rgb, 1.0);
+        o_color = vec4(texture(sampler2D(material.base_texture_handle), v_uv).rgb, 1.0);
+    }
+    if (hasVirtualBaseColorTexture) {
+        o_color = vec4(SampleVirtualTexture(material.virtual_texture, v_uv, uvDx, uvDy).rgb, 1.0);
     }
 
-    o_normal_ao = vec4(v_normal, ao_roughness_metalness.r);
+    vec3 normal = normalize(v_normal);
     if (hasNormalTexture) {
-        vec3 sampledNormal = texture(u_texture_normal, v_uv).xyz;
+        vec3 sampledNormal = texture(sampler2D(material.normal_texture_handle), v_uv).xyz;
         sampledNormal.y = 1.0 - sampledNormal.y;
-        vec3 normal = normalize(v_tbn * (sampledNormal * 2.0 - 1.0));
-        o_normal_ao = vec4(normal, ao_roughness_metalness.r);
+        normal = normalize(v_tbn * (sampledNormal * 2.0 - 1.0));
     }
+    o_normal = EncodeOctahedral(normal);
 
     vec2 currentPosition = v_current_world_position.xy / v_current_world_position.w;
     vec2 previousPosition = v_previous_world_position.xy / v_previous_world_position.w;
-    vec2 velocity = (currentPosition - previousPosition) * 0.5 + 0.5; // map [-1,1] ndc to [0,1]
-
-    o_velocity_roughness_metalness = vec4(velocity, ao_roughness_metalness.gb);
+    o_velocity = currentPosition - previousPosition;
 
-    o_emissive = vec4(u_material_emissive.rgb, 1.0);
+    o_emissive = material.emissive_color.rgb;
     if (hasEmissiveTexture) {
-        o_emissive = vec4(texture(u_texture_emissive, v_uv).rgb, 1.0);
+        o_emissive = texture(sampler2D(material.emissive_texture_handle), v_uv).rgb;
     }
+
+    o_ao_roughness_metalness = vec4(ao_roughness_metalness, 1.0);
 }
@@ -1,6 +1,7 @@
 #version 460 core
 
 #include "Include.VertexTypes.glsl"
+#include "Include.InstanceBuffer.glsl"
 
 layout(location = 0) out mat3 v_tbn;
 layout(location = 4) out vec3 v_normal;
@@ -30,13 +31,13 @@ layout(binding = 2, std430) restrict readonly buffer TGpuVertexNormalUvTangentBu
     TPackedVertexNormalTangentUvSign VertexNormalUvTangents[];
 };
 
-layout(location = 0) uniform mat4 u_object_world_matrix;
-layout(location = 4) uniform ivec4 u_object_parameters;
-
 #include "Include.BasicFunctions.glsl"
 
 void main()
 {
+    TObject gpu_object = GetInstanceObject();
+    mat4 object_world_matrix = gpu_object.WorldMatrix;
+
     TVertexPosition vertex_position = VertexPositions[gl_VertexID];
     TPackedVertexNormalTangentUvSign vertex_normal_uv_tangent = VertexNormalUvTangents[gl_VertexID];
 
@@ -45,8 +46,8 @@ void main()
     vec4 decoded_uv_and_tangent_sign = PackedToVec4(vertex_normal_uv_tangent.UvAndTangentSign);
 
     // MikkTSpace already generates orthogonalized tangents in object space
-    v_normal = normalize((u_object_world_matrix * vec4(decoded_normal, 0.0)).xyz);
-    vec3 tangent_ws = normalize((u_object_world_matrix * vec4(decoded_tangent, 0.0)).xyz);
+    v_normal = normalize((object_world_matrix * vec4(decoded_normal, 0.0)).xyz);
+    vec3 tangent_ws = normalize((object_world_matrix * vec4(decoded_tangent, 0.0)).xyz);
 
     // re-orthogonalize in case world matrix has non-uniform scale
     vec3 tangent_orthogonal = tangent_ws - dot(tangent_ws, v_normal) * v_normal;
@@ -58,9 +59,9 @@ void main()
 
     v_tbn = mat3(v_tangent, bitangent, v_normal);
     v_uv = decoded_uv_and_tangent_sign.xy;
-    v_material_id = u_object_parameters.x;
+    v_material_id = gpu_object.InstanceParameter.x;
 
-    vec4 worldPosition = u_object_world_matrix * vec4(PackedToVec3(vertex_position.Position), 1.0);
+    vec4 worldPosition = object_world_matrix * vec4(PackedToVec3(vertex_position.Position), 1.0);
     v_current_world_position = u_camera_information.CurrentJitteredViewProjectionMatrix * worldPosition;
     v_previous_world_position = u_camera_information.PreviousJitteredViewProjectionMatrix * worldPosition;
 
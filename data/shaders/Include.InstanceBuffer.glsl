@@ -0,0 +1,17 @@
+#ifndef INSTANCE_BUFFER_INCLUDE_GLSL
+#define INSTANCE_BUFFER_INCLUDE_GLSL
+
+#include "Include.ObjectBuffer.glsl"
+
+// written by CullObjects.cs, every instanced draw points its base instance at its own run of object indices
+layout (binding = 5, std430) restrict readonly buffer TInstanceIndicesBuffer
+{
+    uint InstanceIndices[];
+};
+
+TObject GetInstanceObject()
+{
+    return Objects[InstanceIndices[gl_BaseInstance + gl_InstanceID]];
+}
+
+#endif // INSTANCE_BUFFER_INCLUDE_GLSL
@@ -0,0 +1,73 @@
+#ifndef LIGHT_CLUSTERS_INCLUDE_GLSL
+#define LIGHT_CLUSTERS_INCLUDE_GLSL
+
+// constants mirror Renderer.cpp
+#define LIGHT_CLUSTER_COUNT_X 16u
+#define LIGHT_CLUSTER_COUNT_Y 9u
+#define LIGHT_CLUSTER_COUNT_Z 24u
+#define LIGHT_CLUSTER_COUNT (LIGHT_CLUSTER_COUNT_X * LIGHT_CLUSTER_COUNT_Y * LIGHT_CLUSTER_COUNT_Z)
+#define LIGHT_CLUSTER_MAX_LIGHTS 128u
+
+// depth slices are exponential between these view distances, the first and last slice extend to the scene
+#define LIGHT_CLUSTER_NEAR 0.1
+#define LIGHT_CLUSTER_FAR 1000.0
+
+struct TGpuLocalLight
+{
+    vec4 position_radius;
+    vec4 color_intensity;
+    vec4 direction_type; // w = 0 point, 1 spot
+    vec4 cos_cone_angles; // x = inner, y = outer
+};
+
+layout (binding = 0, std430) restrict readonly buffer TLocalLightsBuffer
+{
+    TGpuLocalLight LocalLights[];
+};
+
+uint GetLightClusterSlice(float viewDepth)
+{
+    float slice = log(max(viewDepth, LIGHT_CLUSTER_NEAR) / LIGHT_CLUSTER_NEAR) * float(LIGHT_CLUSTER_COUNT_Z) / log(LIGHT_CLUSTER_FAR / LIGHT_CLUSTER_NEAR);
+    return min(uint(slice), LIGHT_CLUSTER_COUNT_Z - 1u);
+}
+
+float GetLightClusterSliceDepth(uint slice)
+{
+    return LIGHT_CLUSTER_NEAR * pow(LIGHT_CLUSTER_FAR / LIGHT_CLUSTER_NEAR, float(slice) / float(LIGHT_CLUSTER_COUNT_Z));
+}
+
+// integer pixel to tile mapping, tile = pixel * count / size rounded down
+uvec2 GetLightClusterTile(ivec2 pixel, ivec2 screenSize)
+{
+    return uvec2(pixel * ivec2(LIGHT_CLUSTER_COUNT_X, LIGHT_CLUSTER_COUNT_Y) / screenSize);
+}
+
+// first pixel of a tile, the inverse of GetLightClusterTile so both agree on every pixel
+ivec2 GetLightClusterTileFirstPixel(uvec2 tile, ivec2 screenSize)
+{
+    ivec2 clusterCount = ivec2(LIGHT_CLUSTER_COUNT_X, LIGHT_CLUSTER_COUNT_Y);
+    return (ivec2(tile) * screenSize + clusterCount - 1) / clusterCount;
+}
+
+uint GetLightClusterIndex(uvec2 tile, uint slice)
+{
+    return (slice * LIGHT_CLUSTER_COUNT_Y + tile.y) * LIGHT_CLUSTER_COUNT_X + tile.x;
+}
+
+// smooth falloff to zero at the light's radius
+float GetLocalLightAttenuation(TGpuLocalLight light, vec3 position)
+{
+    vec3 toLight = light.position_radius.xyz - position;
+    float distanceSquared = dot(toLight, toLight);
+    float falloff = clamp(1.0 - pow(distanceSquared / (light.position_radius.w * light.position_radius.w), 2.0), 0.0, 1.0);
+    float attenuation = falloff * falloff / (distanceSquared + 1.0);
+
+    if (light.direction_type.w > 0.5) {
+        float cosAngle = dot(normalize(-toLight), light.direction_type.xyz);
+        attenuation *= smoothstep(light.cos_cone_angles.y, light.cos_cone_angles.x, cosAngle);
+    }
+
+    return attenuation;
+}
+
+#endif // LIGHT_CLUSTERS_INCLUDE_GLSL
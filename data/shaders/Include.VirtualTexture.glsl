@@ -0,0 +1,97 @@
+#ifndef VIRTUAL_TEXTURE_INCLUDE_GLSL
+#define VIRTUAL_TEXTURE_INCLUDE_GLSL
+
+// needs GL_ARB_bindless_texture and GL_ARB_gpu_shader_int64, constants mirror VirtualTexture.hpp
+
+#define VIRTUAL_TEXTURE_PAGE_SIZE 128u
+#define VIRTUAL_TEXTURE_PAGE_BORDER 4u
+#define VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER (VIRTUAL_TEXTURE_PAGE_SIZE + 2u * VIRTUAL_TEXTURE_PAGE_BORDER)
+#define VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE 24u
+
+struct TGpuVirtualTexture
+{
+    uint64_t physical_pages;
+    uint width;
+    uint height;
+    uint mip_count;
+    uint first_page;
+    uint _padding1;
+    uint _padding2;
+};
+
+layout (binding = 6, std430) restrict readonly buffer TGpuVirtualTextureBuffer
+{
+    TGpuVirtualTexture VirtualTextures[];
+};
+
+// x, y of the physical page in bits 0 - 15, mip of the page actually resident in bits 16 - 23
+layout (binding = 7, std430) restrict readonly buffer TVirtualTexturePageTableBuffer
+{
+    uint VirtualTexturePageTable[];
+};
+
+uvec2 GetVirtualTextureMipExtent(TGpuVirtualTexture virtualTexture, uint mip)
+{
+    return max(uvec2(virtualTexture.width, virtualTexture.height) >> mip, uvec2(1u));
+}
+
+uvec2 GetVirtualTexturePageCount(TGpuVirtualTexture virtualTexture, uint mip)
+{
+    return (GetVirtualTextureMipExtent(virtualTexture, mip) + VIRTUAL_TEXTURE_PAGE_SIZE - 1u) / VIRTUAL_TEXTURE_PAGE_SIZE;
+}
+
+// relative to first_page, pages are laid out mip by mip and row by row
+uint GetVirtualTexturePageIndex(TGpuVirtualTexture virtualTexture, uint mip, uvec2 page)
+{
+    uint pageIndex = 0u;
+    for (uint finerMip = 0u; finerMip < mip; finerMip++) {
+        uvec2 pageCount = GetVirtualTexturePageCount(virtualTexture, finerMip);
+        pageIndex += pageCount.x * pageCount.y;
+    }
+
+    return pageIndex + page.y * GetVirtualTexturePageCount(virtualTexture, mip).x + page.x;
+}
+
+// wraps horizontally and clamps vertically like the page borders do
+vec2 GetVirtualTextureUv(vec2 uv)
+{
+    return vec2(fract(uv.x), clamp(uv.y, 0.0, 1.0));
+}
+
+uint GetVirtualTextureMip(TGpuVirtualTexture virtualTexture, vec2 uvDx, vec2 uvDy, float lodBias)
+{
+    vec2 size = vec2(virtualTexture.width, virtualTexture.height);
+    float texelsPerPixel = max(length(uvDx * size), length(uvDy * size));
+    float lod = log2(max(texelsPerPixel, 1e-6)) + lodBias;
+    return uint(clamp(floor(lod), 0.0, float(virtualTexture.mip_count - 1u)));
+}
+
+uvec2 GetVirtualTexturePage(TGpuVirtualTexture virtualTexture, uint mip, vec2 uv)
+{
+    vec2 texel = GetVirtualTextureUv(uv) * vec2(GetVirtualTextureMipExtent(virtualTexture, mip));
+    return min(uvec2(texel) / VIRTUAL_TEXTURE_PAGE_SIZE, GetVirtualTexturePageCount(virtualTexture, mip) - 1u);
+}
+
+// bilinear within the finest resident page covering uv, uvDx and uvDy are the derivatives of the unwrapped
+// uv taken before any branch, the same way VirtualTextureFeedback.fs.glsl picks the mip it asks for
+vec4 SampleVirtualTexture(uint virtualTextureIndex, vec2 uv, vec2 uvDx, vec2 uvDy)
+{
+    TGpuVirtualTexture virtualTexture = VirtualTextures[virtualTextureIndex];
+
+    uint mip = GetVirtualTextureMip(virtualTexture, uvDx, uvDy, 0.0);
+    uvec2 page = GetVirtualTexturePage(virtualTexture, mip, uv);
+    uint entry = VirtualTexturePageTable[virtualTexture.first_page + GetVirtualTexturePageIndex(virtualTexture, mip, page)];
+
+    uint residentMip = entry >> 16u;
+    uvec2 physicalPage = uvec2(entry & 0xFFu, (entry >> 8u) & 0xFFu);
+
+    vec2 mipExtent = vec2(GetVirtualTextureMipExtent(virtualTexture, residentMip));
+    vec2 texel = GetVirtualTextureUv(uv) * mipExtent;
+    vec2 texelInPage = texel - vec2(GetVirtualTexturePage(virtualTexture, residentMip, uv) * VIRTUAL_TEXTURE_PAGE_SIZE);
+
+    vec2 physicalTexel = vec2(physicalPage * VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER + VIRTUAL_TEXTURE_PAGE_BORDER) + texelInPage;
+    float physicalSize = float(VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE * VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER);
+    return textureLod(sampler2D(virtualTexture.physical_pages), physicalTexel / physicalSize, 0.0);
+}
+
+#endif // VIRTUAL_TEXTURE_INCLUDE_GLSL
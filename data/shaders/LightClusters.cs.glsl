@@ -0,0 +1,129 @@
+#version 460 core
+
+#include "Include.LightClusters.glsl"
+
+layout (local_size_x = 16, local_size_y = 16, local_size_z = 1) in;
+
+layout (binding = 0) uniform sampler2D s_depth;
+
+layout (binding = 1, std430) restrict writeonly buffer TLightClustersBuffer
+{
+    uint LightClusterCounts[LIGHT_CLUSTER_COUNT];
+    uint LightClusterIndices[]; // LIGHT_CLUSTER_MAX_LIGHTS per cluster
+};
+
+layout (location = 0) uniform mat4 u_inverse_projection;
+layout (location = 4) uniform mat4 u_view;
+layout (location = 8) uniform uint u_local_light_count;
+
+#define THREAD_COUNT (16u * 16u)
+
+shared uint s_min_depth;
+shared uint s_max_depth;
+shared uint s_light_counts[LIGHT_CLUSTER_COUNT_Z];
+shared uint s_light_indices[LIGHT_CLUSTER_COUNT_Z * LIGHT_CLUSTER_MAX_LIGHTS];
+
+float GetViewDepth(vec2 ndc, float depth)
+{
+    vec4 position = u_inverse_projection * vec4(ndc, depth * 2.0 - 1.0, 1.0);
+    return -position.z / position.w;
+}
+
+// the point at viewDepth along the ray through ndc
+vec3 GetViewPosition(vec2 ndc, float viewDepth)
+{
+    vec4 position = u_inverse_projection * vec4(ndc, 0.0, 1.0);
+    return position.xyz * (viewDepth / -position.z);
+}
+
+bool SphereIntersectsAabb(vec3 center, float radius, vec3 aabbMin, vec3 aabbMax)
+{
+    vec3 closest = clamp(center, aabbMin, aabbMax);
+    vec3 delta = center - closest;
+    return dot(delta, delta) <= radius * radius;
+}
+
+void main()
+{
+    uvec2 tile = gl_WorkGroupID.xy;
+    uint threadIndex = gl_LocalInvocationIndex;
+
+    if (threadIndex == 0u) {
+        s_min_depth = floatBitsToUint(1.0);
+        s_max_depth = 0u;
+    }
+    if (threadIndex < LIGHT_CLUSTER_COUNT_Z) {
+        s_light_counts[threadIndex] = 0u;
+    }
+    barrier();
+
+    // depth range of the tile, the sky does not need lights
+    ivec2 screenSize = textureSize(s_depth, 0);
+    ivec2 firstPixel = GetLightClusterTileFirstPixel(tile, screenSize);
+    ivec2 endPixel = GetLightClusterTileFirstPixel(tile + 1u, screenSize);
+    for (int y = firstPixel.y + int(gl_LocalInvocationID.y); y < endPixel.y; y += 16) {
+        for (int x = firstPixel.x + int(gl_LocalInvocationID.x); x < endPixel.x; x += 16) {
+            float depth = texelFetch(s_depth, ivec2(x, y), 0).r;
+            if (depth < 1.0) {
+                atomicMin(s_min_depth, floatBitsToUint(depth));
+                atomicMax(s_max_depth, floatBitsToUint(depth));
+            }
+        }
+    }
+    barrier();
+
+    if (s_min_depth <= s_max_depth) {
+        vec2 ndcMin = vec2(firstPixel) / vec2(screenSize) * 2.0 - 1.0;
+        vec2 ndcMax = vec2(endPixel) / vec2(screenSize) * 2.0 - 1.0;
+        vec2 ndcCenter = (ndcMin + ndcMax) * 0.5;
+        float minViewDepth = GetViewDepth(ndcCenter, uintBitsToFloat(s_min_depth));
+        float maxViewDepth = GetViewDepth(ndcCenter, uintBitsToFloat(s_max_depth));
+
+        for (uint lightIndex = threadIndex; lightIndex < u_local_light_count; lightIndex += THREAD_COUNT) {
+            TGpuLocalLight light = LocalLights[lightIndex];
+            vec3 center = (u_view * vec4(light.position_radius.xyz, 1.0)).xyz;
+            float radius = light.position_radius.w;
+
+            float lightNear = max(-center.z - radius, minViewDepth);
+            float lightFar = min(-center.z + radius, maxViewDepth);
+            if (lightNear > lightFar) {
+                continue;
+            }
+
+            // spot lights are bounded by their sphere as well
+            uint lastSlice = GetLightClusterSlice(lightFar);
+            for (uint slice = GetLightClusterSlice(lightNear); slice <= lastSlice; slice++) {
+                float sliceNear = slice == 0u ? minViewDepth : max(GetLightClusterSliceDepth(slice), minViewDepth);
+                float sliceFar = slice == LIGHT_CLUSTER_COUNT_Z - 1u ? maxViewDepth : min(GetLightClusterSliceDepth(slice + 1u), maxViewDepth);
+
+                vec3 aabbMin = vec3(1e30);
+                vec3 aabbMax = vec3(-1e30);
+                for (uint corner = 0u; corner < 8u; corner++) {
+                    vec2 ndc = vec2((corner & 1u) != 0u ? ndcMax.x : ndcMin.x, (corner & 2u) != 0u ? ndcMax.y : ndcMin.y);
+                    vec3 position = GetViewPosition(ndc, (corner & 4u) != 0u ? sliceFar : sliceNear);
+                    aabbMin = min(aabbMin, position);
+                    aabbMax = max(aabbMax, position);
+                }
+
+                if (SphereIntersectsAabb(center, radius, aabbMin, aabbMax)) {
+                    uint slot = atomicAdd(s_light_counts[slice], 1u);
+                    if (slot < LIGHT_CLUSTER_MAX_LIGHTS) {
+                        s_light_indices[slice * LIGHT_CLUSTER_MAX_LIGHTS + slot] = lightIndex;
+                    }
+                }
+            }
+        }
+    }
+    barrier();
+
+    if (threadIndex < LIGHT_CLUSTER_COUNT_Z) {
+        LightClusterCounts[GetLightClusterIndex(tile, threadIndex)] = min(s_light_counts[threadIndex], LIGHT_CLUSTER_MAX_LIGHTS);
+    }
+    for (uint entry = threadIndex; entry < LIGHT_CLUSTER_COUNT_Z * LIGHT_CLUSTER_MAX_LIGHTS; entry += THREAD_COUNT) {
+        uint slice = entry / LIGHT_CLUSTER_MAX_LIGHTS;
+        uint slot = entry % LIGHT_CLUSTER_MAX_LIGHTS;
+        if (slot < s_light_counts[slice]) {
+            LightClusterIndices[GetLightClusterIndex(tile, slice) * LIGHT_CLUSTER_MAX_LIGHTS + slot] = s_light_indices[entry];
+        }
+    }
+}
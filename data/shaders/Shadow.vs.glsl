@@ -1,9 +1,9 @@
 #version 460 core
 
 #include "Include.VertexTypes.glsl"
+#include "Include.InstanceBuffer.glsl"
 
 layout (location = 0) uniform int u_global_light_index;
-layout (location = 1) uniform mat4 u_world_matrix;
 
 layout (location = 0) out gl_PerVertex
 {
@@ -30,6 +30,6 @@ void main()
 {
     TVertexPosition vertex_position = VertexPositions[gl_VertexID];
     gl_Position = u_global_lights.Lights[u_global_light_index].ShadowViewProjectionMatrix *
-                  u_world_matrix *
+                  GetInstanceObject().WorldMatrix *
                   vec4(PackedToVec3(vertex_position.Position), 1.0);
 }
@@ -32,7 +32,7 @@ vec3 ClampHistory(vec2 uv, vec3 value) {
 
 void main() {
     ivec2 uv = ivec2(gl_FragCoord.xy);
-    vec2 velocity = texelFetch(s_velocity, uv, 0).xy * 2.0 - 1.0; // map back to [-1, 1]
+    vec2 velocity = texelFetch(s_velocity, uv, 0).xy;
     ivec2 previousUv = ivec2(uv + velocity);
 
     vec4 current = texelFetch(s_current_color, uv, 0);
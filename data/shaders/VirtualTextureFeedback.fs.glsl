@@ -0,0 +1,59 @@
+#version 460 core
+
+#extension GL_ARB_bindless_texture : require
+#extension GL_NV_gpu_shader5 : enable
+#extension GL_ARB_gpu_shader_int64 : enable
+
+#include "Include.VirtualTexture.glsl"
+
+layout(early_fragment_tests) in;
+
+layout(location = 6) in vec2 v_uv;
+layout(location = 9) flat in uint v_material_id;
+
+// this pass runs at a fraction of the resolution, the bias brings the mip back to what the full resolution pass picks
+layout (location = 0) uniform float u_lod_bias;
+
+struct TGpuMaterial
+{
+    vec4 base_color;
+    vec4 factors; // normal strength, roughness, metalness, emission strength
+    vec4 emissive_color;
+
+    uint64_t base_texture_handle;
+    uint64_t normal_texture_handle;
+    uint64_t arm_texture_handle;
+    uint64_t metallic_roughness_texture_handle;
+
+    uint64_t emissive_texture_handle;
+    uint texture_flags;
+    uint virtual_texture;
+};
+
+layout (binding = 4, std430) restrict readonly buffer TGpuMaterialBuffer
+{
+    TGpuMaterial GpuMaterials[];
+};
+
+// one flag per page, indexed like the page table
+layout (binding = 8, std430) restrict writeonly buffer TVirtualTextureFeedbackBuffer
+{
+    uint VirtualTextureFeedback[];
+};
+
+void main()
+{
+    // before any branch, derivatives are undefined in non uniform control flow
+    vec2 uvDx = dFdx(v_uv);
+    vec2 uvDy = dFdy(v_uv);
+
+    TGpuMaterial material = GpuMaterials[v_material_id];
+    if ((material.texture_flags & 16u) == 0u) {
+        return;
+    }
+
+    TGpuVirtualTexture virtualTexture = VirtualTextures[material.virtual_texture];
+    uint mip = GetVirtualTextureMip(virtualTexture, uvDx, uvDy, u_lod_bias);
+    uvec2 page = GetVirtualTexturePage(virtualTexture, mip, v_uv);
+    VirtualTextureFeedback[virtualTexture.first_page + GetVirtualTexturePageIndex(virtualTexture, mip, page)] = 1u;
+}
@@ -10,5 +10,5 @@ CPMAddPackage(
 )
 if(glad_ADDED)
     add_subdirectory("${glad_SOURCE_DIR}/cmake" glad_cmake SYSTEM)
-    glad_add_library(glad STATIC REPRODUCIBLE EXCLUDE_FROM_ALL LOADER API gl:core=4.6 EXTENSIONS GL_ARB_bindless_texture GL_EXT_texture_compression_s3tc)
+    glad_add_library(glad STATIC REPRODUCIBLE EXCLUDE_FROM_ALL LOADER API gl:core=4.6 EXTENSIONS GL_ARB_bindless_texture GL_ARB_parallel_shader_compile GL_EXT_texture_compression_s3tc GL_KHR_parallel_shader_compile)
 endif()
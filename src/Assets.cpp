@@ -1,6 +1,7 @@
 #include "Assets.hpp"
 #include "Io.hpp"
 #include "Images.hpp"
+#include "Cache.hpp"
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -18,8 +19,11 @@
 #include <mikktspace.h>
 
 #include <algorithm>
+#include <cstring>
 #include <format>
+#include <limits>
 #include <ranges>
+#include <span>
 #include <unordered_map>
 #include <utility>
 
@@ -39,7 +43,17 @@ std::unordered_map<std::string, TAssetMaterial> g_assetMaterials = {};
 std::unordered_map<std::string, TAssetPrimitive> g_assetPrimitives = {};
 std::unordered_map<std::string, TAssetMesh> g_assetMeshes = {};
 
-auto CalculateTangents(TAssetPrimitive& assetPrimitive) -> void;
+constexpr auto g_defaultTangent = glm::vec4{1.0f, 0.0f, 0.0f, 1.0f};
+
+enum class TTangentGenerationMethod {
+    MikkTSpace,
+    Welded
+};
+
+auto CalculateBounds(TAssetPrimitive& assetPrimitive) -> void;
+auto GenerateTangents(
+    std::span<TAssetPrimitive* const> assetPrimitives,
+    TTangentGenerationMethod tangentGenerationMethod) -> void;
 
 auto GetSafeResourceName(
     const char* const baseName,
@@ -399,6 +413,16 @@ auto LoadMeshes(
     assetModel.Meshes.resize(fgAsset.meshes.size());
     auto meshes = std::vector<TAssetMesh>(fgAsset.meshes.size(), TAssetMesh());
 
+    auto hasNormalTexture = [](const std::optional<std::string>& materialName) -> bool {
+        if (!materialName.has_value()) {
+            return false;
+        }
+        const auto materialIterator = g_assetMaterials.find(*materialName);
+        return materialIterator != g_assetMaterials.end() && materialIterator->second.NormalTextureChannel.has_value();
+    };
+
+    std::vector<TAssetPrimitive*> primitivesWithoutTangents;
+
     static auto globalPrimitiveIndex = 0;
     for (auto meshIndex = 0; meshIndex < fgAsset.meshes.size(); ++meshIndex) {
         const auto& fgMesh = fgAsset.meshes[meshIndex];
@@ -427,6 +451,20 @@ auto LoadMeshes(
             auto& positions = fgAsset.accessors[fgPrimitive.findAttribute("POSITION")->accessorIndex];
             assetPrimitive.Positions.resize(positions.count);
             fastgltf::copyFromAccessor<glm::vec3>(fgAsset, positions, assetPrimitive.Positions.data());
+
+            // POSITION accessors are required to carry min/max, only trust them for unquantized data
+            const auto hasPositionBounds = positions.componentType == fastgltf::ComponentType::Float &&
+                                           positions.min.has_value() && positions.min->size() == 3 &&
+                                           positions.max.has_value() && positions.max->size() == 3;
+            if (hasPositionBounds) {
+                assetPrimitive.BoundingBox = TBoundingBox{
+                    .Min = glm::vec3{positions.min->get<double>(0), positions.min->get<double>(1), positions.min->get<double>(2)},
+                    .Max = glm::vec3{positions.max->get<double>(0), positions.max->get<double>(1), positions.max->get<double>(2)},
+                };
+                assetPrimitive.BoundingSphere = CalculateBoundingSphere(assetPrimitive.Positions, assetPrimitive.BoundingBox.GetCenter());
+            } else {
+                CalculateBounds(assetPrimitive);
+            }
             if (auto* normalsAttribute = fgPrimitive.findAttribute("NORMAL"); normalsAttribute != fgPrimitive.attributes.end()) {
                 auto& normals = fgAsset.accessors[normalsAttribute->accessorIndex];
                 assetPrimitive.Normals.resize(normals.count);
@@ -451,12 +489,21 @@ auto LoadMeshes(
                 fastgltf::copyFromAccessor<glm::vec4>(fgAsset, tangents, assetPrimitive.Tangents.data());
             } else  {
                 assetPrimitive.Tangents.resize(assetPrimitive.Positions.size());
-                std::fill_n(assetPrimitive.Tangents.begin(), assetPrimitive.Positions.size(), glm::vec4{1.0f});
+                std::fill_n(assetPrimitive.Tangents.begin(), assetPrimitive.Positions.size(), g_defaultTangent);
 
-                CalculateTangents(assetPrimitive);
+                // tangents are only read when sampling a normal map
+                if (hasNormalTexture(assetPrimitive.MaterialName)) {
+                    primitivesWithoutTangents.push_back(&assetPrimitive);
+                }
             }
+        }
+    }
+
+    GenerateTangents(primitivesWithoutTangents, TTangentGenerationMethod::MikkTSpace);
 
-            g_assetPrimitives[assetPrimitiveName] = assetPrimitive;
+    for (const auto& mesh : meshes) {
+        for (const auto& assetPrimitive : mesh.Primitives) {
+            g_assetPrimitives[assetPrimitive.Name] = assetPrimitive;
         }
     }
 
@@ -662,6 +709,12 @@ auto AddImage(
     g_assetImages[imageName] = std::move(assetImage);
 }
 
+auto CalculateBounds(TAssetPrimitive& assetPrimitive) -> void {
+
+    assetPrimitive.BoundingBox = CalculateBoundingBox(assetPrimitive.Positions);
+    assetPrimitive.BoundingSphere = CalculateBoundingSphere(assetPrimitive.Positions, assetPrimitive.BoundingBox.GetCenter());
+}
+
 auto CalculateTangents(TAssetPrimitive& assetPrimitive) -> void {
 
     auto getNumFaces = [](const SMikkTSpaceContext* context) -> int32_t {
@@ -749,64 +802,310 @@ auto CalculateTangents(TAssetPrimitive& assetPrimitive) -> void {
     genTangSpaceDefault(&context);
 }
 
-auto CreateUvSphereMeshData(
+// accumulates per triangle tangents directly onto the shared vertices of the index buffer,
+// cheaper than MikkTSpace but only matches it on meshes which are already welded
+auto CalculateTangentsWelded(TAssetPrimitive& assetPrimitive) -> void {
+
+    const auto vertexCount = assetPrimitive.Positions.size();
+    std::vector<glm::vec3> tangents(vertexCount, glm::vec3{0.0f});
+    std::vector<glm::vec3> bitangents(vertexCount, glm::vec3{0.0f});
+
+    for (std::size_t triangle = 0; triangle + 2 < assetPrimitive.Indices.size(); triangle += 3) {
+        const auto i0 = assetPrimitive.Indices[triangle + 0];
+        const auto i1 = assetPrimitive.Indices[triangle + 1];
+        const auto i2 = assetPrimitive.Indices[triangle + 2];
+
+        const auto edge1 = assetPrimitive.Positions[i1] - assetPrimitive.Positions[i0];
+        const auto edge2 = assetPrimitive.Positions[i2] - assetPrimitive.Positions[i0];
+        const auto deltaUv1 = assetPrimitive.Uvs[i1] - assetPrimitive.Uvs[i0];
+        const auto deltaUv2 = assetPrimitive.Uvs[i2] - assetPrimitive.Uvs[i0];
+
+        const auto determinant = deltaUv1.x * deltaUv2.y - deltaUv2.x * deltaUv1.y;
+        if (glm::abs(determinant) < 1e-12f) {
+            continue;
+        }
+
+        // left unnormalized so larger triangles weigh more
+        const auto inverseDeterminant = 1.0f / determinant;
+        const auto tangent = (edge1 * deltaUv2.y - edge2 * deltaUv1.y) * inverseDeterminant;
+        const auto bitangent = (edge2 * deltaUv1.x - edge1 * deltaUv2.x) * inverseDeterminant;
+
+        for (const auto index : {i0, i1, i2}) {
+            tangents[index] += tangent;
+            bitangents[index] += bitangent;
+        }
+    }
+
+    for (std::size_t vertex = 0; vertex < vertexCount; ++vertex) {
+        const auto& normal = assetPrimitive.Normals[vertex];
+
+        auto tangent = tangents[vertex] - normal * glm::dot(normal, tangents[vertex]);
+        if (glm::dot(tangent, tangent) < 1e-12f) {
+            tangent = glm::cross(normal, glm::abs(normal.x) < 0.9f ? glm::vec3{1.0f, 0.0f, 0.0f} : glm::vec3{0.0f, 1.0f, 0.0f});
+        }
+        tangent = glm::normalize(tangent);
+
+        const auto sign = glm::dot(glm::cross(normal, tangent), bitangents[vertex]) < 0.0f ? -1.0f : 1.0f;
+        assetPrimitive.Tangents[vertex] = glm::vec4(tangent, sign);
+    }
+}
+
+// bump when cached tangents or the way their keys are made change
+constexpr auto TANGENTS_CACHE_VERSION = 2u;
+
+auto HashPrimitiveGeometry(
+    const TAssetPrimitive& assetPrimitive,
+    const TTangentGenerationMethod tangentGenerationMethod) -> uint64_t {
+
+    const auto seed = static_cast<uint64_t>(TANGENTS_CACHE_VERSION) << 32 | static_cast<uint64_t>(tangentGenerationMethod);
+    auto hash = Cache::HashBytes(std::as_bytes(std::span(&seed, 1)));
+    hash = Cache::HashBytes(std::as_bytes(std::span(assetPrimitive.Positions)), hash);
+    hash = Cache::HashBytes(std::as_bytes(std::span(assetPrimitive.Normals)), hash);
+    hash = Cache::HashBytes(std::as_bytes(std::span(assetPrimitive.Uvs)), hash);
+    return Cache::HashBytes(std::as_bytes(std::span(assetPrimitive.Indices)), hash);
+}
+
+auto GenerateTangents(
+    const std::span<TAssetPrimitive* const> assetPrimitives,
+    const TTangentGenerationMethod tangentGenerationMethod) -> void {
+
+    PROFILER_ZONESCOPEDN("GenerateTangents");
+
+    std::for_each(poolstl::execution::par, assetPrimitives.begin(), assetPrimitives.end(), [&](TAssetPrimitive* assetPrimitive) {
+
+        PROFILER_ZONESCOPEDN("GenerateTangents - Primitive");
+
+        auto& tangents = assetPrimitive->Tangents;
+        tangents.resize(assetPrimitive->Positions.size(), g_defaultTangent);
+
+        const auto cacheKey = HashPrimitiveGeometry(*assetPrimitive, tangentGenerationMethod);
+        if (const auto cachedTangents = Cache::Load("tangents", cacheKey);
+            cachedTangents.has_value() && cachedTangents->size() == tangents.size() * sizeof(glm::vec4)) {
+
+            std::memcpy(tangents.data(), cachedTangents->data(), cachedTangents->size());
+            return;
+        }
+
+        if (tangentGenerationMethod == TTangentGenerationMethod::Welded) {
+            CalculateTangentsWelded(*assetPrimitive);
+        } else {
+            CalculateTangents(*assetPrimitive);
+        }
+
+        Cache::Store("tangents", cacheKey, std::as_bytes(std::span(tangents)));
+    });
+}
+
+auto ResizePrimitive(
+    TAssetPrimitive& assetPrimitive,
+    const std::size_t vertexCount,
+    const std::size_t indexCount) -> void {
+
+    assetPrimitive.Positions.resize(vertexCount);
+    assetPrimitive.Normals.resize(vertexCount);
+    assetPrimitive.Uvs.resize(vertexCount);
+    assetPrimitive.Tangents.resize(vertexCount);
+    assetPrimitive.Indices.resize(indexCount);
+}
+
+auto GetGridVertexCount(
+    const uint32_t segmentsU,
+    const uint32_t segmentsV) -> std::size_t {
+
+    return static_cast<std::size_t>(segmentsU + 1) * static_cast<std::size_t>(segmentsV + 1);
+}
+
+auto GetGridIndexCount(
+    const uint32_t segmentsU,
+    const uint32_t segmentsV) -> std::size_t {
+
+    return static_cast<std::size_t>(segmentsU) * static_cast<std::size_t>(segmentsV) * 6;
+}
+
+// writes a grid spanning origin + s * axisU + t * axisV into already sized storage,
+// the grid faces towards cross(axisU, axisV)
+auto WriteGrid(
+    TAssetPrimitive& assetPrimitive,
+    const std::size_t vertexOffset,
+    const std::size_t indexOffset,
+    const glm::vec3& origin,
+    const glm::vec3& axisU,
+    const glm::vec3& axisV,
+    const uint32_t segmentsU,
+    const uint32_t segmentsV) -> void {
+
+    const auto normal = glm::normalize(glm::cross(axisU, axisV));
+
+    auto vertex = vertexOffset;
+    for (auto v = 0u; v <= segmentsV; ++v) {
+        const auto t = static_cast<float>(v) / static_cast<float>(segmentsV);
+        for (auto u = 0u; u <= segmentsU; ++u) {
+            const auto s = static_cast<float>(u) / static_cast<float>(segmentsU);
+
+            assetPrimitive.Positions[vertex] = origin + s * axisU + t * axisV;
+            assetPrimitive.Normals[vertex] = normal;
+            assetPrimitive.Uvs[vertex] = glm::vec2{s, 1.0f - t};
+            assetPrimitive.Tangents[vertex] = g_defaultTangent;
+            vertex++;
+        }
+    }
+
+    const auto stride = segmentsU + 1;
+    auto index = indexOffset;
+    for (auto v = 0u; v < segmentsV; ++v) {
+        for (auto u = 0u; u < segmentsU; ++u) {
+            const auto i00 = static_cast<uint32_t>(vertexOffset) + v * stride + u;
+            const auto i10 = i00 + 1;
+            const auto i01 = i00 + stride;
+            const auto i11 = i01 + 1;
+
+            assetPrimitive.Indices[index + 0] = i00;
+            assetPrimitive.Indices[index + 1] = i10;
+            assetPrimitive.Indices[index + 2] = i11;
+
+            assetPrimitive.Indices[index + 3] = i00;
+            assetPrimitive.Indices[index + 4] = i11;
+            assetPrimitive.Indices[index + 5] = i01;
+
+            index += 6;
+        }
+    }
+}
+
+auto CreateBoxPrimitive(
+    const std::string& name,
+    const glm::vec3& size,
+    const glm::uvec3& segments) -> TAssetPrimitive {
+
+    PROFILER_ZONESCOPEDN("CreateBoxPrimitive");
+
+    const auto segmentsX = glm::max(segments.x, 1u);
+    const auto segmentsY = glm::max(segments.y, 1u);
+    const auto segmentsZ = glm::max(segments.z, 1u);
+    const auto half = size * 0.5f;
+
+    struct TFace {
+        glm::vec3 Origin;
+        glm::vec3 AxisU;
+        glm::vec3 AxisV;
+        uint32_t SegmentsU;
+        uint32_t SegmentsV;
+    };
+
+    const std::array<TFace, 6> faces = {
+        TFace{{-half.x, -half.y,  half.z}, { size.x, 0.0f, 0.0f}, {0.0f, size.y, 0.0f}, segmentsX, segmentsY}, // +Z
+        TFace{{ half.x, -half.y, -half.z}, {-size.x, 0.0f, 0.0f}, {0.0f, size.y, 0.0f}, segmentsX, segmentsY}, // -Z
+        TFace{{ half.x, -half.y,  half.z}, {0.0f, 0.0f, -size.z}, {0.0f, size.y, 0.0f}, segmentsZ, segmentsY}, // +X
+        TFace{{-half.x, -half.y, -half.z}, {0.0f, 0.0f,  size.z}, {0.0f, size.y, 0.0f}, segmentsZ, segmentsY}, // -X
+        TFace{{-half.x,  half.y,  half.z}, { size.x, 0.0f, 0.0f}, {0.0f, 0.0f, -size.z}, segmentsX, segmentsZ}, // +Y
+        TFace{{-half.x, -half.y, -half.z}, { size.x, 0.0f, 0.0f}, {0.0f, 0.0f,  size.z}, segmentsX, segmentsZ}, // -Y
+    };
+
+    std::size_t vertexCount = 0;
+    std::size_t indexCount = 0;
+    for (const auto& face : faces) {
+        vertexCount += GetGridVertexCount(face.SegmentsU, face.SegmentsV);
+        indexCount += GetGridIndexCount(face.SegmentsU, face.SegmentsV);
+    }
+
+    TAssetPrimitive assetPrimitive = {};
+    assetPrimitive.Name = name;
+    ResizePrimitive(assetPrimitive, vertexCount, indexCount);
+
+    std::size_t vertexOffset = 0;
+    std::size_t indexOffset = 0;
+    for (const auto& face : faces) {
+        WriteGrid(assetPrimitive, vertexOffset, indexOffset, face.Origin, face.AxisU, face.AxisV, face.SegmentsU, face.SegmentsV);
+        vertexOffset += GetGridVertexCount(face.SegmentsU, face.SegmentsV);
+        indexOffset += GetGridIndexCount(face.SegmentsU, face.SegmentsV);
+    }
+
+    CalculateBounds(assetPrimitive);
+
+    return assetPrimitive;
+}
+
+auto CreatePlanePrimitive(
+    const std::string& name,
+    const glm::vec2& size,
+    const glm::uvec2& segments) -> TAssetPrimitive {
+
+    PROFILER_ZONESCOPEDN("CreatePlanePrimitive");
+
+    const auto segmentsX = glm::max(segments.x, 1u);
+    const auto segmentsZ = glm::max(segments.y, 1u);
+
+    TAssetPrimitive assetPrimitive = {};
+    assetPrimitive.Name = name;
+    ResizePrimitive(assetPrimitive, GetGridVertexCount(segmentsX, segmentsZ), GetGridIndexCount(segmentsX, segmentsZ));
+
+    WriteGrid(
+        assetPrimitive,
+        0,
+        0,
+        glm::vec3{-size.x * 0.5f, 0.0f, size.y * 0.5f},
+        glm::vec3{size.x, 0.0f, 0.0f},
+        glm::vec3{0.0f, 0.0f, -size.y},
+        segmentsX,
+        segmentsZ);
+
+    CalculateBounds(assetPrimitive);
+
+    return assetPrimitive;
+}
+
+auto CreateUvSpherePrimitive(
     const std::string& name,
     const float radius,
-    const int32_t rings,
-    const int32_t segments) -> TAssetMesh {
+    const uint32_t rings,
+    const uint32_t segments) -> TAssetPrimitive {
+
+    PROFILER_ZONESCOPEDN("CreateUvSpherePrimitive");
 
-    TAssetPrimitive assetPrimitive;
-    assetPrimitive.Positions.resize(rings * segments * 4);
-    assetPrimitive.Normals.resize(rings * segments * 4);
-    assetPrimitive.Uvs.resize(rings * segments * 4);
-    assetPrimitive.Tangents.resize(rings * segments * 4);
+    const auto ringCount = glm::max(rings, 2u);
+    const auto segmentCount = glm::max(segments, 3u);
+
+    TAssetPrimitive assetPrimitive = {};
+    assetPrimitive.Name = name;
+    ResizePrimitive(assetPrimitive, GetGridVertexCount(segmentCount, ringCount), GetGridIndexCount(segmentCount, ringCount));
 
-    auto index = 0;
     constexpr auto pi = glm::pi<float>();
 
-    for (auto ring = 0; ring <= rings; ++ring) {
+    auto index = 0u;
+    for (auto ring = 0u; ring <= ringCount; ++ring) {
 
-        const auto theta = ring * pi / rings;
+        const auto theta = ring * pi / ringCount;
         const auto sinTheta = glm::sin(theta);
         const auto cosTheta = glm::cos(theta);
 
-        for (auto segment = 0; segment <= segments; ++segment) {
+        for (auto segment = 0u; segment <= segmentCount; ++segment) {
 
-            const auto phi = segment * 2.0f * pi / segments;
+            const auto phi = segment * 2.0f * pi / segmentCount;
             const auto sinPhi = glm::sin(phi);
             const auto cosPhi = glm::cos(phi);
 
-            glm::vec3 position;
-            position.x = radius * cosPhi * sinTheta;
-            position.y = radius * cosTheta;
-            position.z = radius * sinPhi * sinTheta;
-
-            glm::vec3 normal = {
+            const glm::vec3 normal = {
                 cosPhi * sinTheta,
                 cosTheta,
                 sinPhi * sinTheta
             };
 
-            const glm::vec2 uv = {
-                static_cast<float>(segment) / segments,
-                static_cast<float>(ring) / rings,
-            };
-
-            assetPrimitive.Positions[index] = position;
+            assetPrimitive.Positions[index] = radius * normal;
             assetPrimitive.Normals[index] = glm::normalize(normal);
-            assetPrimitive.Uvs[index] = uv;
-            assetPrimitive.Tangents[index] = glm::vec4{0.0f};
+            assetPrimitive.Uvs[index] = glm::vec2{
+                static_cast<float>(segment) / segmentCount,
+                static_cast<float>(ring) / ringCount,
+            };
+            assetPrimitive.Tangents[index] = g_defaultTangent;
             index++;
         }
     }
 
-    assetPrimitive.Indices.resize(rings * segments * 6);
-
     index = 0;
-    for (auto ring = 0; ring < rings; ++ring) {
-        for (auto segment = 0; segment < segments; ++segment) {
-            const auto first = ring * (segments + 1) + segment;
-            const auto second = first + segments + 1;
+    for (auto ring = 0u; ring < ringCount; ++ring) {
+        for (auto segment = 0u; segment < segmentCount; ++segment) {
+            const auto first = ring * (segmentCount + 1) + segment;
+            const auto second = first + segmentCount + 1;
 
             assetPrimitive.Indices[index + 0] = first;
             assetPrimitive.Indices[index + 1] = first + 1;
@@ -820,298 +1119,182 @@ auto CreateUvSphereMeshData(
         }
     }
 
-    assetPrimitive.MaterialName = std::nullopt;
-    CalculateTangents(assetPrimitive);
-
-    TAssetMesh assetMeshData;
-    assetMeshData.Name = name;
-    assetMeshData.Primitives.push_back(assetPrimitive);
+    CalculateBounds(assetPrimitive);
 
-    return assetMeshData;
+    return assetPrimitive;
 }
 
-auto CreateCuboidMesh(
+auto CreateIcospherePrimitive(
     const std::string& name,
-    float width,
-    float height,
-    float depth,
-    uint32_t segmentsX = 1,
-    uint32_t segmentsY = 1,
-    uint32_t segmentsZ = 1) -> TAssetMesh {
-
-    auto halfWidth = width / 2.0f;
-    auto halfHeight = height / 2.0f;
-    auto halfDepth = depth / 2.0f;
-
-    //assetMeshData.InitialTransform = glm::translate(glm::mat4(1.0f), glm::vec3(0, halfHeight, 0));
-
-    std::size_t vertOffset = 0;
-    TAssetPrimitive assetPrimitiveFront;
-    assetPrimitiveFront.MaterialName = std::nullopt;
-
-    // Front Face
-    glm::vec3 normal = {0.0f, 0.0f, 1.0f};
-    for (auto iy = 0; iy < segmentsY; iy++) {
-        for (auto ix = 0; ix < segmentsX; ix++) {
-
-            glm::vec2 uv;
-            uv.x = static_cast<float>(ix)/(static_cast<float>(segmentsX) - 1.0f);
-            uv.y = 1.0f - static_cast<float>(iy) / (static_cast<float>(segmentsY) - 1.0f);
-
-            glm::vec3 position;
-            position.x = uv.x * width - halfWidth;
-            position.y = -(uv.y - 1.0f) * height - halfHeight;
-            position.z = halfDepth;
-
-            assetPrimitiveFront.Positions.push_back(position);
-            assetPrimitiveFront.Uvs.push_back(uv);
-            assetPrimitiveFront.Normals.push_back(normal);
-            assetPrimitiveFront.Tangents.push_back(glm::vec4(0.0f));
-        }
-    }
-
-    for (auto y = 0; y < segmentsY - 1; y++) {
-        for (auto x = 0; x < segmentsX - 1; x++) {
-            assetPrimitiveFront.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveFront.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveFront.Indices.push_back(y * segmentsX + x + vertOffset);
+    const float radius,
+    const uint32_t subdivisions) -> TAssetPrimitive {
 
-            assetPrimitiveFront.Indices.push_back((y + 1) * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveFront.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveFront.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
-        }
-    }
+    PROFILER_ZONESCOPEDN("CreateIcospherePrimitive");
 
-    //vertOffset = assetMeshData.Positions.size();
-    vertOffset = 0;
-    TAssetPrimitive assetPrimitiveRight;
-    assetPrimitiveRight.MaterialName = std::nullopt;
-
-    // Right Side Face
-    normal = {1.0f, 0.0f, 0.0f};
-    for (auto iy = 0; iy < segmentsY; iy++) {
-        for (auto ix = 0; ix < segmentsZ; ix++) {
-
-            glm::vec2 uv;
-            uv.x = static_cast<float>(ix) / (static_cast<float>(segmentsZ) - 1.0f);
-            uv.y = 1.0f - static_cast<float>(iy) / (static_cast<float>(segmentsY) - 1.0f);
-
-            glm::vec3 position;
-            position.x = halfWidth;
-            position.y = -(uv.y - 1.0f) * height - halfHeight;
-            position.z = uv.x * -depth + halfDepth;
-
-            assetPrimitiveRight.Positions.push_back(position);
-            assetPrimitiveRight.Uvs.push_back(uv);
-            assetPrimitiveRight.Normals.push_back(normal);
-            assetPrimitiveRight.Tangents.push_back(glm::vec4{0.0f});
-        }
-    }
+    constexpr auto t = 1.6180339887f;
+    constexpr std::array<glm::vec3, 12> icosahedronVertices = {
+        glm::vec3{-1.0f,  t, 0.0f}, glm::vec3{ 1.0f,  t, 0.0f}, glm::vec3{-1.0f, -t, 0.0f}, glm::vec3{ 1.0f, -t, 0.0f},
+        glm::vec3{0.0f, -1.0f,  t}, glm::vec3{0.0f,  1.0f,  t}, glm::vec3{0.0f, -1.0f, -t}, glm::vec3{0.0f,  1.0f, -t},
+        glm::vec3{ t, 0.0f, -1.0f}, glm::vec3{ t, 0.0f,  1.0f}, glm::vec3{-t, 0.0f, -1.0f}, glm::vec3{-t, 0.0f,  1.0f},
+    };
+    constexpr std::array<uint32_t, 60> icosahedronIndices = {
+        0, 11, 5, 0, 5, 1, 0, 1, 7, 0, 7, 10, 0, 10, 11,
+        1, 5, 9, 5, 11, 4, 11, 10, 2, 10, 7, 6, 7, 1, 8,
+        3, 9, 4, 3, 4, 2, 3, 2, 6, 3, 6, 8, 3, 8, 9,
+        4, 9, 5, 2, 4, 11, 6, 2, 10, 8, 6, 7, 9, 8, 1,
+    };
 
-    for (auto y = 0; y < segmentsY - 1; y++) {
-        for (auto x = 0; x < segmentsZ - 1; x++) {
-            assetPrimitiveRight.Indices.push_back(y * segmentsZ + x + 1 + vertOffset);
-            assetPrimitiveRight.Indices.push_back((y + 1) * segmentsZ + x + vertOffset);
-            assetPrimitiveRight.Indices.push_back(y * segmentsZ + x + vertOffset);
+    // every subdivision splits each triangle into 4 and adds one vertex per edge
+    const auto levelScale = static_cast<std::size_t>(1) << (2 * subdivisions);
+    const auto sphereVertexCount = 10 * levelScale + 2;
+    const auto indexCount = 60 * levelScale;
 
-            assetPrimitiveRight.Indices.push_back((y + 1) * segmentsZ + x + 1 + vertOffset);
-            assetPrimitiveRight.Indices.push_back((y + 1) * segmentsZ + x + vertOffset);
-            assetPrimitiveRight.Indices.push_back(y * segmentsZ + x + 1 + vertOffset);
-        }
-    }
+    std::vector<glm::vec3> unitPositions(sphereVertexCount);
+    std::vector<uint32_t> indices(indexCount);
+    std::vector<uint32_t> subdividedIndices(indexCount);
 
-    //vertOffset = assetMeshData.Positions.size();
-    vertOffset = 0;
-    TAssetPrimitive assetPrimitiveLeft;
-    assetPrimitiveLeft.MaterialName = std::nullopt;
-
-    // Left Side Face
-    normal = {-1.0f, 0.0f, 0.0f};
-    for (auto iy = 0; iy < segmentsY; iy++) {
-        for (auto ix = 0; ix < segmentsZ; ix++) {
-
-            glm::vec2 uv;
-            uv.x = static_cast<float>(ix) / (static_cast<float>(segmentsZ) - 1.0f);
-            uv.y = 1.0f - static_cast<float>(iy) / (static_cast<float>(segmentsY) - 1.0f);
-
-            glm::vec3 position;
-            position.x = -halfWidth;
-            position.y = -(uv.y - 1.0f) * height - halfHeight;
-            position.z = uv.x * depth - halfDepth;
-
-            assetPrimitiveLeft.Positions.push_back(position);
-            assetPrimitiveLeft.Uvs.push_back(uv);
-            assetPrimitiveLeft.Normals.push_back(normal);
-            assetPrimitiveLeft.Tangents.push_back(glm::vec4{0.0f});
-        }
-    }
+    std::ranges::transform(icosahedronVertices, unitPositions.begin(), [](const glm::vec3& v) { return glm::normalize(v); });
+    std::ranges::copy(icosahedronIndices, indices.begin());
 
-    for (auto y = 0; y < segmentsY - 1; y++) {
-        for (auto x = 0; x < segmentsZ - 1; x++) {
-            assetPrimitiveLeft.Indices.push_back(y * segmentsZ + x + 1 + vertOffset);
-            assetPrimitiveLeft.Indices.push_back((y + 1) * segmentsZ + x + vertOffset);
-            assetPrimitiveLeft.Indices.push_back(y * segmentsZ + x + vertOffset);
+    auto vertexCount = static_cast<uint32_t>(icosahedronVertices.size());
+    auto currentIndexCount = icosahedronIndices.size();
 
-            assetPrimitiveLeft.Indices.push_back((y + 1) * segmentsZ + x + 1 + vertOffset);
-            assetPrimitiveLeft.Indices.push_back((y + 1) * segmentsZ + x + vertOffset);
-            assetPrimitiveLeft.Indices.push_back(y * segmentsZ + x + 1 + vertOffset);
-        }
-    }
+    phmap::flat_hash_map<uint64_t, uint32_t> midpoints;
+    midpoints.reserve(30 * levelScale);
 
-    //vertOffset = assetMeshData.Positions.size();
-    vertOffset = 0;
-    TAssetPrimitive assetPrimitiveBack;
-    assetPrimitiveBack.MaterialName = std::nullopt;
-
-    // Back Face
-    normal = {0.0f, 0.0f, -1.0f};
-    for (auto iy = 0; iy < segmentsY; iy++) {
-        for (auto ix = 0; ix < segmentsX; ix++) {
-
-            glm::vec2 uv;
-            uv.x = static_cast<float>(ix) / (static_cast<float>(segmentsX) - 1.0f);
-            uv.y = 1.0f - static_cast<float>(iy) / (static_cast<float>(segmentsY) - 1.0f);
-
-            glm::vec3 position;
-            position.x = uv.x * -width + halfWidth;
-            position.y = -(uv.y - 1.0f) * height - halfHeight;
-            position.z = -halfDepth;
-
-            assetPrimitiveBack.Positions.push_back(position);
-            assetPrimitiveBack.Uvs.push_back(uv);
-            assetPrimitiveBack.Normals.push_back(normal);
-            assetPrimitiveBack.Tangents.push_back(glm::vec4{0.0f});
-        }
-    }
+    for (auto subdivision = 0u; subdivision < subdivisions; ++subdivision) {
 
-    for (auto y = 0; y < segmentsY - 1; y++) {
-        for (auto x = 0; x < segmentsX - 1; x++) {
-            assetPrimitiveBack.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveBack.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveBack.Indices.push_back(y * segmentsX + x + vertOffset);
+        midpoints.clear();
+        auto getMidpoint = [&](const uint32_t a, const uint32_t b) -> uint32_t {
+            const auto key = (static_cast<uint64_t>(glm::min(a, b)) << 32) | glm::max(a, b);
+            const auto [iterator, inserted] = midpoints.try_emplace(key, vertexCount);
+            if (inserted) {
+                unitPositions[vertexCount++] = glm::normalize(unitPositions[a] + unitPositions[b]);
+            }
+            return iterator->second;
+        };
 
-            assetPrimitiveBack.Indices.push_back((y + 1) * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveBack.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveBack.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
+        for (std::size_t triangle = 0; triangle < currentIndexCount; triangle += 3) {
+            const auto a = indices[triangle + 0];
+            const auto b = indices[triangle + 1];
+            const auto c = indices[triangle + 2];
+            const auto ab = getMidpoint(a, b);
+            const auto bc = getMidpoint(b, c);
+            const auto ca = getMidpoint(c, a);
+
+            auto* out = &subdividedIndices[triangle * 4];
+            out[0] = a;  out[1] = ab; out[2] = ca;
+            out[3] = b;  out[4] = bc; out[5] = ab;
+            out[6] = c;  out[7] = ca; out[8] = bc;
+            out[9] = ab; out[10] = bc; out[11] = ca;
         }
-    }
-
-    //vertOffset = assetMeshData.Positions.size();
-    vertOffset = 0;
-
-    TAssetPrimitive assetPrimitiveTop;
-    assetPrimitiveTop.MaterialName = std::nullopt;
-
-    // Top Face
-    normal = {0.0f, 1.0f, 0.0f};
-    for (auto iy = 0; iy < segmentsZ; iy++) {
-        for (auto ix = 0; ix < segmentsX; ix++) {
 
-            glm::vec2 uv;
-            uv.x = static_cast<float>(ix) / (static_cast<float>(segmentsX) - 1.0f);
-            uv.y = 1.f - static_cast<float>(iy) / (static_cast<float>(segmentsZ) - 1.0f);
-
-            glm::vec3 position;
-            position.x = uv.x * width - halfWidth;
-            position.y = -halfHeight;
-            position.z = uv.y * depth - halfDepth;
+        currentIndexCount *= 4;
+        std::swap(indices, subdividedIndices);
+    }
 
-            assetPrimitiveTop.Positions.push_back(position);
-            assetPrimitiveTop.Uvs.push_back(uv);
-            assetPrimitiveTop.Normals.push_back(normal);
-            assetPrimitiveTop.Tangents.push_back(glm::vec4{0.0f});
-        }
+    constexpr auto pi = glm::pi<float>();
+    std::vector<glm::vec2> uvs(sphereVertexCount);
+    for (std::size_t vertex = 0; vertex < sphereVertexCount; ++vertex) {
+        const auto& p = unitPositions[vertex];
+        const auto u = glm::atan(p.z, p.x) / (2.0f * pi);
+        uvs[vertex] = glm::vec2{u < 0.0f ? u + 1.0f : u, glm::acos(glm::clamp(p.y, -1.0f, 1.0f)) / pi};
     }
 
-    for (auto y = 0; y < segmentsZ - 1; y++) {
-        for (auto x = 0; x < segmentsX - 1; x++) {
-            assetPrimitiveTop.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveTop.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveTop.Indices.push_back(y * segmentsX + x + vertOffset);
+    // triangles crossing the u = 0 / u = 1 seam get their low-u vertices duplicated with u + 1
+    constexpr auto noSeamVertex = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> seamVertices(sphereVertexCount, noSeamVertex);
+    auto isSeamTriangle = [&](const std::size_t triangle) -> bool {
+        const auto u0 = uvs[indices[triangle + 0]].x;
+        const auto u1 = uvs[indices[triangle + 1]].x;
+        const auto u2 = uvs[indices[triangle + 2]].x;
+        return glm::max(u0, glm::max(u1, u2)) - glm::min(u0, glm::min(u1, u2)) > 0.5f;
+    };
 
-            assetPrimitiveTop.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveTop.Indices.push_back((y + 1) * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveTop.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
+    auto seamVertexCount = 0u;
+    for (std::size_t triangle = 0; triangle < indexCount; triangle += 3) {
+        if (!isSeamTriangle(triangle)) {
+            continue;
+        }
+        for (auto corner = 0; corner < 3; ++corner) {
+            const auto vertex = indices[triangle + corner];
+            if (uvs[vertex].x < 0.5f && seamVertices[vertex] == noSeamVertex) {
+                seamVertices[vertex] = static_cast<uint32_t>(sphereVertexCount) + seamVertexCount++;
+            }
         }
     }
 
-    //vertOffset = assetMeshData.Positions.size();
-    vertOffset = 0;
-
-    TAssetPrimitive assetPrimitiveBottom;
-    assetPrimitiveBottom.MaterialName = std::nullopt;
-    // Bottom Face
-    normal = {0.0f, -1.0f, 0.0f};
-    for (auto iy = 0; iy < segmentsZ; iy++) {
-        for (auto ix = 0; ix < segmentsX; ix++) {
-
-            glm::vec2 uv;
-            uv.x = static_cast<float>(ix) / (segmentsX - 1.0f);
-            uv.y = 1.0f - static_cast<float>(iy) / (segmentsZ - 1.0f);
-
-            glm::vec3 position;
-            position.x = uv.x * width - halfWidth;
-            position.y = halfHeight;
-            position.z = uv.y * -depth + halfDepth;
-
-            assetPrimitiveBottom.Positions.push_back(position);
-            assetPrimitiveBottom.Uvs.push_back(uv);
-            assetPrimitiveBottom.Normals.push_back(normal);
-            assetPrimitiveBottom.Tangents.push_back(glm::vec4{0.0f});
+    TAssetPrimitive assetPrimitive = {};
+    assetPrimitive.Name = name;
+    ResizePrimitive(assetPrimitive, sphereVertexCount + seamVertexCount, 0);
+
+    for (std::size_t vertex = 0; vertex < sphereVertexCount; ++vertex) {
+        assetPrimitive.Positions[vertex] = unitPositions[vertex] * radius;
+        assetPrimitive.Normals[vertex] = unitPositions[vertex];
+        assetPrimitive.Uvs[vertex] = uvs[vertex];
+        assetPrimitive.Tangents[vertex] = g_defaultTangent;
+
+        const auto seamVertex = seamVertices[vertex];
+        if (seamVertex != noSeamVertex) {
+            assetPrimitive.Positions[seamVertex] = unitPositions[vertex] * radius;
+            assetPrimitive.Normals[seamVertex] = unitPositions[vertex];
+            assetPrimitive.Uvs[seamVertex] = uvs[vertex] + glm::vec2{1.0f, 0.0f};
+            assetPrimitive.Tangents[seamVertex] = g_defaultTangent;
         }
     }
 
-    for (auto y = 0; y < segmentsZ-1; y++) {
-        for (auto x = 0; x < segmentsX-1; x++) {
-            assetPrimitiveBottom.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveBottom.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveBottom.Indices.push_back(y * segmentsX + x + vertOffset);
-            
-            assetPrimitiveBottom.Indices.push_back((y + 1) * segmentsX + x + vertOffset);
-            assetPrimitiveBottom.Indices.push_back((y + 1) * segmentsX + x + 1 + vertOffset);
-            assetPrimitiveBottom.Indices.push_back(y * segmentsX + x + 1 + vertOffset);
+    for (std::size_t triangle = 0; triangle < indexCount; triangle += 3) {
+        if (!isSeamTriangle(triangle)) {
+            continue;
+        }
+        for (auto corner = 0; corner < 3; ++corner) {
+            auto& vertex = indices[triangle + corner];
+            if (uvs[vertex].x < 0.5f) {
+                vertex = seamVertices[vertex];
+            }
         }
     }
 
-    TAssetMesh assetMeshData;
-    assetMeshData.Name = name;
-    assetMeshData.Primitives.push_back(assetPrimitiveFront);
-    assetMeshData.Primitives.push_back(assetPrimitiveBack);
-    assetMeshData.Primitives.push_back(assetPrimitiveLeft);
-    assetMeshData.Primitives.push_back(assetPrimitiveRight);
-    assetMeshData.Primitives.push_back(assetPrimitiveTop);
-    assetMeshData.Primitives.push_back(assetPrimitiveBottom);
-
-    for (auto& assetPrimitive : assetMeshData.Primitives) {
-        CalculateTangents(assetPrimitive);
-    }
+    assetPrimitive.Indices = std::move(indices);
+
+    CalculateBounds(assetPrimitive);
 
-    return std::move(assetMeshData);
+    return assetPrimitive;
 }
 
-auto CreateCuboid(
+auto AddPrimitiveModel(
     const std::string& name,
-    const float width,
-    const float height,
-    const float depth,
-    const uint32_t segmentsX,
-    const uint32_t segmentsY,
-    const uint32_t segmentsZ,
+    TAssetPrimitive&& assetPrimitive,
     const std::string& materialName) -> void {
 
-    TAssetModel cuboid = {};
-    cuboid.Materials.push_back(materialName);
-    cuboid.Meshes.push_back(name);
-    cuboid.Hierarchy.push_back(TAssetModelNode{
+    assetPrimitive.Name = name;
+    assetPrimitive.MaterialName = materialName;
+
+    const auto materialIterator = g_assetMaterials.find(materialName);
+    if (materialIterator != g_assetMaterials.end() && materialIterator->second.NormalTextureChannel.has_value()) {
+        GenerateTangents(std::array{&assetPrimitive}, TTangentGenerationMethod::Welded);
+    }
+
+    TAssetModel model = {};
+    model.Name = name;
+    model.Materials.push_back(materialName);
+    model.Meshes.push_back(name);
+    model.Hierarchy.push_back(TAssetModelNode{
         .Name = name,
         .LocalPosition = glm::vec3(0.0f, 0.0f, 0.0f),
         .LocalRotation = glm::identity<glm::quat>(),
         .LocalScale = glm::vec3(1.0f),
         .MeshName = name,
     });
-   
-    g_assetModels[name] = std::move(cuboid);
-    g_assetMeshes[name] = CreateCuboidMesh(name, width, height, depth, segmentsX, segmentsY, segmentsZ);
+
+    g_assetPrimitives[name] = assetPrimitive;
+
+    TAssetMesh assetMesh = {};
+    assetMesh.Name = name;
+    assetMesh.Primitives.push_back(std::move(assetPrimitive));
+
+    g_assetMeshes[name] = std::move(assetMesh);
+    g_assetModels[name] = std::move(model);
 }
 
 auto AddAssetModel(const std::string& assetName, const TAssetModel& asset) -> void {
@@ -1204,16 +1387,22 @@ auto AddDefaultAssets() -> void {
     };
     g_assetMaterials["M_Mars"] = std::move(marsMaterial);
 
-    auto geodesic = CreateUvSphereMeshData("SM_Geodesic", 1, 64, 64);
-    g_assetMeshes["SM_Geodesic"] = std::move(geodesic);
-
-    for (auto i = 1; i < 11; i++) {
-        CreateCuboid(std::format("SM_Cuboid_x{}_y1_z1", i), i, 1.0f, 1.0f, i + 1, i + 1, i + 1, "M_Orange");
-        CreateCuboid(std::format("SM_Cuboid_x1_y{}_z1", i), 1.0f, i, 1.0f, i + 1, i + 1, i + 1, "M_Orange");
-        CreateCuboid(std::format("SM_Cuboid_x1_y1_z{}", i), 1.0f, 1.0f, i, i + 1, i + 1, i + 1, "M_Orange");
+    AddPrimitiveModel("SM_Geodesic", CreateUvSpherePrimitive("SM_Geodesic", 1.0f, 64, 64), "M_Default");
+    AddPrimitiveModel("SM_Icosphere", CreateIcospherePrimitive("SM_Icosphere", 1.0f, 4), "M_Default");
+    AddPrimitiveModel("SM_Plane_x50_z50", CreatePlanePrimitive("SM_Plane_x50_z50", glm::vec2{50.0f}, glm::uvec2{4}), "M_Gray");
+
+    for (auto i = 1u; i < 11u; i++) {
+        const auto size = static_cast<float>(i);
+        const auto segments = glm::uvec3{i};
+        const auto nameX = std::format("SM_Cuboid_x{}_y1_z1", i);
+        const auto nameY = std::format("SM_Cuboid_x1_y{}_z1", i);
+        const auto nameZ = std::format("SM_Cuboid_x1_y1_z{}", i);
+        AddPrimitiveModel(nameX, CreateBoxPrimitive(nameX, glm::vec3{size, 1.0f, 1.0f}, segments), "M_Orange");
+        AddPrimitiveModel(nameY, CreateBoxPrimitive(nameY, glm::vec3{1.0f, size, 1.0f}, segments), "M_Orange");
+        AddPrimitiveModel(nameZ, CreateBoxPrimitive(nameZ, glm::vec3{1.0f, 1.0f, size}, segments), "M_Orange");
     }
 
-    CreateCuboid("SM_Cuboid_x50_y1_z50", 50.0f, 1.0f, 50.0f, 4, 4, 4, "M_Orange");
+    AddPrimitiveModel("SM_Cuboid_x50_y1_z50", CreateBoxPrimitive("SM_Cuboid_x50_y1_z50", glm::vec3{50.0f, 1.0f, 50.0f}, glm::uvec3{3}), "M_Orange");
 }
 
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Bounds.hpp"
+
 #include <parallel_hashmap/phmap_fwd_decl.h>
 
 namespace Assets {
@@ -85,6 +87,8 @@ struct TAssetPrimitive {
     std::vector<glm::vec4> Tangents;
     std::vector<uint32_t> Indices;
     std::optional<std::string> MaterialName;
+    TBoundingBox BoundingBox = {};
+    TBoundingSphere BoundingSphere = {};
 };
 
 struct TAssetMesh {
@@ -126,4 +130,26 @@ auto GetAssetMesh(std::string_view meshDataName) -> TAssetMesh&;
 auto GetAssetPrimitive(std::string_view assetPrimitiveName) -> TAssetPrimitive&;
 auto AddDefaultAssets() -> void;
 
+auto CreateBoxPrimitive(
+    const std::string& name,
+    const glm::vec3& size,
+    const glm::uvec3& segments) -> TAssetPrimitive;
+auto CreatePlanePrimitive(
+    const std::string& name,
+    const glm::vec2& size,
+    const glm::uvec2& segments) -> TAssetPrimitive;
+auto CreateUvSpherePrimitive(
+    const std::string& name,
+    float radius,
+    uint32_t rings,
+    uint32_t segments) -> TAssetPrimitive;
+auto CreateIcospherePrimitive(
+    const std::string& name,
+    float radius,
+    uint32_t subdivisions) -> TAssetPrimitive;
+auto AddPrimitiveModel(
+    const std::string& name,
+    TAssetPrimitive&& assetPrimitive,
+    const std::string& materialName) -> void;
+
 }
@@ -0,0 +1,105 @@
+#include "Bounds.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define BOUNDS_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+auto CalculateBoundingBox(const std::span<const glm::vec3> positions) -> TBoundingBox {
+
+    PROFILER_ZONESCOPEDN("CalculateBoundingBox");
+
+    TBoundingBox boundingBox = {};
+    if (positions.empty()) {
+        return boundingBox;
+    }
+
+    std::size_t vertex = 0;
+
+#ifdef BOUNDS_USE_SSE
+    // glm::vec3 is tightly packed, so 4 vertices are exactly 3 registers:
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    if (positions.size() >= 4) {
+        const auto* data = glm::value_ptr(positions[0]);
+
+        auto minA = _mm_loadu_ps(data + 0);
+        auto minB = _mm_loadu_ps(data + 4);
+        auto minC = _mm_loadu_ps(data + 8);
+        auto maxA = minA;
+        auto maxB = minB;
+        auto maxC = minC;
+
+        const auto blockCount = positions.size() / 4;
+        for (std::size_t block = 1; block < blockCount; ++block) {
+            const auto* blockData = data + block * 12;
+            const auto a = _mm_loadu_ps(blockData + 0);
+            const auto b = _mm_loadu_ps(blockData + 4);
+            const auto c = _mm_loadu_ps(blockData + 8);
+            minA = _mm_min_ps(minA, a);
+            minB = _mm_min_ps(minB, b);
+            minC = _mm_min_ps(minC, c);
+            maxA = _mm_max_ps(maxA, a);
+            maxB = _mm_max_ps(maxB, b);
+            maxC = _mm_max_ps(maxC, c);
+        }
+
+        alignas(16) float lanes[6][4];
+        _mm_store_ps(lanes[0], minA);
+        _mm_store_ps(lanes[1], minB);
+        _mm_store_ps(lanes[2], minC);
+        _mm_store_ps(lanes[3], maxA);
+        _mm_store_ps(lanes[4], maxB);
+        _mm_store_ps(lanes[5], maxC);
+
+        boundingBox.Min = glm::min(
+            glm::min(glm::vec3{lanes[0][0], lanes[0][1], lanes[0][2]}, glm::vec3{lanes[0][3], lanes[1][0], lanes[1][1]}),
+            glm::min(glm::vec3{lanes[1][2], lanes[1][3], lanes[2][0]}, glm::vec3{lanes[2][1], lanes[2][2], lanes[2][3]}));
+        boundingBox.Max = glm::max(
+            glm::max(glm::vec3{lanes[3][0], lanes[3][1], lanes[3][2]}, glm::vec3{lanes[3][3], lanes[4][0], lanes[4][1]}),
+            glm::max(glm::vec3{lanes[4][2], lanes[4][3], lanes[5][0]}, glm::vec3{lanes[5][1], lanes[5][2], lanes[5][3]}));
+
+        vertex = blockCount * 4;
+    }
+#endif
+
+    for (; vertex < positions.size(); ++vertex) {
+        boundingBox.Min = glm::min(boundingBox.Min, positions[vertex]);
+        boundingBox.Max = glm::max(boundingBox.Max, positions[vertex]);
+    }
+
+    return boundingBox;
+}
+
+auto CalculateBoundingSphere(
+    const std::span<const glm::vec3> positions,
+    const glm::vec3& center) -> TBoundingSphere {
+
+    PROFILER_ZONESCOPEDN("CalculateBoundingSphere");
+
+    auto radiusSquared = 0.0f;
+    for (const auto& position : positions) {
+        const auto offset = position - center;
+        radiusSquared = glm::max(radiusSquared, glm::dot(offset, offset));
+    }
+
+    return TBoundingSphere{
+        .Center = center,
+        .Radius = glm::sqrt(radiusSquared),
+    };
+}
+
+auto TransformBoundingSphere(
+    const TBoundingSphere& boundingSphere,
+    const glm::mat4& transform) -> TBoundingSphere {
+
+    const auto maxScaleSquared = glm::max(
+        glm::dot(glm::vec3(transform[0]), glm::vec3(transform[0])),
+        glm::max(
+            glm::dot(glm::vec3(transform[1]), glm::vec3(transform[1])),
+            glm::dot(glm::vec3(transform[2]), glm::vec3(transform[2]))));
+
+    return TBoundingSphere{
+        .Center = glm::vec3(transform * glm::vec4(boundingSphere.Center, 1.0f)),
+        .Radius = boundingSphere.Radius * glm::sqrt(maxScaleSquared),
+    };
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/vector_relational.hpp>
+
+#include <limits>
+#include <span>
+
+struct TBoundingBox {
+    glm::vec3 Min = glm::vec3{std::numeric_limits<float>::max()};
+    glm::vec3 Max = glm::vec3{std::numeric_limits<float>::lowest()};
+
+    auto GetCenter() const -> glm::vec3 { return (Min + Max) * 0.5f; }
+    auto GetExtent() const -> glm::vec3 { return (Max - Min) * 0.5f; }
+    auto IsValid() const -> bool { return glm::all(glm::lessThanEqual(Min, Max)); }
+};
+
+struct TBoundingSphere {
+    glm::vec3 Center = {};
+    float Radius = 0.0f;
+};
+
+auto CalculateBoundingBox(std::span<const glm::vec3> positions) -> TBoundingBox;
+auto CalculateBoundingSphere(
+    std::span<const glm::vec3> positions,
+    const glm::vec3& center) -> TBoundingSphere;
+
+auto TransformBoundingSphere(
+    const TBoundingSphere& boundingSphere,
+    const glm::mat4& transform) -> TBoundingSphere;
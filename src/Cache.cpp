@@ -0,0 +1,122 @@
+#include "Cache.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <bit>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <thread>
+
+constexpr auto g_cacheDirectory = "cache";
+
+namespace {
+
+constexpr auto XXH_PRIME64_1 = 0x9E3779B185EBCA87ull;
+constexpr auto XXH_PRIME64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr auto XXH_PRIME64_3 = 0x165667B19E3779F9ull;
+constexpr auto XXH_PRIME64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr auto XXH_PRIME64_5 = 0x27D4EB2F165667C5ull;
+
+}
+
+auto Cache::HashBytes(
+    const std::span<const std::byte> bytes,
+    const uint64_t seed) -> uint64_t {
+
+    PROFILER_ZONESCOPEDN("Cache::HashBytes");
+
+    // the word and byte rounds of xxh64 followed by its avalanche, every input bit reaches every output bit
+    auto hash = seed + XXH_PRIME64_5 + static_cast<uint64_t>(bytes.size());
+
+    const auto wordCount = bytes.size() / sizeof(uint64_t);
+    for (std::size_t i = 0; i < wordCount; ++i) {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i * sizeof(uint64_t), sizeof(uint64_t));
+        hash ^= std::rotl(word * XXH_PRIME64_2, 31) * XXH_PRIME64_1;
+        hash = std::rotl(hash, 27) * XXH_PRIME64_1 + XXH_PRIME64_4;
+    }
+
+    for (auto i = wordCount * sizeof(uint64_t); i < bytes.size(); ++i) {
+        hash ^= static_cast<uint64_t>(bytes[i]) * XXH_PRIME64_5;
+        hash = std::rotl(hash, 11) * XXH_PRIME64_1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= XXH_PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= XXH_PRIME64_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+auto Cache::GetFilePath(
+    const std::string_view category,
+    const uint64_t key) -> std::filesystem::path {
+
+    return std::filesystem::path(g_cacheDirectory) / category / std::format("{:016x}.bin", key);
+}
+
+auto Cache::Load(
+    const std::string_view category,
+    const uint64_t key) -> std::optional<std::vector<std::byte>> {
+
+    PROFILER_ZONESCOPEDN("Cache::Load");
+
+    const auto filePath = GetFilePath(category, key);
+    std::error_code errorCode;
+    const auto fileSize = std::filesystem::file_size(filePath, errorCode);
+    if (errorCode) {
+        return std::nullopt;
+    }
+
+    std::ifstream file{filePath, std::ifstream::binary};
+    if (!file) {
+        return std::nullopt;
+    }
+
+    std::vector<std::byte> data(fileSize);
+    file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(fileSize));
+    if (file.gcount() != static_cast<std::streamsize>(fileSize)) {
+        return std::nullopt;
+    }
+
+    return data;
+}
+
+auto Cache::Store(
+    const std::string_view category,
+    const uint64_t key,
+    const std::span<const std::byte> data) -> bool {
+
+    PROFILER_ZONESCOPEDN("Cache::Store");
+
+    const auto filePath = GetFilePath(category, key);
+    std::error_code errorCode;
+    std::filesystem::create_directories(filePath.parent_path(), errorCode);
+    if (errorCode) {
+        spdlog::error("Cache: Unable to create directory {}: {}", filePath.parent_path().string(), errorCode.message());
+        return false;
+    }
+
+    // write next to the final file and rename, so concurrent readers never see partial entries
+    auto temporaryFilePath = filePath;
+    temporaryFilePath += std::format(".{}", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file{temporaryFilePath, std::ofstream::binary | std::ofstream::trunc};
+        if (!file) {
+            spdlog::error("Cache: Unable to write {}", temporaryFilePath.string());
+            return false;
+        }
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::filesystem::rename(temporaryFilePath, filePath, errorCode);
+    if (errorCode) {
+        std::filesystem::remove(temporaryFilePath, errorCode);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <span>
+
+namespace Cache {
+
+    auto HashBytes(
+        std::span<const std::byte> bytes,
+        uint64_t seed = 14695981039346656037ull) -> uint64_t;
+
+    // for entries which are read piecewise instead of through Load
+    auto GetFilePath(
+        std::string_view category,
+        uint64_t key) -> std::filesystem::path;
+
+    auto Load(
+        std::string_view category,
+        uint64_t key) -> std::optional<std::vector<std::byte>>;
+
+    auto Store(
+        std::string_view category,
+        uint64_t key,
+        std::span<const std::byte> data) -> bool;
+
+}
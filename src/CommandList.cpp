@@ -0,0 +1,410 @@
+#include "CommandList.hpp"
+#include "Profiler.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+struct TBindPipelineCommand {
+    TPipeline* Pipeline;
+};
+
+struct TBindFramebufferCommand {
+    const TFramebuffer* Framebuffer;
+};
+
+struct TBindBufferCommand {
+    uint32_t Buffer;
+    uint32_t BindingIndex;
+    int64_t Offset;
+    int64_t Size;
+};
+
+struct TBindTextureCommand {
+    uint32_t BindingIndex;
+    uint32_t Texture;
+    uint32_t Sampler;
+};
+
+template<typename TValue>
+struct TSetUniformCommand {
+    int32_t Location;
+    TValue Value;
+};
+
+struct TDrawArraysCommand {
+    int32_t VertexOffset;
+    size_t VertexCount;
+};
+
+struct TMultiDrawElementsIndirectCommand {
+    uint32_t IndexBuffer;
+    uint32_t IndirectBuffer;
+    size_t IndirectBufferOffset;
+    uint32_t CountBuffer;
+    size_t CountBufferOffset;
+    size_t DrawCount;
+};
+
+struct TDispatchCommand {
+    int32_t WorkGroupSizeX;
+    int32_t WorkGroupSizeY;
+    int32_t WorkGroupSizeZ;
+};
+
+struct TInsertMemoryBarrierCommand {
+    TMemoryBarrierMask MemoryBarrierMask;
+};
+
+struct TPushDebugGroupCommand {
+    const char* Label;
+    std::size_t LabelLength;
+};
+
+// the stream is unaligned, payloads are copied out instead of being referenced in place
+template<typename TCommand>
+auto ReadCommand(const uint8_t*& cursor) -> TCommand {
+
+    static_assert(std::is_trivially_copyable_v<TCommand>);
+
+    TCommand command;
+    std::memcpy(&command, cursor, sizeof(TCommand));
+    cursor += sizeof(TCommand);
+    return command;
+}
+
+}
+
+TCommandList::TCommandList() {
+
+    Data.reserve(COMMAND_LIST_INITIAL_CAPACITY);
+}
+
+auto TCommandList::Reset() -> void {
+
+    Data.clear();
+    CommandCount = 0;
+}
+
+auto TCommandList::Write(
+    const TCommandType commandType,
+    const void* payload,
+    const std::size_t payloadSize) -> void {
+
+    const auto offset = Data.size();
+    Data.resize(offset + sizeof(TCommandType) + payloadSize);
+    std::memcpy(Data.data() + offset, &commandType, sizeof(TCommandType));
+    if (payloadSize > 0) {
+        std::memcpy(Data.data() + offset + sizeof(TCommandType), payload, payloadSize);
+    }
+    CommandCount++;
+}
+
+auto TCommandList::BindPipeline(TGraphicsPipeline& pipeline) -> void {
+
+    const auto command = TBindPipelineCommand{.Pipeline = &pipeline};
+    Write(TCommandType::BindPipeline, &command, sizeof(command));
+}
+
+auto TCommandList::BindPipeline(TComputePipeline& pipeline) -> void {
+
+    const auto command = TBindPipelineCommand{.Pipeline = &pipeline};
+    Write(TCommandType::BindPipeline, &command, sizeof(command));
+}
+
+auto TCommandList::BindFramebuffer(const TFramebuffer& framebuffer) -> void {
+
+    const auto command = TBindFramebufferCommand{.Framebuffer = &framebuffer};
+    Write(TCommandType::BindFramebuffer, &command, sizeof(command));
+}
+
+auto TCommandList::BindBufferAsUniformBuffer(
+    const uint32_t buffer,
+    const uint32_t bindingIndex,
+    const int64_t offset,
+    const int64_t size) -> void {
+
+    const auto command = TBindBufferCommand{
+        .Buffer = buffer,
+        .BindingIndex = bindingIndex,
+        .Offset = offset,
+        .Size = size,
+    };
+    Write(TCommandType::BindUniformBuffer, &command, sizeof(command));
+}
+
+auto TCommandList::BindBufferAsShaderStorageBuffer(
+    const uint32_t buffer,
+    const uint32_t bindingIndex,
+    const int64_t offset,
+    const int64_t size) -> void {
+
+    const auto command = TBindBufferCommand{
+        .Buffer = buffer,
+        .BindingIndex = bindingIndex,
+        .Offset = offset,
+        .Size = size,
+    };
+    Write(TCommandType::BindShaderStorageBuffer, &command, sizeof(command));
+}
+
+auto TCommandList::BindTexture(
+    const uint32_t bindingIndex,
+    const uint32_t texture) -> void {
+
+    const auto command = TBindTextureCommand{
+        .BindingIndex = bindingIndex,
+        .Texture = texture,
+        .Sampler = 0,
+    };
+    Write(TCommandType::BindTexture, &command, sizeof(command));
+}
+
+auto TCommandList::BindTextureAndSampler(
+    const uint32_t bindingIndex,
+    const uint32_t texture,
+    const uint32_t sampler) -> void {
+
+    const auto command = TBindTextureCommand{
+        .BindingIndex = bindingIndex,
+        .Texture = texture,
+        .Sampler = sampler,
+    };
+    Write(TCommandType::BindTextureAndSampler, &command, sizeof(command));
+}
+
+auto TCommandList::SetUniform(
+    const int32_t location,
+    const int32_t value) -> void {
+
+    const auto command = TSetUniformCommand<int32_t>{.Location = location, .Value = value};
+    Write(TCommandType::SetUniformInt, &command, sizeof(command));
+}
+
+auto TCommandList::SetUniform(
+    const int32_t location,
+    const uint32_t value) -> void {
+
+    const auto command = TSetUniformCommand<uint32_t>{.Location = location, .Value = value};
+    Write(TCommandType::SetUniformUInt, &command, sizeof(command));
+}
+
+auto TCommandList::SetUniform(
+    const int32_t location,
+    const float value) -> void {
+
+    const auto command = TSetUniformCommand<float>{.Location = location, .Value = value};
+    Write(TCommandType::SetUniformFloat, &command, sizeof(command));
+}
+
+auto TCommandList::SetUniform(
+    const int32_t location,
+    const glm::vec4& value) -> void {
+
+    const auto command = TSetUniformCommand<glm::vec4>{.Location = location, .Value = value};
+    Write(TCommandType::SetUniformVec4, &command, sizeof(command));
+}
+
+auto TCommandList::SetUniform(
+    const int32_t location,
+    const glm::mat4& value) -> void {
+
+    const auto command = TSetUniformCommand<glm::mat4>{.Location = location, .Value = value};
+    Write(TCommandType::SetUniformMat4, &command, sizeof(command));
+}
+
+auto TCommandList::DrawArrays(
+    const int32_t vertexOffset,
+    const size_t vertexCount) -> void {
+
+    const auto command = TDrawArraysCommand{.VertexOffset = vertexOffset, .VertexCount = vertexCount};
+    Write(TCommandType::DrawArrays, &command, sizeof(command));
+}
+
+auto TCommandList::MultiDrawElementsIndirect(
+    const uint32_t indexBuffer,
+    const uint32_t indirectBuffer,
+    const size_t indirectBufferOffset,
+    const size_t drawCount) -> void {
+
+    const auto command = TMultiDrawElementsIndirectCommand{
+        .IndexBuffer = indexBuffer,
+        .IndirectBuffer = indirectBuffer,
+        .IndirectBufferOffset = indirectBufferOffset,
+        .CountBuffer = 0,
+        .CountBufferOffset = 0,
+        .DrawCount = drawCount,
+    };
+    Write(TCommandType::MultiDrawElementsIndirect, &command, sizeof(command));
+}
+
+auto TCommandList::MultiDrawElementsIndirectCount(
+    const uint32_t indexBuffer,
+    const uint32_t indirectBuffer,
+    const size_t indirectBufferOffset,
+    const uint32_t countBuffer,
+    const size_t countBufferOffset,
+    const size_t maxDrawCount) -> void {
+
+    const auto command = TMultiDrawElementsIndirectCommand{
+        .IndexBuffer = indexBuffer,
+        .IndirectBuffer = indirectBuffer,
+        .IndirectBufferOffset = indirectBufferOffset,
+        .CountBuffer = countBuffer,
+        .CountBufferOffset = countBufferOffset,
+        .DrawCount = maxDrawCount,
+    };
+    Write(TCommandType::MultiDrawElementsIndirectCount, &command, sizeof(command));
+}
+
+auto TCommandList::Dispatch(
+    const int32_t workGroupSizeX,
+    const int32_t workGroupSizeY,
+    const int32_t workGroupSizeZ) -> void {
+
+    const auto command = TDispatchCommand{
+        .WorkGroupSizeX = workGroupSizeX,
+        .WorkGroupSizeY = workGroupSizeY,
+        .WorkGroupSizeZ = workGroupSizeZ,
+    };
+    Write(TCommandType::Dispatch, &command, sizeof(command));
+}
+
+auto TCommandList::InsertMemoryBarrier(const TMemoryBarrierMask memoryBarrierMask) -> void {
+
+    const auto command = TInsertMemoryBarrierCommand{.MemoryBarrierMask = memoryBarrierMask};
+    Write(TCommandType::InsertMemoryBarrier, &command, sizeof(command));
+}
+
+auto TCommandList::PushDebugGroup(const std::string_view label) -> void {
+
+    const auto command = TPushDebugGroupCommand{.Label = label.data(), .LabelLength = label.size()};
+    Write(TCommandType::PushDebugGroup, &command, sizeof(command));
+}
+
+auto TCommandList::PopDebugGroup() -> void {
+
+    Write(TCommandType::PopDebugGroup, nullptr, 0);
+}
+
+auto SubmitCommandList(const TCommandList& commandList) -> void {
+
+    PROFILER_ZONESCOPEDN("Submit CommandList");
+
+    // draws and dispatches go to whatever pipeline the list bound last
+    TPipeline* pipeline = nullptr;
+
+    const auto* cursor = commandList.Data.data();
+    const auto* end = cursor + commandList.Data.size();
+    while (cursor < end) {
+        const auto commandType = ReadCommand<TCommandType>(cursor);
+        switch (commandType) {
+            case TCommandType::BindPipeline: {
+                pipeline = ReadCommand<TBindPipelineCommand>(cursor).Pipeline;
+                pipeline->Bind();
+                break;
+            }
+            case TCommandType::BindFramebuffer: {
+                BindFramebuffer(*ReadCommand<TBindFramebufferCommand>(cursor).Framebuffer);
+                break;
+            }
+            case TCommandType::BindUniformBuffer: {
+                const auto command = ReadCommand<TBindBufferCommand>(cursor);
+                if (command.Size > 0) {
+                    pipeline->BindBufferAsUniformBuffer(command.Buffer, command.BindingIndex, command.Offset, command.Size);
+                } else {
+                    pipeline->BindBufferAsUniformBuffer(command.Buffer, command.BindingIndex);
+                }
+                break;
+            }
+            case TCommandType::BindShaderStorageBuffer: {
+                const auto command = ReadCommand<TBindBufferCommand>(cursor);
+                if (command.Size > 0) {
+                    pipeline->BindBufferAsShaderStorageBuffer(command.Buffer, command.BindingIndex, command.Offset, command.Size);
+                } else {
+                    pipeline->BindBufferAsShaderStorageBuffer(command.Buffer, command.BindingIndex);
+                }
+                break;
+            }
+            case TCommandType::BindTexture: {
+                const auto command = ReadCommand<TBindTextureCommand>(cursor);
+                pipeline->BindTexture(command.BindingIndex, command.Texture);
+                break;
+            }
+            case TCommandType::BindTextureAndSampler: {
+                const auto command = ReadCommand<TBindTextureCommand>(cursor);
+                pipeline->BindTextureAndSampler(command.BindingIndex, command.Texture, command.Sampler);
+                break;
+            }
+            case TCommandType::SetUniformInt: {
+                const auto command = ReadCommand<TSetUniformCommand<int32_t>>(cursor);
+                pipeline->SetUniform(command.Location, command.Value);
+                break;
+            }
+            case TCommandType::SetUniformUInt: {
+                const auto command = ReadCommand<TSetUniformCommand<uint32_t>>(cursor);
+                pipeline->SetUniform(command.Location, command.Value);
+                break;
+            }
+            case TCommandType::SetUniformFloat: {
+                const auto command = ReadCommand<TSetUniformCommand<float>>(cursor);
+                pipeline->SetUniform(command.Location, command.Value);
+                break;
+            }
+            case TCommandType::SetUniformVec4: {
+                const auto command = ReadCommand<TSetUniformCommand<glm::vec4>>(cursor);
+                pipeline->SetUniform(command.Location, command.Value);
+                break;
+            }
+            case TCommandType::SetUniformMat4: {
+                const auto command = ReadCommand<TSetUniformCommand<glm::mat4>>(cursor);
+                pipeline->SetUniform(command.Location, command.Value);
+                break;
+            }
+            case TCommandType::DrawArrays: {
+                const auto command = ReadCommand<TDrawArraysCommand>(cursor);
+                static_cast<TGraphicsPipeline*>(pipeline)->DrawArrays(command.VertexOffset, command.VertexCount);
+                break;
+            }
+            case TCommandType::MultiDrawElementsIndirect: {
+                const auto command = ReadCommand<TMultiDrawElementsIndirectCommand>(cursor);
+                static_cast<TGraphicsPipeline*>(pipeline)->MultiDrawElementsIndirect(
+                    command.IndexBuffer,
+                    command.IndirectBuffer,
+                    command.IndirectBufferOffset,
+                    command.DrawCount);
+                break;
+            }
+            case TCommandType::MultiDrawElementsIndirectCount: {
+                const auto command = ReadCommand<TMultiDrawElementsIndirectCommand>(cursor);
+                static_cast<TGraphicsPipeline*>(pipeline)->MultiDrawElementsIndirectCount(
+                    command.IndexBuffer,
+                    command.IndirectBuffer,
+                    command.IndirectBufferOffset,
+                    command.CountBuffer,
+                    command.CountBufferOffset,
+                    command.DrawCount);
+                break;
+            }
+            case TCommandType::Dispatch: {
+                const auto command = ReadCommand<TDispatchCommand>(cursor);
+                static_cast<TComputePipeline*>(pipeline)->Dispatch(command.WorkGroupSizeX, command.WorkGroupSizeY, command.WorkGroupSizeZ);
+                break;
+            }
+            case TCommandType::InsertMemoryBarrier: {
+                pipeline->InsertMemoryBarrier(ReadCommand<TInsertMemoryBarrierCommand>(cursor).MemoryBarrierMask);
+                break;
+            }
+            case TCommandType::PushDebugGroup: {
+                const auto command = ReadCommand<TPushDebugGroupCommand>(cursor);
+                ::PushDebugGroup(std::string_view{command.Label, command.LabelLength});
+                break;
+            }
+            case TCommandType::PopDebugGroup: {
+                ::PopDebugGroup();
+                break;
+            }
+        }
+    }
+}
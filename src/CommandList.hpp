@@ -0,0 +1,107 @@
+#pragma once
+
+#include "RHI.hpp"
+
+#include <string_view>
+#include <vector>
+
+constexpr auto COMMAND_LIST_INITIAL_CAPACITY = 64u * 1024u;
+
+enum class TCommandType : uint8_t {
+    BindPipeline,
+    BindFramebuffer,
+    BindUniformBuffer,
+    BindShaderStorageBuffer,
+    BindTexture,
+    BindTextureAndSampler,
+    SetUniformInt,
+    SetUniformUInt,
+    SetUniformFloat,
+    SetUniformVec4,
+    SetUniformMat4,
+    DrawArrays,
+    MultiDrawElementsIndirect,
+    MultiDrawElementsIndirectCount,
+    Dispatch,
+    InsertMemoryBarrier,
+    PushDebugGroup,
+    PopDebugGroup,
+};
+
+// records rhi calls into a flat byte stream without touching gl, so lists can be filled on any thread
+// and replayed in order by SubmitCommandList on the thread owning the context. the stream keeps its
+// capacity across Reset, recording does not allocate once a list has seen its largest frame.
+// pipelines, framebuffers and debug group labels are referenced, not copied, and have to outlive the list
+struct TCommandList {
+    TCommandList();
+
+    auto Reset() -> void;
+
+    auto BindPipeline(TGraphicsPipeline& pipeline) -> void;
+    auto BindPipeline(TComputePipeline& pipeline) -> void;
+    auto BindFramebuffer(const TFramebuffer& framebuffer) -> void;
+    auto BindBufferAsUniformBuffer(
+        uint32_t buffer,
+        uint32_t bindingIndex,
+        int64_t offset = 0,
+        int64_t size = 0) -> void;
+    auto BindBufferAsShaderStorageBuffer(
+        uint32_t buffer,
+        uint32_t bindingIndex,
+        int64_t offset = 0,
+        int64_t size = 0) -> void;
+    auto BindTexture(
+        uint32_t bindingIndex,
+        uint32_t texture) -> void;
+    auto BindTextureAndSampler(
+        uint32_t bindingIndex,
+        uint32_t texture,
+        uint32_t sampler) -> void;
+
+    auto SetUniform(int32_t location, int32_t value) -> void;
+    auto SetUniform(int32_t location, uint32_t value) -> void;
+    auto SetUniform(int32_t location, float value) -> void;
+    auto SetUniform(int32_t location, const glm::vec4& value) -> void;
+    auto SetUniform(int32_t location, const glm::mat4& value) -> void;
+
+    auto DrawArrays(
+        int32_t vertexOffset,
+        size_t vertexCount) -> void;
+    auto MultiDrawElementsIndirect(
+        uint32_t indexBuffer,
+        uint32_t indirectBuffer,
+        size_t indirectBufferOffset,
+        size_t drawCount) -> void;
+    auto MultiDrawElementsIndirectCount(
+        uint32_t indexBuffer,
+        uint32_t indirectBuffer,
+        size_t indirectBufferOffset,
+        uint32_t countBuffer,
+        size_t countBufferOffset,
+        size_t maxDrawCount) -> void;
+    auto Dispatch(
+        int32_t workGroupSizeX,
+        int32_t workGroupSizeY,
+        int32_t workGroupSizeZ) -> void;
+    auto InsertMemoryBarrier(TMemoryBarrierMask memoryBarrierMask) -> void;
+
+    auto PushDebugGroup(std::string_view label) -> void;
+    auto PopDebugGroup() -> void;
+
+    auto GetCommandCount() const -> uint32_t { return CommandCount; }
+    auto GetSizeInBytes() const -> std::size_t { return Data.size(); }
+
+private:
+    friend auto SubmitCommandList(const TCommandList& commandList) -> void;
+
+    auto Write(
+        TCommandType commandType,
+        const void* payload,
+        std::size_t payloadSize) -> void;
+
+    std::vector<uint8_t> Data;
+    uint32_t CommandCount = 0;
+};
+
+// replays the recorded calls through the rhi, must be called on the thread owning the gl context
+auto SubmitCommandList(const TCommandList& commandList) -> void;
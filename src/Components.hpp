@@ -52,23 +52,25 @@ struct TComponentRenderTransform : public glm::mat4x4 {
     TComponentRenderTransform(glm::mat4x4&& m) : glm::mat4x4(std::move(m)) {}
 };
 
-struct TComponentMesh {
-    std::string Mesh;
+// tag, set by TScene::UpdateTransforms when the render transform changed, Renderer::ExtractSnapshot clears it
+struct TComponentRenderTransformDirty {
 };
 
-struct TComponentMaterial {
-    std::string Material;
+// registry context, raised whenever an entity gains or loses a component renderables are made of
+struct TRenderablesChanged {
+    bool IsChanged = true;
 };
 
-struct TComponentCreateGpuResourcesNecessary {
+struct TComponentMesh {
+    std::string Mesh;
 };
 
-struct TComponentGpuMesh {
-    std::string GpuMesh;
+struct TComponentMaterial {
+    std::string Material;
 };
 
-struct TComponentGpuMaterial {
-    std::string GpuMaterial;
+// large closed meshes rasterized into the cpu occlusion buffer, see OcclusionCulling.hpp
+struct TComponentOccluder {
 };
 
 struct TComponentPlanet {
@@ -95,4 +97,20 @@ struct TComponentGlobalLight {
     bool IsDebugEnabled = true;
 };
 
+// lights nothing beyond Radius, binned into the light clusters like every local light, see LightClusters.cs.glsl
+struct TComponentPointLight {
+    glm::vec3 Color = {1.0f, 1.0f, 1.0f};
+    float Intensity = 1.0f;
+    float Radius = 10.0f;
+};
+
+// shines down the entity's -z axis, cone angles are half angles in radians
+struct TComponentSpotLight {
+    glm::vec3 Color = {1.0f, 1.0f, 1.0f};
+    float Intensity = 1.0f;
+    float Radius = 10.0f;
+    float InnerConeAngle = 0.35f;
+    float OuterConeAngle = 0.5f;
+};
+
 auto EntityChangeParent(entt::registry& registry, entt::entity entity, entt::entity parent) -> void;
@@ -0,0 +1,36 @@
+#include "Culling.hpp"
+
+#include <glm/geometric.hpp>
+
+auto CreateFrustum(const glm::mat4& viewProjection) -> TFrustum {
+
+    const auto row = [&](const int32_t index) -> glm::vec4 {
+        return glm::vec4{viewProjection[0][index], viewProjection[1][index], viewProjection[2][index], viewProjection[3][index]};
+    };
+
+    const auto row0 = row(0);
+    const auto row1 = row(1);
+    const auto row2 = row(2);
+    const auto row3 = row(3);
+
+    // clip space depth is [0, 1] (GLM_FORCE_DEPTH_ZERO_TO_ONE), hence near is just row2
+    TFrustum frustum = {};
+    frustum.Planes = {
+        row3 + row0,
+        row3 - row0,
+        row3 + row1,
+        row3 - row1,
+        row2,
+        row3 - row2,
+    };
+
+    for (auto& plane : frustum.Planes) {
+        const auto length = glm::length(glm::vec3(plane));
+        // infinite projections degenerate the far plane, let it accept everything
+        plane = length > 1e-6f
+            ? plane / length
+            : glm::vec4{0.0f, 0.0f, 0.0f, 1.0f};
+    }
+
+    return frustum;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+
+struct TFrustum {
+    std::array<glm::vec4, 6> Planes = {}; // xyz = normal pointing inwards, w = distance
+};
+
+auto CreateFrustum(const glm::mat4& viewProjection) -> TFrustum;
@@ -0,0 +1,76 @@
+#include "GameThread.hpp"
+#include "Scene.hpp"
+
+auto TGameThread::Start(TScene& scene) -> void {
+
+    _scene = &scene;
+    _isStopRequested = false;
+    _thread = std::jthread([this] { Run(); });
+}
+
+auto TGameThread::Stop() -> void {
+
+    if (!_thread.joinable()) {
+        return;
+    }
+
+    if (_isBusy) {
+        Wait();
+    }
+
+    _isStopRequested = true;
+    _kickSemaphore.release();
+    _thread.join();
+    _scene = nullptr;
+}
+
+auto TGameThread::Kick(
+    const Renderer::TRenderContext& renderContext,
+    const TControlState& controlState,
+    const double inputTimeInSeconds) -> void {
+
+    assert(!_isBusy);
+
+    // the game thread is idle between Wait and Kick, plain members are enough to pass the frame over
+    _renderContext = renderContext;
+    _controlState = controlState;
+    _inputTimeInSeconds = inputTimeInSeconds;
+    _isBusy = true;
+    _kickSemaphore.release();
+}
+
+auto TGameThread::Wait() -> const Renderer::TRenderSnapshot& {
+
+    assert(_isBusy);
+
+    PROFILER_ZONESCOPEDN("Wait For Game Thread");
+
+    _doneSemaphore.acquire();
+    _isBusy = false;
+
+    const auto& snapshot = _snapshots[_writeIndex];
+    _writeIndex ^= 1;
+    return snapshot;
+}
+
+auto TGameThread::Run() -> void {
+
+    while (true) {
+        _kickSemaphore.acquire();
+        if (_isStopRequested) {
+            break;
+        }
+
+        PROFILER_ZONESCOPEDN("Game Frame");
+
+        auto& registry = _scene->GetRegistry();
+        _scene->Update(_renderContext, registry, _controlState);
+
+        auto& snapshot = _snapshots[_writeIndex];
+        Renderer::ExtractSnapshot(registry, snapshot);
+        snapshot.FrameIndex = _frameIndex++;
+        snapshot.InputTimeInSeconds = _inputTimeInSeconds;
+
+        _doneSemaphore.release();
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Renderer.hpp"
+#include "Controls.hpp"
+
+#include <array>
+#include <atomic>
+#include <semaphore>
+#include <thread>
+
+class TScene;
+
+// runs the scene update and the snapshot extraction of frame N + 1 while the main thread, which owns
+// the window and the gl context, renders frame N. snapshots are double buffered, the game thread fills
+// one while the renderer reads the other, so at most one simulated frame is waiting to be drawn
+class TGameThread {
+public:
+    TGameThread() = default;
+    ~TGameThread() = default;
+
+    auto Start(TScene& scene) -> void;
+    auto Stop() -> void;
+
+    // hands the input of the next frame over and returns right away
+    auto Kick(
+        const Renderer::TRenderContext& renderContext,
+        const TControlState& controlState,
+        double inputTimeInSeconds) -> void;
+    // blocks until the kicked frame is simulated, the snapshot stays untouched until the next Wait
+    auto Wait() -> const Renderer::TRenderSnapshot&;
+
+    auto IsBusy() const -> bool { return _isBusy; }
+
+private:
+    auto Run() -> void;
+
+    TScene* _scene = nullptr;
+    std::jthread _thread;
+    std::binary_semaphore _kickSemaphore{0};
+    std::binary_semaphore _doneSemaphore{0};
+    std::atomic<bool> _isStopRequested = false;
+    bool _isBusy = false;
+
+    Renderer::TRenderContext _renderContext = {};
+    TControlState _controlState = {};
+    double _inputTimeInSeconds = 0.0;
+    uint64_t _frameIndex = 0;
+
+    std::array<Renderer::TRenderSnapshot, 2> _snapshots = {};
+    uint32_t _writeIndex = 0;
+};
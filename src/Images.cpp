@@ -3,6 +3,10 @@
 #include "Profiler.hpp"
 #include "Io.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
@@ -41,6 +45,90 @@ auto Image::LoadImageFromFile(
     return LoadImageFromMemory(imageData.get(), imageDataSize, width, height, components);
 }
 
+namespace {
+
+auto GetSrgbToLinearTable() -> const std::array<float, 256>& {
+
+    static const auto table = [] {
+        std::array<float, 256> srgbToLinear = {};
+        for (auto i = 0u; i < srgbToLinear.size(); i++) {
+            const auto value = static_cast<float>(i) / 255.0f;
+            srgbToLinear[i] = value <= 0.04045f
+                ? value / 12.92f
+                : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        }
+        return srgbToLinear;
+    }();
+
+    return table;
+}
+
+auto LinearToSrgb(const float value) -> std::byte {
+
+    const auto srgb = value <= 0.0031308f
+        ? value * 12.92f
+        : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    return static_cast<std::byte>(std::clamp(srgb * 255.0f + 0.5f, 0.0f, 255.0f));
+}
+
+}
+
+auto Image::ResampleRgba8(
+    const std::span<const std::byte> source,
+    const uint32_t sourceWidth,
+    const uint32_t sourceHeight,
+    const uint32_t width,
+    const uint32_t height,
+    const bool isSrgb) -> std::vector<std::byte> {
+
+    std::vector<std::byte> destination(static_cast<std::size_t>(width) * height * 4);
+    if (width == sourceWidth && height == sourceHeight) {
+        std::memcpy(destination.data(), source.data(), destination.size());
+        return destination;
+    }
+
+    const auto& srgbToLinear = GetSrgbToLinearTable();
+    const auto footprintX = static_cast<float>(sourceWidth) / static_cast<float>(width);
+    const auto footprintY = static_cast<float>(sourceHeight) / static_cast<float>(height);
+    const auto samplesX = std::clamp(static_cast<uint32_t>(std::ceil(footprintX)), 1u, 4u);
+    const auto samplesY = std::clamp(static_cast<uint32_t>(std::ceil(footprintY)), 1u, 4u);
+    const auto sampleWeight = 1.0f / static_cast<float>(samplesX * samplesY);
+
+    for (auto y = 0u; y < height; y++) {
+        for (auto x = 0u; x < width; x++) {
+            std::array<float, 4> sum = {};
+            for (auto sampleY = 0u; sampleY < samplesY; sampleY++) {
+                const auto sourceY = std::min(
+                    static_cast<uint32_t>((static_cast<float>(y) + (static_cast<float>(sampleY) + 0.5f) / static_cast<float>(samplesY)) * footprintY),
+                    sourceHeight - 1);
+                for (auto sampleX = 0u; sampleX < samplesX; sampleX++) {
+                    const auto sourceX = std::min(
+                        static_cast<uint32_t>((static_cast<float>(x) + (static_cast<float>(sampleX) + 0.5f) / static_cast<float>(samplesX)) * footprintX),
+                        sourceWidth - 1);
+                    const auto* texel = &source[(static_cast<std::size_t>(sourceY) * sourceWidth + sourceX) * 4];
+                    for (auto component = 0u; component < 3u; component++) {
+                        const auto value = std::to_integer<uint32_t>(texel[component]);
+                        sum[component] += isSrgb ? srgbToLinear[value] : static_cast<float>(value) / 255.0f;
+                    }
+                    sum[3] += std::to_integer<uint32_t>(texel[3]) / 255.0f;
+                }
+            }
+
+            auto* texel = &destination[(static_cast<std::size_t>(y) * width + x) * 4];
+            for (auto component = 0u; component < 3u; component++) {
+                const auto value = sum[component] * sampleWeight;
+                texel[component] = isSrgb
+                    ? LinearToSrgb(value)
+                    : static_cast<std::byte>(std::clamp(value * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+            texel[3] = static_cast<std::byte>(std::clamp(sum[3] * sampleWeight * 255.0f + 0.5f, 0.0f, 255.0f));
+        }
+    }
+
+    return destination;
+}
+
+
 auto Image::EnableFlipImageVertically() -> void {
     stbi_set_flip_vertically_on_load(1);
 }
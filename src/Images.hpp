@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 namespace Image {
 
     auto FreeImage(void* pixels) -> void;
@@ -17,6 +19,17 @@ namespace Image {
         int32_t* height,
         int32_t* components) -> unsigned char*;
 
+    // box filters tightly packed rgba8 pixels into a width x height image with up to 4x4 samples per
+    // texel. halving samples each 2x2 footprint exactly, larger steps are approximate. color is averaged
+    // in linear space when isSrgb is set, alpha never is
+    auto ResampleRgba8(
+        std::span<const std::byte> source,
+        uint32_t sourceWidth,
+        uint32_t sourceHeight,
+        uint32_t width,
+        uint32_t height,
+        bool isSrgb) -> std::vector<std::byte>;
+
     auto EnableFlipImageVertically() -> void;
     auto DisableFlipImageVertically() -> void;
 
@@ -1,16 +1,19 @@
 #include "Profiler.hpp"
 #include "Scene.hpp"
+#include "GameThread.hpp"
 #include "Renderer.hpp"
 #include "WindowSettings.hpp"
 #include "Input.hpp"
 #include "Controls.hpp"
 #include "FrameTimer.hpp"
+#include "OcclusionCulling.hpp"
 
 //#include <mimalloc.h>
 
 #include <cassert>
 #include <cstdlib>
 #include <chrono>
+#include <string_view>
 #include <thread>
 
 #include <spdlog/spdlog.h>
@@ -22,6 +25,7 @@
 // - Game ---------------------------------------------------------------------
 
 TScene g_scene = {};
+TGameThread g_gameThread = {};
 
 // - Application --------------------------------------------------------------
 
@@ -157,12 +161,20 @@ auto main(
     [[maybe_unused]] char* argv[]) -> int32_t {
 
     PROFILER_ZONESCOPEDN("main");
+
+    // runs without a window or gl context, for machines without a gpu
+    if (argc > 1 && std::string_view{argv[1]} == "--benchmark-occlusion") {
+        RunOcclusionCullingBenchmark(argc > 2 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 100u);
+        return 0;
+    }
+
     auto previousTimeInSeconds = glfwGetTime();
 
     TWindowSettings windowSettings = {
         .ResolutionWidth = 1920,
         .ResolutionHeight = 1080,
         .ResolutionScale = 1.0f,
+        .TextureStreamingBudgetInMegabytes = 1024,
         .WindowStyle = TWindowStyle::Windowed,
         .IsDebug = true,
         .IsVSyncEnabled = true,
@@ -286,19 +298,18 @@ auto main(
 
     TControlState controlState = {};
 
-    while (!glfwWindowShouldClose(g_window)) {
-
-        PROFILER_ZONESCOPEDN("Frame");
-        FrameTimer::FrameStart();
-
+    // input is polled once per frame and handed to the game thread, which simulates the frame after the one being rendered
+    auto inputTimeInSeconds = 0.0;
+    const auto pollInput = [&]() {
         glfwPollEvents();
         TInputState inputState = g_inputState;
         ResetInputState();
         MapInputStateToControlState(inputState, controlState);
 
-        auto currentTimeInSeconds = glfwGetTime();
-        auto deltaTimeInSeconds = currentTimeInSeconds - previousTimeInSeconds;
+        inputTimeInSeconds = glfwGetTime();
+        auto deltaTimeInSeconds = inputTimeInSeconds - previousTimeInSeconds;
         accumulatedTimeInSeconds += deltaTimeInSeconds;
+        previousTimeInSeconds = inputTimeInSeconds;
 
         renderContext.ElapsedTime = static_cast<float>(accumulatedTimeInSeconds);
         renderContext.DeltaTimeInSeconds = static_cast<float>(deltaTimeInSeconds);
@@ -306,15 +317,39 @@ auto main(
         renderContext.FramesPerSecond1P = FrameTimer::Get1PercentLow();
         renderContext.FramesPerSecond01P = FrameTimer::Get01PercentLow();
         renderContext.AverageFramesPerSecond = FrameTimer::GetAverageFrameTime();
+    };
+
+    g_gameThread.Start(g_scene);
 
-        auto& registry = g_scene.GetRegistry();
-        g_scene.Update(renderContext, registry, controlState);
-        Renderer::Render(renderContext, registry);
+    pollInput();
+    g_gameThread.Kick(renderContext, controlState, inputTimeInSeconds);
+
+    while (!glfwWindowShouldClose(g_window)) {
+
+        PROFILER_ZONESCOPEDN("Frame");
+        FrameTimer::FrameStart();
+
+        const auto& snapshot = g_gameThread.Wait();
+        pollInput();
+
+        // the editor ui edits the registry, so the next frame is only simulated once this one is drawn
+        const auto isPipelined = !Renderer::IsEditorMode();
+        if (isPipelined) {
+            g_gameThread.Kick(renderContext, controlState, inputTimeInSeconds);
+        }
+        renderContext.PipelineDepth = isPipelined ? 1u : 0u;
+
+        Renderer::Render(renderContext, snapshot, g_scene.GetRegistry());
         {
             PROFILER_ZONESCOPEDN("SwapBuffers");
             glfwSwapBuffers(g_window);
             renderContext.FrameCounter++;
         }
+        renderContext.InputToPresentLatencyInSeconds = static_cast<float>(glfwGetTime() - snapshot.InputTimeInSeconds);
+
+        if (!isPipelined) {
+            g_gameThread.Kick(renderContext, controlState, inputTimeInSeconds);
+        }
 
         PROFILER_GPUCOLLECT
         PROFILER_FRAMEMARK
@@ -322,13 +357,13 @@ auto main(
         if (!g_windowHasFocus && g_sleepWhenWindowHasNoFocus) {
             std::this_thread::sleep_for(std::chrono::milliseconds(1000));
         }
-        previousTimeInSeconds = currentTimeInSeconds;
     }
 
     /*
      * Cleanup Resources
      */
 
+    g_gameThread.Stop();
     g_scene.Unload();
     Renderer::Unload();
 
@@ -0,0 +1,434 @@
+#include "OcclusionCulling.hpp"
+#include "Assets.hpp"
+
+#define POOLSTL_STD_SUPPLEMENT
+#include <poolstl/poolstl.hpp>
+
+#include <spdlog/spdlog.h>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <random>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#define OCCLUSION_USE_SSE
+#include <xmmintrin.h>
+#endif
+
+// tile rows rasterized by one task, every task walks all triangles so bands should not be too thin
+constexpr auto OCCLUSION_BAND_TILE_ROWS = 2u;
+
+namespace {
+
+auto ComputeTileCoverage(
+    const TOcclusionTriangle& triangle,
+    const uint32_t tileX,
+    const uint32_t tileY) -> uint32_t {
+
+    uint32_t coverage = 0;
+
+#ifdef OCCLUSION_USE_SSE
+    const auto pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const auto zero = _mm_setzero_ps();
+    std::array<__m128, 3> edgeX;
+    for (auto edgeIndex = 0; edgeIndex < 3; ++edgeIndex) {
+        edgeX[edgeIndex] = _mm_set1_ps(triangle.Edges[edgeIndex].x);
+    }
+
+    for (auto row = 0u; row < OCCLUSION_TILE_HEIGHT; ++row) {
+        const auto pixelY = static_cast<float>(tileY * OCCLUSION_TILE_HEIGHT + row) + 0.5f;
+        for (auto half = 0u; half < 2u; ++half) {
+            const auto pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(tileX * OCCLUSION_TILE_WIDTH + half * 4u)), pixelOffsets);
+
+            auto inside = _mm_cmpeq_ps(zero, zero);
+            for (auto edgeIndex = 0; edgeIndex < 3; ++edgeIndex) {
+                const auto& edge = triangle.Edges[edgeIndex];
+                const auto value = _mm_add_ps(_mm_mul_ps(edgeX[edgeIndex], pixelX), _mm_set1_ps(edge.y * pixelY + edge.z));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(value, zero));
+            }
+
+            coverage |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << (row * OCCLUSION_TILE_WIDTH + half * 4u);
+        }
+    }
+#else
+    for (auto row = 0u; row < OCCLUSION_TILE_HEIGHT; ++row) {
+        const auto pixelY = static_cast<float>(tileY * OCCLUSION_TILE_HEIGHT + row) + 0.5f;
+        for (auto column = 0u; column < OCCLUSION_TILE_WIDTH; ++column) {
+            const auto pixelX = static_cast<float>(tileX * OCCLUSION_TILE_WIDTH + column) + 0.5f;
+
+            auto isInside = true;
+            for (const auto& edge : triangle.Edges) {
+                isInside &= edge.x * pixelX + edge.y * pixelY + edge.z >= 0.0f;
+            }
+
+            if (isInside) {
+                coverage |= 1u << (row * OCCLUSION_TILE_WIDTH + column);
+            }
+        }
+    }
+#endif
+
+    return coverage;
+}
+
+auto UpdateTile(
+    TOcclusionTile& tile,
+    const uint32_t coverage,
+    const float triangleDepth) -> void {
+
+    if (triangleDepth >= tile.FarDepth) {
+        return;
+    }
+
+    if (coverage == OCCLUSION_TILE_FULL_MASK) {
+        tile.FarDepth = triangleDepth;
+        if (tile.MaskDepth >= tile.FarDepth) {
+            tile.Mask = 0;
+        }
+        return;
+    }
+
+    const auto mergedMask = tile.Mask | coverage;
+    const auto mergedDepth = tile.Mask == 0
+        ? triangleDepth
+        : std::max(tile.MaskDepth, triangleDepth);
+
+    if (mergedMask == OCCLUSION_TILE_FULL_MASK) {
+        tile.FarDepth = mergedDepth;
+        tile.Mask = 0;
+        return;
+    }
+
+    // merging would push the working layer most of the way back to the far layer, start over from the triangle instead
+    if (tile.Mask != 0 && mergedDepth - tile.MaskDepth > tile.FarDepth - mergedDepth) {
+        tile.Mask = coverage;
+        tile.MaskDepth = triangleDepth;
+        return;
+    }
+
+    tile.Mask = mergedMask;
+    tile.MaskDepth = mergedDepth;
+}
+
+}
+
+auto TMaskedOcclusionBuffer::Initialize(
+    const uint32_t width,
+    const uint32_t height) -> void {
+
+    TileCountX = std::max(1u, (width + OCCLUSION_TILE_WIDTH - 1) / OCCLUSION_TILE_WIDTH);
+    TileCountY = std::max(1u, (height + OCCLUSION_TILE_HEIGHT - 1) / OCCLUSION_TILE_HEIGHT);
+    Width = TileCountX * OCCLUSION_TILE_WIDTH;
+    Height = TileCountY * OCCLUSION_TILE_HEIGHT;
+    Tiles.resize(TileCountX * TileCountY);
+    Clear();
+}
+
+auto TMaskedOcclusionBuffer::Clear() -> void {
+    std::fill(Tiles.begin(), Tiles.end(), TOcclusionTile{});
+    Statistics = {};
+}
+
+auto TMaskedOcclusionBuffer::RenderOccluders(
+    const glm::mat4& viewProjection,
+    const std::span<const TOccluder> occluders) -> void {
+
+    PROFILER_ZONESCOPEDN("RenderOccluders");
+
+    ViewProjection = viewProjection;
+    Clear();
+    Statistics.OccluderCount = static_cast<uint32_t>(occluders.size());
+
+    OccluderTriangles.resize(occluders.size());
+
+    const auto screenSize = glm::vec2{static_cast<float>(Width), static_cast<float>(Height)};
+    std::for_each(poolstl::execution::par, OccluderTriangles.begin(), OccluderTriangles.end(), [&](std::vector<TOcclusionTriangle>& triangles) {
+
+        PROFILER_ZONESCOPEDN("SetupOccluderTriangles");
+
+        const auto occluderIndex = static_cast<std::size_t>(&triangles - OccluderTriangles.data());
+        const auto& occluder = occluders[occluderIndex];
+        const auto worldViewProjection = viewProjection * occluder.WorldMatrix;
+
+        triangles.clear();
+        for (std::size_t index = 0; index + 2 < occluder.Indices.size(); index += 3) {
+
+            std::array<glm::vec3, 3> screenPositions = {};
+            auto isClipped = false;
+            for (auto vertex = 0; vertex < 3; ++vertex) {
+                const auto clipPosition = worldViewProjection * glm::vec4{occluder.Positions[occluder.Indices[index + vertex]], 1.0f};
+                // there is no near plane clipping, dropping the triangle only loses occlusion
+                if (clipPosition.w <= 0.0f || clipPosition.z < 0.0f) {
+                    isClipped = true;
+                    break;
+                }
+
+                const auto ndcPosition = glm::vec3{clipPosition} / clipPosition.w;
+                screenPositions[vertex] = glm::vec3{(glm::vec2{ndcPosition} * 0.5f + 0.5f) * screenSize, ndcPosition.z};
+            }
+
+            if (isClipped) {
+                continue;
+            }
+
+            const auto delta1 = screenPositions[1] - screenPositions[0];
+            const auto delta2 = screenPositions[2] - screenPositions[0];
+            const auto area = delta1.x * delta2.y - delta1.y * delta2.x;
+            // counter clockwise is front facing, same as the rasterizer state of the renderer
+            if (area <= 0.0f) {
+                continue;
+            }
+
+            const auto min = glm::min(screenPositions[0], glm::min(screenPositions[1], screenPositions[2]));
+            const auto max = glm::max(screenPositions[0], glm::max(screenPositions[1], screenPositions[2]));
+            if (max.x < 0.0f || max.y < 0.0f || min.x >= screenSize.x || min.y >= screenSize.y) {
+                continue;
+            }
+
+            auto& triangle = triangles.emplace_back();
+            triangle.Min = glm::vec2{min};
+            triangle.Max = glm::vec2{max};
+            for (auto edgeIndex = 0; edgeIndex < 3; ++edgeIndex) {
+                const auto& from = screenPositions[edgeIndex];
+                const auto& to = screenPositions[(edgeIndex + 1) % 3];
+                const auto a = from.y - to.y;
+                const auto b = to.x - from.x;
+                triangle.Edges[edgeIndex] = glm::vec3{a, b, -(a * from.x + b * from.y)};
+            }
+
+            const auto depthX = (delta1.z * delta2.y - delta2.z * delta1.y) / area;
+            const auto depthY = (delta2.z * delta1.x - delta1.z * delta2.x) / area;
+            triangle.DepthPlane = glm::vec3{
+                depthX,
+                depthY,
+                screenPositions[0].z - depthX * screenPositions[0].x - depthY * screenPositions[0].y
+            };
+            triangle.MaxDepth = max.z;
+        }
+    });
+
+    for (std::size_t occluderIndex = 0; occluderIndex < occluders.size(); ++occluderIndex) {
+        Statistics.OccluderTriangleCount += static_cast<uint32_t>(occluders[occluderIndex].Indices.size() / 3);
+        Statistics.RasterizedTriangleCount += static_cast<uint32_t>(OccluderTriangles[occluderIndex].size());
+    }
+
+    const auto bandCount = (TileCountY + OCCLUSION_BAND_TILE_ROWS - 1) / OCCLUSION_BAND_TILE_ROWS;
+    const auto bandIndices = std::ranges::iota_view{0u, bandCount};
+    std::for_each(poolstl::execution::par, bandIndices.begin(), bandIndices.end(), [&](const uint32_t bandIndex) {
+        const auto firstTileRow = bandIndex * OCCLUSION_BAND_TILE_ROWS;
+        RasterizeTileRows(firstTileRow, std::min(firstTileRow + OCCLUSION_BAND_TILE_ROWS, TileCountY));
+    });
+}
+
+auto TMaskedOcclusionBuffer::RasterizeTileRows(
+    const uint32_t firstTileRow,
+    const uint32_t lastTileRow) -> void {
+
+    PROFILER_ZONESCOPEDN("RasterizeTileRows");
+
+    const auto bandMinY = static_cast<float>(firstTileRow * OCCLUSION_TILE_HEIGHT);
+    const auto bandMaxY = static_cast<float>(lastTileRow * OCCLUSION_TILE_HEIGHT);
+    const auto maxX = static_cast<float>(Width - 1);
+    const auto maxY = static_cast<float>(Height - 1);
+
+    for (const auto& triangles : OccluderTriangles) {
+        for (const auto& triangle : triangles) {
+            if (triangle.Max.y < bandMinY || triangle.Min.y >= bandMaxY) {
+                continue;
+            }
+
+            const auto tileMinX = static_cast<uint32_t>(glm::clamp(triangle.Min.x, 0.0f, maxX)) / OCCLUSION_TILE_WIDTH;
+            const auto tileMaxX = static_cast<uint32_t>(glm::clamp(triangle.Max.x, 0.0f, maxX)) / OCCLUSION_TILE_WIDTH;
+            const auto tileMinY = std::max(firstTileRow, static_cast<uint32_t>(glm::clamp(triangle.Min.y, 0.0f, maxY)) / OCCLUSION_TILE_HEIGHT);
+            const auto tileMaxY = std::min(lastTileRow - 1, static_cast<uint32_t>(glm::clamp(triangle.Max.y, 0.0f, maxY)) / OCCLUSION_TILE_HEIGHT);
+
+            for (auto tileY = tileMinY; tileY <= tileMaxY; ++tileY) {
+                for (auto tileX = tileMinX; tileX <= tileMaxX; ++tileX) {
+
+                    const auto coverage = ComputeTileCoverage(triangle, tileX, tileY);
+                    if (coverage == 0) {
+                        continue;
+                    }
+
+                    // the depth plane at the tile corners bounds the triangle's depth inside the tile
+                    const auto x0 = static_cast<float>(tileX * OCCLUSION_TILE_WIDTH);
+                    const auto y0 = static_cast<float>(tileY * OCCLUSION_TILE_HEIGHT);
+                    const auto x1 = x0 + static_cast<float>(OCCLUSION_TILE_WIDTH);
+                    const auto y1 = y0 + static_cast<float>(OCCLUSION_TILE_HEIGHT);
+                    const auto& plane = triangle.DepthPlane;
+                    const auto cornerDepth = std::max(
+                        std::max(plane.x * x0 + plane.y * y0, plane.x * x1 + plane.y * y0),
+                        std::max(plane.x * x0 + plane.y * y1, plane.x * x1 + plane.y * y1)) + plane.z;
+
+                    UpdateTile(Tiles[tileY * TileCountX + tileX], coverage, std::min(cornerDepth, triangle.MaxDepth));
+                }
+            }
+        }
+    }
+}
+
+auto TMaskedOcclusionBuffer::IsBoundingSphereVisible(const TBoundingSphere& boundingSphere) const -> bool {
+
+    if (Tiles.empty()) {
+        return true;
+    }
+
+    // conservative, the screen rectangle and nearest depth of the box around the sphere
+    const auto screenSize = glm::vec2{static_cast<float>(Width), static_cast<float>(Height)};
+    auto min = glm::vec2{std::numeric_limits<float>::max()};
+    auto max = glm::vec2{std::numeric_limits<float>::lowest()};
+    auto nearestDepth = 1.0f;
+    for (auto cornerIndex = 0; cornerIndex < 8; ++cornerIndex) {
+        const auto corner = boundingSphere.Center + boundingSphere.Radius * glm::vec3{
+            (cornerIndex & 1) != 0 ? 1.0f : -1.0f,
+            (cornerIndex & 2) != 0 ? 1.0f : -1.0f,
+            (cornerIndex & 4) != 0 ? 1.0f : -1.0f,
+        };
+        const auto clipCorner = ViewProjection * glm::vec4{corner, 1.0f};
+        if (clipCorner.w <= 0.0f || clipCorner.z < 0.0f) {
+            return true;
+        }
+
+        const auto ndcCorner = glm::vec3{clipCorner} / clipCorner.w;
+        const auto screenCorner = (glm::vec2{ndcCorner} * 0.5f + 0.5f) * screenSize;
+        min = glm::min(min, screenCorner);
+        max = glm::max(max, screenCorner);
+        nearestDepth = std::min(nearestDepth, ndcCorner.z);
+    }
+
+    // off screen is left to frustum culling
+    if (max.x < 0.0f || max.y < 0.0f || min.x >= screenSize.x || min.y >= screenSize.y) {
+        return true;
+    }
+
+    const auto pixelMinX = static_cast<uint32_t>(std::max(min.x, 0.0f));
+    const auto pixelMinY = static_cast<uint32_t>(std::max(min.y, 0.0f));
+    const auto pixelMaxX = static_cast<uint32_t>(std::min(max.x, screenSize.x - 1.0f));
+    const auto pixelMaxY = static_cast<uint32_t>(std::min(max.y, screenSize.y - 1.0f));
+
+    for (auto tileY = pixelMinY / OCCLUSION_TILE_HEIGHT; tileY <= pixelMaxY / OCCLUSION_TILE_HEIGHT; ++tileY) {
+        const auto tilePixelY = tileY * OCCLUSION_TILE_HEIGHT;
+        const auto rowMin = std::max(pixelMinY, tilePixelY) - tilePixelY;
+        const auto rowMax = std::min(pixelMaxY, tilePixelY + OCCLUSION_TILE_HEIGHT - 1) - tilePixelY;
+
+        for (auto tileX = pixelMinX / OCCLUSION_TILE_WIDTH; tileX <= pixelMaxX / OCCLUSION_TILE_WIDTH; ++tileX) {
+            const auto tilePixelX = tileX * OCCLUSION_TILE_WIDTH;
+            const auto columnMin = std::max(pixelMinX, tilePixelX) - tilePixelX;
+            const auto columnMax = std::min(pixelMaxX, tilePixelX + OCCLUSION_TILE_WIDTH - 1) - tilePixelX;
+
+            const auto rowBits = ((1u << (columnMax - columnMin + 1)) - 1u) << columnMin;
+            auto rectangleMask = 0u;
+            for (auto row = rowMin; row <= rowMax; ++row) {
+                rectangleMask |= rowBits << (row * OCCLUSION_TILE_WIDTH);
+            }
+
+            const auto& tile = Tiles[tileY * TileCountX + tileX];
+            if ((rectangleMask & ~tile.Mask) != 0 && nearestDepth < tile.FarDepth) {
+                return true;
+            }
+            if ((rectangleMask & tile.Mask) != 0 && nearestDepth < std::min(tile.MaskDepth, tile.FarDepth)) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+auto TMaskedOcclusionBuffer::TestBoundingSpheres(
+    const std::span<const TBoundingSphere> boundingSpheres,
+    const std::span<uint8_t> isVisible) -> void {
+
+    PROFILER_ZONESCOPEDN("TestBoundingSpheres");
+
+    assert(isVisible.size() >= boundingSpheres.size());
+
+    std::for_each(poolstl::execution::par, boundingSpheres.begin(), boundingSpheres.end(), [&](const TBoundingSphere& boundingSphere) {
+        const auto index = static_cast<std::size_t>(&boundingSphere - boundingSpheres.data());
+        isVisible[index] = IsBoundingSphereVisible(boundingSphere) ? 1 : 0;
+    });
+
+    Statistics.TestedCount = static_cast<uint32_t>(boundingSpheres.size());
+    Statistics.OccludedCount = static_cast<uint32_t>(std::count(isVisible.begin(), isVisible.begin() + boundingSpheres.size(), 0));
+}
+
+auto RunOcclusionCullingBenchmark(const uint32_t frameCount) -> void {
+
+    constexpr auto occludeeCount = 16384u;
+
+    const auto planet = Assets::CreateUvSpherePrimitive("Benchmark-Planet", 1.0f, 48, 96);
+    const auto hull = Assets::CreateBoxPrimitive("Benchmark-Hull", glm::vec3{1.0f}, glm::uvec3{1});
+
+    // a planet with two capital hulls and a landing pad in front of it
+    const std::array<TOccluder, 4> occluders = {
+        TOccluder{planet.Positions, planet.Indices, glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, 0.0f, -900.0f}) * glm::scale(glm::mat4{1.0f}, glm::vec3{400.0f})},
+        TOccluder{hull.Positions, hull.Indices, glm::translate(glm::mat4{1.0f}, glm::vec3{-120.0f, 20.0f, -300.0f}) * glm::scale(glm::mat4{1.0f}, glm::vec3{180.0f, 50.0f, 60.0f})},
+        TOccluder{hull.Positions, hull.Indices, glm::translate(glm::mat4{1.0f}, glm::vec3{150.0f, -30.0f, -350.0f}) * glm::scale(glm::mat4{1.0f}, glm::vec3{160.0f, 40.0f, 60.0f})},
+        TOccluder{hull.Positions, hull.Indices, glm::translate(glm::mat4{1.0f}, glm::vec3{0.0f, -40.0f, -80.0f}) * glm::scale(glm::mat4{1.0f}, glm::vec3{120.0f, 4.0f, 60.0f})},
+    };
+
+    std::mt19937 random(1337);
+    std::uniform_real_distribution<float> horizontal(-600.0f, 600.0f);
+    std::uniform_real_distribution<float> depth(-1400.0f, -50.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 8.0f);
+
+    std::vector<TBoundingSphere> occludees(occludeeCount);
+    for (auto& occludee : occludees) {
+        occludee = TBoundingSphere{
+            .Center = glm::vec3{horizontal(random), horizontal(random) * 0.5f, depth(random)},
+            .Radius = radius(random),
+        };
+    }
+    std::vector<uint8_t> isVisible(occludeeCount);
+
+    TMaskedOcclusionBuffer occlusionBuffer;
+    occlusionBuffer.Initialize(256, 128);
+
+    const auto projection = glm::infinitePerspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f);
+
+    auto totalRasterizeMilliseconds = 0.0;
+    auto totalTestMilliseconds = 0.0;
+    auto totalCullRate = 0.0;
+    for (auto frameIndex = 0u; frameIndex < frameCount; ++frameIndex) {
+
+        // sway the camera so every frame sees a different arrangement
+        const auto yaw = glm::radians(20.0f) * glm::sin(static_cast<float>(frameIndex) * 0.05f);
+        const auto view = glm::lookAt(glm::vec3{0.0f}, glm::vec3{glm::sin(yaw), 0.0f, -glm::cos(yaw)}, glm::vec3{0.0f, 1.0f, 0.0f});
+
+        const auto rasterizeStart = std::chrono::high_resolution_clock::now();
+        occlusionBuffer.RenderOccluders(projection * view, occluders);
+        const auto testStart = std::chrono::high_resolution_clock::now();
+        occlusionBuffer.TestBoundingSpheres(occludees, isVisible);
+        const auto testEnd = std::chrono::high_resolution_clock::now();
+
+        const auto rasterizeMilliseconds = std::chrono::duration<double, std::milli>(testStart - rasterizeStart).count();
+        const auto testMilliseconds = std::chrono::duration<double, std::milli>(testEnd - testStart).count();
+        const auto& statistics = occlusionBuffer.GetStatistics();
+
+        spdlog::info("Occlusion: frame {} occluders {} triangles {}/{} occluded {}/{} ({:.1f}%) rasterize {:.3f} ms test {:.3f} ms",
+            frameIndex,
+            statistics.OccluderCount,
+            statistics.RasterizedTriangleCount,
+            statistics.OccluderTriangleCount,
+            statistics.OccludedCount,
+            statistics.TestedCount,
+            statistics.GetCullRate() * 100.0f,
+            rasterizeMilliseconds,
+            testMilliseconds);
+
+        totalRasterizeMilliseconds += rasterizeMilliseconds;
+        totalTestMilliseconds += testMilliseconds;
+        totalCullRate += statistics.GetCullRate();
+    }
+
+    if (frameCount > 0) {
+        spdlog::info("Occlusion: {} frames, average rasterize {:.3f} ms test {:.3f} ms cull rate {:.1f}%",
+            frameCount,
+            totalRasterizeMilliseconds / frameCount,
+            totalTestMilliseconds / frameCount,
+            totalCullRate / frameCount * 100.0);
+    }
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "Bounds.hpp"
+
+#include <glm/mat4x4.hpp>
+
+#include <span>
+#include <vector>
+
+// each tile is 8x4 pixels, one bit per pixel in its coverage mask
+constexpr auto OCCLUSION_TILE_WIDTH = 8u;
+constexpr auto OCCLUSION_TILE_HEIGHT = 4u;
+constexpr auto OCCLUSION_TILE_FULL_MASK = 0xFFFFFFFFu;
+
+// two depth layers per tile, pixels in Mask are no farther than MaskDepth, all others no farther than FarDepth
+struct TOcclusionTile {
+    uint32_t Mask = 0;
+    float MaskDepth = 1.0f;
+    float FarDepth = 1.0f;
+};
+
+struct TOccluder {
+    std::span<const glm::vec3> Positions;
+    std::span<const uint32_t> Indices;
+    glm::mat4 WorldMatrix = glm::mat4{1.0f};
+};
+
+struct TOcclusionStatistics {
+    uint32_t OccluderCount = 0;
+    uint32_t OccluderTriangleCount = 0;
+    uint32_t RasterizedTriangleCount = 0;
+    uint32_t TestedCount = 0;
+    uint32_t OccludedCount = 0;
+
+    auto GetCullRate() const -> float {
+        return TestedCount > 0
+            ? static_cast<float>(OccludedCount) / static_cast<float>(TestedCount)
+            : 0.0f;
+    }
+};
+
+// screen space triangle, edge functions and depth plane are evaluated at pixel centers
+struct TOcclusionTriangle {
+    glm::vec2 Min;
+    glm::vec2 Max;
+    std::array<glm::vec3, 3> Edges; // x * px + y * py + z >= 0 inside
+    glm::vec3 DepthPlane; // x * px + y * py + z = depth
+    float MaxDepth;
+};
+
+// masked software occlusion buffer, large occluders are rasterized on the cpu into a low resolution
+// depth buffer so bounds can be tested without a gpu, tile rows are rasterized in parallel
+struct TMaskedOcclusionBuffer {
+    auto Initialize(
+        uint32_t width,
+        uint32_t height) -> void;
+    auto Clear() -> void;
+
+    auto RenderOccluders(
+        const glm::mat4& viewProjection,
+        std::span<const TOccluder> occluders) -> void;
+    auto IsBoundingSphereVisible(const TBoundingSphere& boundingSphere) const -> bool;
+    auto TestBoundingSpheres(
+        std::span<const TBoundingSphere> boundingSpheres,
+        std::span<uint8_t> isVisible) -> void;
+
+    auto GetWidth() const -> uint32_t { return Width; }
+    auto GetHeight() const -> uint32_t { return Height; }
+    auto GetStatistics() const -> const TOcclusionStatistics& { return Statistics; }
+
+private:
+    auto RasterizeTileRows(
+        uint32_t firstTileRow,
+        uint32_t lastTileRow) -> void;
+
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t TileCountX = 0;
+    uint32_t TileCountY = 0;
+    glm::mat4 ViewProjection = glm::mat4{1.0f};
+    std::vector<TOcclusionTile> Tiles;
+    std::vector<std::vector<TOcclusionTriangle>> OccluderTriangles;
+    TOcclusionStatistics Statistics;
+};
+
+// rasterizes a synthetic field of occluders and occludees without a window or gpu and logs timings and cull rate
+auto RunOcclusionCullingBenchmark(uint32_t frameCount) -> void;
@@ -0,0 +1,84 @@
+#include "OffsetAllocator.hpp"
+
+auto TOffsetAllocator::Initialize(const uint32_t capacity) -> void {
+
+    Capacity = capacity;
+    UsedSize = 0;
+    FreeBlocksByOffset.clear();
+    FreeBlocksBySize.clear();
+    AddFreeBlock(0, capacity);
+}
+
+auto TOffsetAllocator::Allocate(const uint32_t size) -> std::optional<TOffsetAllocation> {
+
+    if (size == 0) {
+        return TOffsetAllocation{};
+    }
+
+    const auto bestFit = FreeBlocksBySize.lower_bound(size);
+    if (bestFit == FreeBlocksBySize.end()) {
+        return std::nullopt;
+    }
+
+    const auto blockSize = bestFit->first;
+    const auto blockOffset = bestFit->second;
+    RemoveFreeBlock(FreeBlocksByOffset.find(blockOffset));
+
+    if (blockSize > size) {
+        AddFreeBlock(blockOffset + size, blockSize - size);
+    }
+
+    UsedSize += size;
+    return TOffsetAllocation{
+        .Offset = blockOffset,
+        .Size = size,
+    };
+}
+
+auto TOffsetAllocator::Free(const TOffsetAllocation& allocation) -> void {
+
+    if (allocation.Size == 0) {
+        return;
+    }
+
+    auto offset = allocation.Offset;
+    auto size = allocation.Size;
+    UsedSize -= size;
+
+    auto next = FreeBlocksByOffset.lower_bound(offset);
+    if (next != FreeBlocksByOffset.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            RemoveFreeBlock(previous);
+        }
+    }
+
+    if (next != FreeBlocksByOffset.end() && offset + size == next->first) {
+        size += next->second;
+        RemoveFreeBlock(next);
+    }
+
+    AddFreeBlock(offset, size);
+}
+
+auto TOffsetAllocator::AddFreeBlock(
+    const uint32_t offset,
+    const uint32_t size) -> void {
+
+    FreeBlocksByOffset.emplace(offset, size);
+    FreeBlocksBySize.emplace(size, offset);
+}
+
+auto TOffsetAllocator::RemoveFreeBlock(const std::map<uint32_t, uint32_t>::iterator freeBlock) -> void {
+
+    const auto [sizeBegin, sizeEnd] = FreeBlocksBySize.equal_range(freeBlock->second);
+    for (auto it = sizeBegin; it != sizeEnd; ++it) {
+        if (it->second == freeBlock->first) {
+            FreeBlocksBySize.erase(it);
+            break;
+        }
+    }
+    FreeBlocksByOffset.erase(freeBlock);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <map>
+#include <optional>
+
+struct TOffsetAllocation {
+    uint32_t Offset = 0;
+    uint32_t Size = 0;
+};
+
+// best fit free-list over a range of elements, neighbouring free blocks are merged on free
+struct TOffsetAllocator {
+    auto Initialize(uint32_t capacity) -> void;
+    auto Allocate(uint32_t size) -> std::optional<TOffsetAllocation>;
+    auto Free(const TOffsetAllocation& allocation) -> void;
+
+    auto GetCapacity() const -> uint32_t { return Capacity; }
+    auto GetUsedSize() const -> uint32_t { return UsedSize; }
+
+private:
+    auto AddFreeBlock(uint32_t offset, uint32_t size) -> void;
+    auto RemoveFreeBlock(std::map<uint32_t, uint32_t>::iterator freeBlock) -> void;
+
+    uint32_t Capacity = 0;
+    uint32_t UsedSize = 0;
+    std::map<uint32_t, uint32_t> FreeBlocksByOffset;
+    std::multimap<uint32_t, uint32_t> FreeBlocksBySize;
+};
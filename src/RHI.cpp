@@ -1,6 +1,7 @@
 #include "RHI.hpp"
 #include "Profiler.hpp"
 #include "Images.hpp"
+#include "Cache.hpp"
 
 #include <glad/gl.h>
 #include <debugbreak.h>
@@ -10,6 +11,9 @@
 #define STB_INCLUDE_LINE_GLSL
 #include <stb_include.h>
 
+#include <algorithm>
+#include <cstring>
+
 std::vector<TTexture> g_textures;
 auto g_textureCounter = TTextureId::Invalid;
 
@@ -18,11 +22,169 @@ auto g_samplerCounter = TSamplerId::Invalid;
 
 std::unordered_map<TSamplerDescriptor, TSamplerId> g_samplerDescriptors;
 
+std::unordered_map<std::string, TComputePipeline> g_computePipelines;
+
 uint32_t g_defaultInputLayout = 0;
 uint32_t g_lastIndexBuffer = 0;
 
 float g_maxTextureAnisotropy = 0.0f;
 
+constexpr auto PROGRAM_BINARY_CACHE_CATEGORY = "programs";
+// bump when the layout of cached program binaries or the way their keys are made change
+constexpr auto PROGRAM_BINARY_CACHE_VERSION = 2u;
+
+struct TProgramBinaryHeader {
+    uint64_t DriverHash = 0;
+    uint32_t BinaryFormat = 0;
+    uint32_t BinarySize = 0;
+};
+
+uint64_t g_programBinaryDriverHash = 0;
+bool g_isProgramBinaryCacheEnabled = false;
+TProgramCacheStatistics g_programCacheStatistics = {};
+
+struct TPendingShader {
+    uint32_t Shader = 0;
+    std::string_view StageName = {};
+};
+
+struct TPendingProgram {
+    std::string Label = {};
+    uint32_t Program = 0;
+    std::vector<TPendingShader> Shaders = {};
+    uint64_t CacheKey = 0;
+    bool IsCompute = false;
+};
+
+std::vector<TPendingProgram> g_pendingPrograms;
+
+constexpr auto MAX_CACHED_BINDINGS = 32u;
+
+struct TBufferRangeBinding {
+    uint32_t Buffer = 0;
+    int64_t Offset = 0;
+    int64_t Size = 0;
+
+    constexpr auto operator==(const TBufferRangeBinding& other) const -> bool = default;
+};
+
+// shadow copy of the gl state the rhi sets, an empty optional means the state is unknown and the next call is issued
+struct TStateCache {
+    std::optional<uint32_t> Program;
+    std::optional<uint32_t> VertexArray;
+    std::optional<uint32_t> DrawIndirectBuffer;
+    std::optional<uint32_t> ParameterBuffer;
+
+    std::optional<uint32_t> FillMode;
+    std::optional<bool> IsCullFaceEnabled;
+    std::optional<uint32_t> CullFace;
+    std::optional<uint32_t> FrontFace;
+    std::optional<bool> IsRasterizerDiscardEnabled;
+    std::optional<bool> IsScissorTestEnabled;
+    std::optional<bool> IsPolygonOffsetEnabled;
+    std::optional<std::pair<float, float>> PolygonOffset;
+    std::optional<float> LineWidth;
+    std::optional<float> PointSize;
+
+    std::optional<bool> IsDepthTestEnabled;
+    std::optional<uint32_t> DepthFunction;
+    std::optional<bool> IsDepthWriteEnabled;
+    std::optional<TColorMask> ColorMask;
+
+    std::array<std::optional<uint32_t>, MAX_CACHED_BINDINGS> Textures;
+    std::array<std::optional<uint32_t>, MAX_CACHED_BINDINGS> Samplers;
+    std::array<std::optional<TBufferRangeBinding>, MAX_CACHED_BINDINGS> UniformBuffers;
+    std::array<std::optional<TBufferRangeBinding>, MAX_CACHED_BINDINGS> ShaderStorageBuffers;
+} g_stateCache;
+
+#ifndef NDEBUG
+TStateCacheStatistics g_stateCacheStatistics;
+#endif
+
+template<typename T>
+auto IsStateChanged(
+    std::optional<T>& cachedValue,
+    const T& value) -> bool {
+
+    if (cachedValue == value) {
+#ifndef NDEBUG
+        g_stateCacheStatistics.SkippedCallCount++;
+#endif
+        return false;
+    }
+
+#ifndef NDEBUG
+    g_stateCacheStatistics.IssuedCallCount++;
+#endif
+    cachedValue = value;
+    return true;
+}
+
+// binding points past MAX_CACHED_BINDINGS are not tracked and always issued
+template<typename T>
+auto IsBindingChanged(
+    std::array<std::optional<T>, MAX_CACHED_BINDINGS>& cachedBindings,
+    const uint32_t bindingIndex,
+    const T& value) -> bool {
+
+    if (bindingIndex >= MAX_CACHED_BINDINGS) {
+#ifndef NDEBUG
+        g_stateCacheStatistics.IssuedCallCount++;
+#endif
+        return true;
+    }
+
+    return IsStateChanged(cachedBindings[bindingIndex], value);
+}
+
+auto SetCapability(
+    std::optional<bool>& cachedIsEnabled,
+    const uint32_t capability,
+    const bool isEnabled) -> void {
+
+    if (IsStateChanged(cachedIsEnabled, isEnabled)) {
+        if (isEnabled) {
+            glEnable(capability);
+        } else {
+            glDisable(capability);
+        }
+    }
+}
+
+auto SetDepthWriteEnabled(const bool isDepthWriteEnabled) -> void {
+
+    if (IsStateChanged(g_stateCache.IsDepthWriteEnabled, isDepthWriteEnabled)) {
+        glDepthMask(isDepthWriteEnabled ? GL_TRUE : GL_FALSE);
+    }
+}
+
+// deleted names are unbound by gl and may be handed out again, the cache must not claim they are still bound
+auto ForgetTextureBindings(const uint32_t texture) -> void {
+
+    for (auto& cachedTexture : g_stateCache.Textures) {
+        if (cachedTexture == texture) {
+            cachedTexture.reset();
+        }
+    }
+}
+
+auto ForgetBufferBindings(const uint32_t buffer) -> void {
+
+    for (auto* cachedBindings : {&g_stateCache.UniformBuffers, &g_stateCache.ShaderStorageBuffers}) {
+        for (auto& cachedBinding : *cachedBindings) {
+            if (cachedBinding.has_value() && cachedBinding->Buffer == buffer) {
+                cachedBinding.reset();
+            }
+        }
+    }
+
+    for (auto* cachedBuffer : {&g_stateCache.DrawIndirectBuffer, &g_stateCache.ParameterBuffer}) {
+        if (*cachedBuffer == buffer) {
+            cachedBuffer->reset();
+        }
+    }
+}
+
 auto OnOpenGLDebugMessage(
     [[maybe_unused]] uint32_t source,
     const uint32_t type,
@@ -754,6 +916,11 @@ auto PopDebugGroup() -> void {
     glPopDebugGroup();
 }
 
+auto InsertMemoryBarrier(const TMemoryBarrierMask memoryBarrierMask) -> void {
+
+    glMemoryBarrier(static_cast<uint32_t>(memoryBarrierMask));
+}
+
 
 auto CreateBuffer(
     const std::string_view label,
@@ -777,26 +944,132 @@ auto UpdateBuffer(
     glNamedBufferSubData(buffer, offsetInBytes, sizeInBytes, data);
 }
 
+auto ClearBuffer(
+    const uint32_t buffer,
+    const int64_t offsetInBytes,
+    const int64_t sizeInBytes) -> void {
+
+    glClearNamedBufferSubData(buffer, GL_R32UI, offsetInBytes, sizeInBytes, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+}
+
 auto DeleteBuffer(const uint32_t buffer) -> void {
 
+    ForgetBufferBindings(buffer);
+
     glDeleteBuffers(1, &buffer);
 }
 
+auto CreateRingBuffer(
+    const std::string_view label,
+    const int64_t regionSizeInBytes) -> TRingBuffer {
+
+    int32_t uniformBufferOffsetAlignment = 0;
+    int32_t shaderStorageBufferOffsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformBufferOffsetAlignment);
+    glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &shaderStorageBufferOffsetAlignment);
+
+    TRingBuffer ringBuffer = {};
+    ringBuffer.Alignment = std::max<int64_t>(std::max(uniformBufferOffsetAlignment, shaderStorageBufferOffsetAlignment), 16);
+    ringBuffer.RegionSize = (regionSizeInBytes + ringBuffer.Alignment - 1) / ringBuffer.Alignment * ringBuffer.Alignment;
+
+    constexpr auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    const auto sizeInBytes = ringBuffer.RegionSize * RING_BUFFER_FRAME_COUNT;
+    ringBuffer.Id = CreateBuffer(label, sizeInBytes, nullptr, flags);
+    ringBuffer.MappedData = static_cast<uint8_t*>(glMapNamedBufferRange(ringBuffer.Id, 0, sizeInBytes, flags));
+
+    return ringBuffer;
+}
+
+auto BeginRingBufferFrame(TRingBuffer& ringBuffer) -> void {
+
+    PROFILER_ZONESCOPEDN("BeginRingBufferFrame");
+
+    ringBuffer.RegionIndex = (ringBuffer.RegionIndex + 1) % RING_BUFFER_FRAME_COUNT;
+    ringBuffer.RegionCursor = 0;
+
+    auto& fence = ringBuffer.Fences[ringBuffer.RegionIndex];
+    if (fence == nullptr) {
+        return;
+    }
+
+    // only blocks when the cpu runs more than RING_BUFFER_FRAME_COUNT frames ahead of the gpu
+    const auto sync = static_cast<GLsync>(fence);
+    auto waitFlags = 0u;
+    while (true) {
+        const auto waitResult = glClientWaitSync(sync, waitFlags, 1'000'000);
+        if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED || waitResult == GL_WAIT_FAILED) {
+            break;
+        }
+        waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    }
+
+    glDeleteSync(sync);
+    fence = nullptr;
+}
+
+auto AllocateFromRingBuffer(
+    TRingBuffer& ringBuffer,
+    const int64_t sizeInBytes,
+    const void* data) -> TRingBufferAllocation {
+
+    const auto alignedCursor = (ringBuffer.RegionCursor + ringBuffer.Alignment - 1) / ringBuffer.Alignment * ringBuffer.Alignment;
+    if (alignedCursor + sizeInBytes > ringBuffer.RegionSize) {
+        spdlog::error("RHI: Ring buffer region of {} bytes exhausted, {} bytes requested", ringBuffer.RegionSize, sizeInBytes);
+        return {};
+    }
+
+    const auto offset = ringBuffer.RegionIndex * ringBuffer.RegionSize + alignedCursor;
+    std::memcpy(ringBuffer.MappedData + offset, data, sizeInBytes);
+    ringBuffer.RegionCursor = alignedCursor + sizeInBytes;
+
+    return TRingBufferAllocation{
+        .Buffer = ringBuffer.Id,
+        .Offset = offset,
+        .Size = sizeInBytes,
+    };
+}
+
+auto EndRingBufferFrame(TRingBuffer& ringBuffer) -> void {
+
+    ringBuffer.Fences[ringBuffer.RegionIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+auto DeleteRingBuffer(TRingBuffer& ringBuffer) -> void {
+
+    for (auto& fence : ringBuffer.Fences) {
+        if (fence != nullptr) {
+            glDeleteSync(static_cast<GLsync>(fence));
+            fence = nullptr;
+        }
+    }
+
+    glUnmapNamedBuffer(ringBuffer.Id);
+    DeleteBuffer(ringBuffer.Id);
+    ringBuffer = {};
+}
+
 auto DeletePipeline(const TPipeline& pipeline) -> void {
 
+    if (g_stateCache.Program == pipeline.Id) {
+        g_stateCache.Program.reset();
+    }
     glDeleteProgram(pipeline.Id);
 }
 
 auto TPipeline::Bind() -> void {
 
-    glUseProgram(Id);
+    if (IsStateChanged(g_stateCache.Program, Id)) {
+        glUseProgram(Id);
+    }
 }
 
 auto TPipeline::BindBufferAsUniformBuffer(
     const uint32_t buffer,
     const uint32_t bindingIndex) const -> void {
 
-    glBindBufferBase(GL_UNIFORM_BUFFER, bindingIndex, buffer);
+    if (IsBindingChanged(g_stateCache.UniformBuffers, bindingIndex, TBufferRangeBinding{.Buffer = buffer})) {
+        glBindBufferBase(GL_UNIFORM_BUFFER, bindingIndex, buffer);
+    }
 }
 
 auto TPipeline::BindBufferAsUniformBuffer(
@@ -805,14 +1078,18 @@ auto TPipeline::BindBufferAsUniformBuffer(
     const int64_t offset,
     const int64_t size) const -> void {
 
-    glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, buffer, offset, size);
+    if (IsBindingChanged(g_stateCache.UniformBuffers, bindingIndex, TBufferRangeBinding{.Buffer = buffer, .Offset = offset, .Size = size})) {
+        glBindBufferRange(GL_UNIFORM_BUFFER, bindingIndex, buffer, offset, size);
+    }
 }
 
 auto TPipeline::BindBufferAsShaderStorageBuffer(
     const uint32_t buffer,
     const uint32_t bindingIndex) const -> void {
 
-    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingIndex, buffer);
+    if (IsBindingChanged(g_stateCache.ShaderStorageBuffers, bindingIndex, TBufferRangeBinding{.Buffer = buffer})) {
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindingIndex, buffer);
+    }
 }
 
 auto TPipeline::BindBufferAsShaderStorageBuffer(
@@ -821,14 +1098,18 @@ auto TPipeline::BindBufferAsShaderStorageBuffer(
     const int64_t offset,
     const int64_t size) const -> void {
 
-    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingIndex, buffer, offset, size);
+    if (IsBindingChanged(g_stateCache.ShaderStorageBuffers, bindingIndex, TBufferRangeBinding{.Buffer = buffer, .Offset = offset, .Size = size})) {
+        glBindBufferRange(GL_SHADER_STORAGE_BUFFER, bindingIndex, buffer, offset, size);
+    }
 }
 
 auto TPipeline::BindTexture(
     const uint32_t bindingIndex,
     const uint32_t texture) const  -> void {
 
-    glBindTextureUnit(bindingIndex, texture);
+    if (IsBindingChanged(g_stateCache.Textures, bindingIndex, texture)) {
+        glBindTextureUnit(bindingIndex, texture);
+    }
 }
 
 auto TPipeline::BindTextureAndSampler(
@@ -836,8 +1117,12 @@ auto TPipeline::BindTextureAndSampler(
     const uint32_t texture,
     const uint32_t sampler) const  -> void {
 
-    glBindTextureUnit(bindingIndex, texture);
-    glBindSampler(bindingIndex, sampler);
+    if (IsBindingChanged(g_stateCache.Textures, bindingIndex, texture)) {
+        glBindTextureUnit(bindingIndex, texture);
+    }
+    if (IsBindingChanged(g_stateCache.Samplers, bindingIndex, sampler)) {
+        glBindSampler(bindingIndex, sampler);
+    }
 }
 
 auto TPipeline::BindImage(
@@ -1163,8 +1448,108 @@ auto GenerateMipmaps(const TTextureId& textureId) -> void {
     glGenerateTextureMipmap(texture.Id);
 }
 
+auto UploadFormatToComponentCount(const TUploadFormat uploadFormat) -> std::size_t {
+
+    switch (uploadFormat) {
+        case TUploadFormat::R:
+        case TUploadFormat::RInteger:
+        case TUploadFormat::Depth:
+        case TUploadFormat::StencilIndex:
+            return 1;
+        case TUploadFormat::Rg:
+        case TUploadFormat::RgInteger:
+        case TUploadFormat::DepthStencilIndex:
+            return 2;
+        case TUploadFormat::Rgb:
+        case TUploadFormat::Bgr:
+        case TUploadFormat::RgbInteger:
+        case TUploadFormat::BgrInteger:
+            return 3;
+        case TUploadFormat::Rgba:
+        case TUploadFormat::Bgra:
+        case TUploadFormat::RgbaInteger:
+        case TUploadFormat::BgraInteger:
+            return 4;
+        default:
+            std::unreachable();
+    }
+}
+
+auto UnderlyingOpenGLTypeToSizeInBytes(const uint32_t type) -> std::size_t {
+
+    switch (type) {
+        case GL_UNSIGNED_BYTE:
+        case GL_BYTE:
+            return 1;
+        case GL_UNSIGNED_SHORT:
+        case GL_SHORT:
+        case GL_HALF_FLOAT:
+            return 2;
+        case GL_UNSIGNED_INT:
+        case GL_INT:
+        case GL_FLOAT:
+            return 4;
+        default:
+            std::unreachable();
+    }
+}
+
+auto GetTextureLevelExtent(
+    const TTextureId& textureId,
+    const uint32_t level) -> TExtent3D {
+
+    const auto& texture = GetTexture(textureId);
+    const auto depth = texture.TextureType == TTextureType::TextureCube
+        ? 6u
+        : std::max(texture.Extent.Depth >> level, 1u);
+
+    return TExtent3D{
+        std::max(texture.Extent.Width >> level, 1u),
+        std::max(texture.Extent.Height >> level, 1u),
+        depth,
+    };
+}
+
+auto GetTextureLevelSizeInBytes(
+    const TTextureId& textureId,
+    const uint32_t level) -> std::size_t {
+
+    const auto& texture = GetTexture(textureId);
+    const auto levelExtent = GetTextureLevelExtent(textureId, level);
+    const auto bytesPerPixel = UploadFormatToComponentCount(FormatToUploadFormat(texture.Format)) *
+                               UnderlyingOpenGLTypeToSizeInBytes(FormatToUnderlyingOpenGLType(texture.Format));
+
+    return static_cast<std::size_t>(levelExtent.Width) * levelExtent.Height * levelExtent.Depth * bytesPerPixel;
+}
+
+auto DownloadTexture(
+    const TTextureId& textureId,
+    const uint32_t level,
+    std::span<std::byte> pixelData) -> void {
+
+    PROFILER_ZONESCOPEDN("DownloadTexture");
+    const auto& texture = GetTexture(textureId);
+
+    glGetTextureImage(texture.Id,
+                      level,
+                      UploadFormatToGL(FormatToUploadFormat(texture.Format)),
+                      FormatToUnderlyingOpenGLType(texture.Format),
+                      static_cast<int32_t>(pixelData.size()),
+                      pixelData.data());
+}
+
+auto DeleteTexture(const TTextureId& textureId) -> void {
+
+    // the slot stays taken, ids are indices into g_textures
+    auto& texture = GetTexture(textureId);
+    ForgetTextureBindings(texture.Id);
+    glDeleteTextures(1, &texture.Id);
+    texture.Id = 0;
+}
+
 auto DeleteTextures() -> void {
     for(auto& texture : g_textures) {
+        ForgetTextureBindings(texture.Id);
         glDeleteTextures(1, &texture.Id);
     }
 }
@@ -1221,25 +1606,36 @@ auto CreateFramebuffer(const TFramebufferDescriptor& framebufferDescriptor) -> T
 
     for (auto colorAttachmentIndex = 0; auto colorAttachmentDescriptorValue : framebufferDescriptor.ColorAttachments) {
         if (colorAttachmentDescriptorValue.has_value()) {
-            const auto& colorAttachmentDescriptor = *colorAttachmentDescriptorValue;
-            const auto colorAttachmentTextureId = CreateTexture({
-                .TextureType = TTextureType::Texture2D,
-                .Format = colorAttachmentDescriptor.Format,
-                .Extent = TExtent3D(colorAttachmentDescriptor.Extent.Width, colorAttachmentDescriptor.Extent.Height, 1),
-                .MipMapLevels = 1,
-                .Layers = 0,
-                .SampleCount = TSampleCount::One,
-                .Label = std::format("{}_{}x{}", colorAttachmentDescriptor.Label, colorAttachmentDescriptor.Extent.Width, colorAttachmentDescriptor.Extent.Height)
-            });
-            const auto& colorAttachmentTexture = GetTexture(colorAttachmentTextureId);
-
-            framebuffer.ColorAttachments[colorAttachmentIndex] = {
-                .Texture = colorAttachmentTexture,
-                .ClearColor = colorAttachmentDescriptor.ClearColor,
-                .LoadOperation = colorAttachmentDescriptor.LoadOperation,
-            };
+            const auto& colorAttachmentDescriptorVariant = *colorAttachmentDescriptorValue;
+            if (const auto* createColorAttachment = std::get_if<TFramebufferColorAttachmentDescriptor>(&colorAttachmentDescriptorVariant)) {
+                const auto& colorAttachmentDescriptor = *createColorAttachment;
+                const auto colorAttachmentTextureId = CreateTexture({
+                    .TextureType = TTextureType::Texture2D,
+                    .Format = colorAttachmentDescriptor.Format,
+                    .Extent = TExtent3D(colorAttachmentDescriptor.Extent.Width, colorAttachmentDescriptor.Extent.Height, 1),
+                    .MipMapLevels = 1,
+                    .Layers = 0,
+                    .SampleCount = TSampleCount::One,
+                    .Label = std::format("{}_{}x{}", colorAttachmentDescriptor.Label, colorAttachmentDescriptor.Extent.Width, colorAttachmentDescriptor.Extent.Height)
+                });
+                const auto& colorAttachmentTexture = GetTexture(colorAttachmentTextureId);
+
+                framebuffer.ColorAttachments[colorAttachmentIndex] = {
+                    .Texture = colorAttachmentTexture,
+                    .ClearColor = colorAttachmentDescriptor.ClearColor,
+                    .LoadOperation = colorAttachmentDescriptor.LoadOperation,
+                    .IsTextureOwned = true,
+                };
+            } else if (const auto* existingColorAttachment = std::get_if<TFramebufferExistingColorAttachmentDescriptor>(&colorAttachmentDescriptorVariant)) {
+                framebuffer.ColorAttachments[colorAttachmentIndex] = {
+                    .Texture = existingColorAttachment->ExistingColorTexture,
+                    .ClearColor = existingColorAttachment->ClearColor,
+                    .LoadOperation = existingColorAttachment->LoadOperation,
+                };
+            }
 
-            const auto attachmentType = FormatToAttachmentType(colorAttachmentDescriptor.Format, colorAttachmentIndex);
+            const auto& colorAttachmentTexture = framebuffer.ColorAttachments[colorAttachmentIndex]->Texture;
+            const auto attachmentType = FormatToAttachmentType(colorAttachmentTexture.Format, colorAttachmentIndex);
             glNamedFramebufferTexture(framebuffer.Id, AttachmentTypeToGL(attachmentType), colorAttachmentTexture.Id, 0);
 
             drawBuffers[colorAttachmentIndex] = AttachmentTypeToGL(attachmentType);
@@ -1278,13 +1674,15 @@ auto CreateFramebuffer(const TFramebufferDescriptor& framebufferDescriptor) -> T
                 .Texture = depthTexture,
                 .ClearDepthStencil = createDepthStencilAttachment->ClearDepthStencil,
                 .LoadOperation = createDepthStencilAttachment->LoadOperation,
+                .IsTextureOwned = true,
             };
         } else if (auto* existingDepthStencilAttachment = std::get_if<TFramebufferExistingDepthStencilAttachmentDescriptor>(&depthStencilAttachment)) {
             const auto& depthTexture = existingDepthStencilAttachment->ExistingDepthTexture;
             glNamedFramebufferTexture(framebuffer.Id, GL_DEPTH_ATTACHMENT, depthTexture.Id, 0);
             framebuffer.DepthStencilAttachment = {
                 .Texture = depthTexture,
-                .LoadOperation = TFramebufferAttachmentLoadOperation::DontCare,
+                .ClearDepthStencil = existingDepthStencilAttachment->ClearDepthStencil,
+                .LoadOperation = existingDepthStencilAttachment->LoadOperation,
             };
         }
     } else {
@@ -1310,6 +1708,7 @@ auto BindFramebuffer(const TFramebuffer& framebuffer) -> void {
             const auto& colorAttachment = *colorAttachmentValue;
             glViewportIndexedf(colorAttachmentIndex, 0, 0, colorAttachment.Texture.Extent.Width, colorAttachment.Texture.Extent.Height);
             glColorMaski(colorAttachmentIndex, true, true, true, true);
+            g_stateCache.ColorMask.reset();
             if (colorAttachment.LoadOperation == TFramebufferAttachmentLoadOperation::Clear) {
                 const auto baseTypeClass = FormatToBaseTypeClass(colorAttachment.Texture.Format);
                 switch (baseTypeClass) {
@@ -1338,7 +1737,7 @@ auto BindFramebuffer(const TFramebuffer& framebuffer) -> void {
             glViewport(0, 0, depthStencilAttachment.Texture.Extent.Width, depthStencilAttachment.Texture.Extent.Height);
         }
         if (depthStencilAttachment.LoadOperation == TFramebufferAttachmentLoadOperation::Clear) {
-            glDepthMask(GL_TRUE);
+            SetDepthWriteEnabled(true);
             glStencilMask(GL_TRUE);
             glClearNamedFramebufferfi(framebuffer.Id, GL_DEPTH_STENCIL, 0, depthStencilAttachment.ClearDepthStencil.Depth, depthStencilAttachment.ClearDepthStencil.Stencil);
         }
@@ -1350,97 +1749,183 @@ auto DeleteFramebuffer(const TFramebuffer& framebuffer) -> void {
     assert(framebuffer.Id != 0);
 
     for (auto colorAttachment : framebuffer.ColorAttachments) {
-        if (colorAttachment.has_value()) {
+        if (colorAttachment.has_value() && (*colorAttachment).IsTextureOwned) {
+            ForgetTextureBindings((*colorAttachment).Texture.Id);
             glDeleteTextures(1, &(*colorAttachment).Texture.Id);
         }
     }
 
-    if (framebuffer.DepthStencilAttachment.has_value()) {
+    if (framebuffer.DepthStencilAttachment.has_value() && (*framebuffer.DepthStencilAttachment).IsTextureOwned) {
+        ForgetTextureBindings((*framebuffer.DepthStencilAttachment).Texture.Id);
         glDeleteTextures(1, &(*framebuffer.DepthStencilAttachment).Texture.Id);
     }
 
     glDeleteFramebuffers(1, &framebuffer.Id);
 }
 
-auto CreateGraphicsProgram(
+// drivers hand out binaries only they can read back, so vendor, renderer and driver version seed every key
+auto GetProgramBinaryCacheKey(std::initializer_list<std::string_view> shaderSources) -> uint64_t {
+
+    auto hash = Cache::HashBytes(std::as_bytes(std::span(&PROGRAM_BINARY_CACHE_VERSION, 1)), g_programBinaryDriverHash);
+    for (const auto shaderSource : shaderSources) {
+        const auto shaderSourceSize = static_cast<uint64_t>(shaderSource.size());
+        hash = Cache::HashBytes(std::as_bytes(std::span(&shaderSourceSize, 1)), hash);
+        hash = Cache::HashBytes(std::as_bytes(std::span(shaderSource)), hash);
+    }
+
+    return hash;
+}
+
+auto LoadProgramBinary(
     std::string_view label,
-    const std::string_view vertexShaderFilePath,
-    const std::string_view fragmentShaderFilePath) -> std::expected<uint32_t, std::string> {
+    uint64_t cacheKey) -> std::optional<uint32_t> {
 
-    PROFILER_ZONESCOPEDN("CreateGraphicsProgram");
+    PROFILER_ZONESCOPEDN("LoadProgramBinary");
 
-    auto vertexShaderSourceResult = ReadShaderSourceFromFile(vertexShaderFilePath);
-    if (!vertexShaderSourceResult) {
-        return std::unexpected(vertexShaderSourceResult.error());
+    if (!g_isProgramBinaryCacheEnabled) {
+        return std::nullopt;
     }
 
-    auto fragmentShaderSourceResult = ReadShaderSourceFromFile(fragmentShaderFilePath);
-    if (!fragmentShaderSourceResult) {
-        return std::unexpected(fragmentShaderSourceResult.error());
+    const auto cachedProgramBinary = Cache::Load(PROGRAM_BINARY_CACHE_CATEGORY, cacheKey);
+    if (!cachedProgramBinary || (*cachedProgramBinary).size() < sizeof(TProgramBinaryHeader)) {
+        return std::nullopt;
     }
 
-    const auto vertexShaderSource = *vertexShaderSourceResult;
-    const auto fragmentShaderSource = *fragmentShaderSourceResult;
+    TProgramBinaryHeader programBinaryHeader = {};
+    std::memcpy(&programBinaryHeader, (*cachedProgramBinary).data(), sizeof(TProgramBinaryHeader));
+    if (programBinaryHeader.DriverHash != g_programBinaryDriverHash ||
+        programBinaryHeader.BinarySize != (*cachedProgramBinary).size() - sizeof(TProgramBinaryHeader)) {
+        return std::nullopt;
+    }
+
+    auto program = glCreateProgram();
+    SetDebugLabel(program, GL_PROGRAM, std::format("{}-Program", label).data());
+    glProgramBinary(program,
+                    programBinaryHeader.BinaryFormat,
+                    (*cachedProgramBinary).data() + sizeof(TProgramBinaryHeader),
+                    static_cast<int32_t>(programBinaryHeader.BinarySize));
 
-    const auto vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    SetDebugLabel(vertexShader, GL_SHADER, std::format("{}-VS", label).data());
-    const auto vertexShaderSourcePtr = vertexShaderSource.data();
-    glShaderSource(vertexShader, 1, &vertexShaderSourcePtr, nullptr);
-    glCompileShader(vertexShader);
     int32_t status = 0;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &status);
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
     if (status == GL_FALSE) {
+        glDeleteProgram(program);
+        spdlog::warn("RHI: Cached binary of program {} was rejected by the driver, compiling from source", label);
+        return std::nullopt;
+    }
 
-        int32_t infoLength = 512;
-        glGetShaderiv(vertexShader, GL_INFO_LOG_LENGTH, &infoLength);
-        auto infoLog = std::string(infoLength + 1, '\0');
-        glGetShaderInfoLog(vertexShader, infoLength, nullptr, infoLog.data());
-        glDeleteShader(vertexShader);
+    return program;
+}
 
-        return std::unexpected(std::format("Vertex shader in program {} has errors\n{}", label, infoLog));
-    }
+auto StoreProgramBinary(
+    uint32_t program,
+    uint64_t cacheKey) -> void {
 
-    const auto fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    SetDebugLabel(fragmentShader, GL_SHADER, std::format("{}-FS", label).data());
-    const auto fragmentShaderSourcePtr = fragmentShaderSource.data();
-    glShaderSource(fragmentShader, 1, &fragmentShaderSourcePtr, nullptr);
-    glCompileShader(fragmentShader);
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &status);
-    if (status == GL_FALSE) {
+    PROFILER_ZONESCOPEDN("StoreProgramBinary");
 
-        int32_t infoLength = 512;
-        glGetShaderiv(fragmentShader, GL_INFO_LOG_LENGTH, &infoLength);
-        auto infoLog = std::string(infoLength + 1, '\0');
-        glGetShaderInfoLog(fragmentShader, infoLength, nullptr, infoLog.data());
-        glDeleteShader(fragmentShader);
+    if (!g_isProgramBinaryCacheEnabled) {
+        return;
+    }
 
-        return std::unexpected(std::format("Fragment shader in program {} has errors\n{}", label, infoLog));
+    int32_t binarySize = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binarySize);
+    if (binarySize <= 0) {
+        return;
     }
 
+    auto programBinary = std::vector<std::byte>(sizeof(TProgramBinaryHeader) + binarySize);
+    uint32_t binaryFormat = 0;
+    int32_t writtenSize = 0;
+    glGetProgramBinary(program, binarySize, &writtenSize, &binaryFormat, programBinary.data() + sizeof(TProgramBinaryHeader));
+    if (writtenSize <= 0) {
+        return;
+    }
+
+    const auto programBinaryHeader = TProgramBinaryHeader{
+        .DriverHash = g_programBinaryDriverHash,
+        .BinaryFormat = binaryFormat,
+        .BinarySize = static_cast<uint32_t>(writtenSize),
+    };
+    std::memcpy(programBinary.data(), &programBinaryHeader, sizeof(TProgramBinaryHeader));
+    programBinary.resize(sizeof(TProgramBinaryHeader) + writtenSize);
+
+    Cache::Store(PROGRAM_BINARY_CACHE_CATEGORY, cacheKey, programBinary);
+}
+
+auto SubmitShader(
+    const uint32_t shaderType,
+    const std::string_view label,
+    const std::string& shaderSource) -> uint32_t {
+
+    const auto shader = glCreateShader(shaderType);
+    SetDebugLabel(shader, GL_SHADER, label);
+    const auto shaderSourcePtr = shaderSource.data();
+    glShaderSource(shader, 1, &shaderSourcePtr, nullptr);
+    glCompileShader(shader);
+
+    return shader;
+}
+
+// compiles and links without asking for the status, drivers with parallel shader compilation keep
+// working on the program in the background until ResolvePipelines queries it
+auto SubmitProgram(
+    std::string_view label,
+    const bool isCompute,
+    std::initializer_list<TPendingShader> pendingShaders,
+    const uint64_t cacheKey) -> uint32_t {
+
     auto program = glCreateProgram();
     SetDebugLabel(program, GL_PROGRAM, std::format("{}-Program", label).data());
-    glAttachShader(program, vertexShader);
-    glAttachShader(program, fragmentShader);
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    for (const auto& pendingShader : pendingShaders) {
+        glAttachShader(program, pendingShader.Shader);
+    }
     glLinkProgram(program);
-    glGetProgramiv(program, GL_LINK_STATUS, &status);
 
-    glDetachShader(program, vertexShader);
-    glDetachShader(program, fragmentShader);
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    g_pendingPrograms.push_back(TPendingProgram{
+        .Label = std::string(label),
+        .Program = program,
+        .Shaders = pendingShaders,
+        .CacheKey = cacheKey,
+        .IsCompute = isCompute,
+    });
 
-    if (status == GL_FALSE) {
+    return program;
+}
 
-        int32_t infoLength = 512;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLength);
-        auto infoLog = std::string(infoLength + 1, '\0');
-        glGetProgramInfoLog(program, infoLength, nullptr, infoLog.data());
-        glDeleteProgram(program);
+auto CreateGraphicsProgram(
+    std::string_view label,
+    const std::string_view vertexShaderFilePath,
+    const std::string_view fragmentShaderFilePath) -> std::expected<uint32_t, std::string> {
+
+    PROFILER_ZONESCOPEDN("CreateGraphicsProgram");
+
+    auto vertexShaderSourceResult = ReadShaderSourceFromFile(vertexShaderFilePath);
+    if (!vertexShaderSourceResult) {
+        return std::unexpected(vertexShaderSourceResult.error());
+    }
 
-        return std::unexpected(std::format("Graphics program {} has linking errors\n{}", label, infoLog));
+    auto fragmentShaderSourceResult = ReadShaderSourceFromFile(fragmentShaderFilePath);
+    if (!fragmentShaderSourceResult) {
+        return std::unexpected(fragmentShaderSourceResult.error());
     }
 
-    return program;
+    const auto vertexShaderSource = *vertexShaderSourceResult;
+    const auto fragmentShaderSource = *fragmentShaderSourceResult;
+
+    g_programCacheStatistics.ProgramCount++;
+    const auto cacheKey = GetProgramBinaryCacheKey({vertexShaderSource, fragmentShaderSource});
+    if (const auto cachedProgram = LoadProgramBinary(label, cacheKey)) {
+        g_programCacheStatistics.CachedProgramCount++;
+        return *cachedProgram;
+    }
+
+    const auto vertexShader = SubmitShader(GL_VERTEX_SHADER, std::format("{}-VS", label), vertexShaderSource);
+    const auto fragmentShader = SubmitShader(GL_FRAGMENT_SHADER, std::format("{}-FS", label), fragmentShaderSource);
+
+    return SubmitProgram(label, false, {
+        TPendingShader{.Shader = vertexShader, .StageName = "Vertex"},
+        TPendingShader{.Shader = fragmentShader, .StageName = "Fragment"},
+    }, cacheKey);
 }
 
 auto CreateComputeProgram(
@@ -1454,45 +1939,50 @@ auto CreateComputeProgram(
         return std::unexpected(computeShaderSourceResult.error());
     }
 
-    int32_t status = 0;
+    g_programCacheStatistics.ProgramCount++;
+    const auto cacheKey = GetProgramBinaryCacheKey({*computeShaderSourceResult});
+    if (const auto cachedProgram = LoadProgramBinary(label, cacheKey)) {
+        g_programCacheStatistics.CachedProgramCount++;
+        return *cachedProgram;
+    }
 
-    const auto computeShader = glCreateShader(GL_COMPUTE_SHADER);
-    SetDebugLabel(computeShader, GL_SHADER, std::format("{}-CS", label).data());
-    const auto computeShaderSourcePtr = (*computeShaderSourceResult).data();
-    glShaderSource(computeShader, 1, &computeShaderSourcePtr, nullptr);
-    glCompileShader(computeShader);
-    glGetShaderiv(computeShader, GL_COMPILE_STATUS, &status);
-    if (status == GL_FALSE) {
+    const auto computeShader = SubmitShader(GL_COMPUTE_SHADER, std::format("{}-CS", label), *computeShaderSourceResult);
 
-        int32_t infoLength = 512;
-        glGetShaderiv(computeShader, GL_INFO_LOG_LENGTH, &infoLength);
-        auto infoLog = std::string(infoLength + 1, '\0');
-        glGetShaderInfoLog(computeShader, infoLength, nullptr, infoLog.data());
-        glDeleteShader(computeShader);
+    return SubmitProgram(label, true, {
+        TPendingShader{.Shader = computeShader, .StageName = "Compute"},
+    }, cacheKey);
+}
 
-        return std::unexpected(std::format("Compute shader in program {} has errors\n{}", label, infoLog));
-    }
+auto ResolveProgram(const TPendingProgram& pendingProgram) -> std::expected<void, std::string> {
 
-    auto program = glCreateProgram();
-    SetDebugLabel(program, GL_PROGRAM, std::format("{}-Program", label).data());
-    glAttachShader(program, computeShader);
-    glLinkProgram(program);
-    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    int32_t status = 0;
+    for (const auto& pendingShader : pendingProgram.Shaders) {
+        glGetShaderiv(pendingShader.Shader, GL_COMPILE_STATUS, &status);
+        if (status == GL_FALSE) {
 
-    glDetachShader(program, computeShader);
-    glDeleteShader(computeShader);
+            int32_t infoLength = 512;
+            glGetShaderiv(pendingShader.Shader, GL_INFO_LOG_LENGTH, &infoLength);
+            auto infoLog = std::string(infoLength + 1, '\0');
+            glGetShaderInfoLog(pendingShader.Shader, infoLength, nullptr, infoLog.data());
 
+            return std::unexpected(std::format("{} shader in program {} has errors\n{}", pendingShader.StageName, pendingProgram.Label, infoLog));
+        }
+    }
+
+    glGetProgramiv(pendingProgram.Program, GL_LINK_STATUS, &status);
     if (status == GL_FALSE) {
 
         int32_t infoLength = 512;
-        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &infoLength);
+        glGetProgramiv(pendingProgram.Program, GL_INFO_LOG_LENGTH, &infoLength);
         auto infoLog = std::string(infoLength + 1, '\0');
-        glGetProgramInfoLog(program, infoLength, nullptr, infoLog.data());
+        glGetProgramInfoLog(pendingProgram.Program, infoLength, nullptr, infoLog.data());
 
-        return std::unexpected(std::format("Compute program {} has linking errors\n{}", label, infoLog));
+        return std::unexpected(std::format("{} program {} has linking errors\n{}", pendingProgram.IsCompute ? "Compute" : "Graphics", pendingProgram.Label, infoLog));
     }
 
-    return program;
+    StoreProgramBinary(pendingProgram.Program, pendingProgram.CacheKey);
+
+    return {};
 }
 
 auto FillModeToGL(const TFillMode fillMode) -> uint32_t {
@@ -1542,9 +2032,11 @@ auto CreateGraphicsPipeline(const TGraphicsPipelineDescriptor& graphicsPipelineD
 
     TGraphicsPipeline pipeline = {};
 
+    const auto programStartTime = std::chrono::steady_clock::now();
     auto graphicsProgramResult = CreateGraphicsProgram(graphicsPipelineDescriptor.Label,
                                                        graphicsPipelineDescriptor.VertexShaderFilePath,
                                                        graphicsPipelineDescriptor.FragmentShaderFilePath);
+    g_programCacheStatistics.CreationTimeInSeconds += std::chrono::duration<float>(std::chrono::steady_clock::now() - programStartTime).count();
     if (!graphicsProgramResult) {
         return std::unexpected(std::format("RHI: Unable to build GraphicsPipeline {}\n{}", graphicsPipelineDescriptor.Label, graphicsProgramResult.error()));
     }
@@ -1624,8 +2116,10 @@ auto CreateComputePipeline(const TComputePipelineDescriptor& computePipelineDesc
 
     TComputePipeline pipeline = {};
 
+    const auto programStartTime = std::chrono::steady_clock::now();
     auto computeProgramResult = CreateComputeProgram(computePipelineDescriptor.Label,
                                                      computePipelineDescriptor.ComputeShaderFilePath);
+    g_programCacheStatistics.CreationTimeInSeconds += std::chrono::duration<float>(std::chrono::steady_clock::now() - programStartTime).count();
     if (!computeProgramResult) {
         return std::unexpected(std::format("RHI: Unable to build ComputePipeline {}\n{}", computePipelineDescriptor.Label, computeProgramResult.error()));
     }
@@ -1635,60 +2129,140 @@ auto CreateComputePipeline(const TComputePipelineDescriptor& computePipelineDesc
     return pipeline;
 }
 
+auto GetOrCreateComputePipeline(const TComputePipelineDescriptor& computePipelineDescriptor) -> std::expected<TComputePipeline, std::string> {
+
+    const auto computeShaderFilePath = std::string(computePipelineDescriptor.ComputeShaderFilePath);
+    if (const auto existingComputePipeline = g_computePipelines.find(computeShaderFilePath); existingComputePipeline != g_computePipelines.end()) {
+        return existingComputePipeline->second;
+    }
+
+    auto computePipelineResult = CreateComputePipeline(computePipelineDescriptor);
+    if (!computePipelineResult) {
+        return std::unexpected(computePipelineResult.error());
+    }
+
+    g_computePipelines.insert({computeShaderFilePath, *computePipelineResult});
+
+    return *computePipelineResult;
+}
+
+auto ResolvePipelines(std::initializer_list<TPipeline*> pipelines) -> std::expected<void, std::string> {
+
+    PROFILER_ZONESCOPEDN("ResolvePipelines");
+
+    const auto resolveStartTime = std::chrono::steady_clock::now();
+
+    // programs are resolved in the order given, by the time the first status query returns the
+    // driver threads have usually finished the ones behind it. programs loaded from the binary
+    // cache or resolved before are not pending anymore
+    std::string errors;
+    std::vector<uint32_t> failedPrograms;
+    for (const auto* pipeline : pipelines) {
+
+        const auto pendingProgram = std::ranges::find(g_pendingPrograms, pipeline->Id, &TPendingProgram::Program);
+        if (pendingProgram == g_pendingPrograms.end()) {
+            continue;
+        }
+
+        const auto resolveProgramResult = ResolveProgram(*pendingProgram);
+
+        for (const auto& pendingShader : pendingProgram->Shaders) {
+            glDetachShader(pendingProgram->Program, pendingShader.Shader);
+            glDeleteShader(pendingShader.Shader);
+        }
+
+        if (!resolveProgramResult) {
+            // the next request for the shader compiles it again instead of getting the deleted program
+            std::erase_if(g_computePipelines, [&](const auto& computePipeline) {
+                return computePipeline.second.Id == pendingProgram->Program;
+            });
+            glDeleteProgram(pendingProgram->Program);
+            failedPrograms.push_back(pendingProgram->Program);
+            errors += std::format("RHI: Unable to build {} {}\n{}\n",
+                                  pendingProgram->IsCompute ? "ComputePipeline" : "GraphicsPipeline",
+                                  pendingProgram->Label,
+                                  resolveProgramResult.error());
+        }
+
+        g_pendingPrograms.erase(pendingProgram);
+    }
+
+    // the name of a deleted program can be handed out again, no pipeline may keep it
+    for (auto* pipeline : pipelines) {
+        if (std::ranges::find(failedPrograms, pipeline->Id) != failedPrograms.end()) {
+            pipeline->Id = 0;
+        }
+    }
+
+    g_programCacheStatistics.CreationTimeInSeconds += std::chrono::duration<float>(std::chrono::steady_clock::now() - resolveStartTime).count();
+
+    if (!errors.empty()) {
+        return std::unexpected(errors);
+    }
+
+    return {};
+}
+
 auto TGraphicsPipeline::Bind() -> void {
 
     TPipeline::Bind();
     // Input Assembly
-    glBindVertexArray(InputLayout.has_value() ? *InputLayout : g_defaultInputLayout);
-
-    // Rasterizer Stage
-    glPolygonMode(GL_FRONT_AND_BACK, FillModeToGL(FillMode));
-    if (CullMode == TCullMode::None) {
-        glDisable(GL_CULL_FACE);
-    } else {
-        glEnable(GL_CULL_FACE);
-        glCullFace(CullModeToGL(CullMode));
+    const auto inputLayout = InputLayout.has_value() ? *InputLayout : g_defaultInputLayout;
+    if (IsStateChanged(g_stateCache.VertexArray, inputLayout)) {
+        glBindVertexArray(inputLayout);
     }
 
-    if (IsRasterizerDisabled) {
-        glEnable(GL_RASTERIZER_DISCARD);
+    // Rasterizer Stage
+    if (IsStateChanged(g_stateCache.FillMode, FillModeToGL(FillMode))) {
+        glPolygonMode(GL_FRONT_AND_BACK, *g_stateCache.FillMode);
     }
-    if (IsScissorEnabled) {
-        glEnable(GL_SCISSOR_TEST);
-    } else {
-        glDisable(GL_SCISSOR_TEST);
+    SetCapability(g_stateCache.IsCullFaceEnabled, GL_CULL_FACE, CullMode != TCullMode::None);
+    if (CullMode != TCullMode::None && IsStateChanged(g_stateCache.CullFace, CullModeToGL(CullMode))) {
+        glCullFace(*g_stateCache.CullFace);
     }
 
-    glFrontFace(FaceWindingOrderToGL(FaceWindingOrder));
-    if (IsDepthBiasEnabled) {
-        glEnable(GL_POLYGON_OFFSET_FILL);
-        glEnable(GL_POLYGON_OFFSET_LINE);
-        glEnable(GL_POLYGON_OFFSET_POINT);
+    SetCapability(g_stateCache.IsRasterizerDiscardEnabled, GL_RASTERIZER_DISCARD, IsRasterizerDisabled);
+    SetCapability(g_stateCache.IsScissorTestEnabled, GL_SCISSOR_TEST, IsScissorEnabled);
 
+    if (IsStateChanged(g_stateCache.FrontFace, FaceWindingOrderToGL(FaceWindingOrder))) {
+        glFrontFace(*g_stateCache.FrontFace);
+    }
+    if (IsStateChanged(g_stateCache.IsPolygonOffsetEnabled, IsDepthBiasEnabled)) {
+        if (IsDepthBiasEnabled) {
+            glEnable(GL_POLYGON_OFFSET_FILL);
+            glEnable(GL_POLYGON_OFFSET_LINE);
+            glEnable(GL_POLYGON_OFFSET_POINT);
+        } else {
+            glDisable(GL_POLYGON_OFFSET_FILL);
+            glDisable(GL_POLYGON_OFFSET_LINE);
+            glDisable(GL_POLYGON_OFFSET_POINT);
+        }
+    }
+    if (IsDepthBiasEnabled && IsStateChanged(g_stateCache.PolygonOffset, std::pair{DepthBiasSlopeFactor, DepthBiasConstantFactor})) {
         glPolygonOffset(DepthBiasSlopeFactor, DepthBiasConstantFactor);
-    } else {
-        glDisable(GL_POLYGON_OFFSET_FILL);
-        glDisable(GL_POLYGON_OFFSET_LINE);
-        glDisable(GL_POLYGON_OFFSET_POINT);
     }
 
-    glLineWidth(LineWidth);
-    glPointSize(PointSize);
+    if (IsStateChanged(g_stateCache.LineWidth, LineWidth)) {
+        glLineWidth(LineWidth);
+    }
+    if (IsStateChanged(g_stateCache.PointSize, PointSize)) {
+        glPointSize(PointSize);
+    }
 
     // Output Merger Stage
 
-    if (IsDepthTestEnabled) {
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(DepthFunctionToGL(DepthFunction));
-    } else {
-        glDisable(GL_DEPTH_TEST);
+    SetCapability(g_stateCache.IsDepthTestEnabled, GL_DEPTH_TEST, IsDepthTestEnabled);
+    if (IsDepthTestEnabled && IsStateChanged(g_stateCache.DepthFunction, DepthFunctionToGL(DepthFunction))) {
+        glDepthFunc(*g_stateCache.DepthFunction);
     }
 
-    glDepthMask(IsDepthWriteEnabled ? GL_TRUE : GL_FALSE);
-    glColorMask((ColorMask & TColorMaskBits::R) == TColorMaskBits::R,
-                (ColorMask & TColorMaskBits::G) == TColorMaskBits::G,
-                (ColorMask & TColorMaskBits::B) == TColorMaskBits::B,
-                (ColorMask & TColorMaskBits::A) == TColorMaskBits::A);
+    SetDepthWriteEnabled(IsDepthWriteEnabled);
+    if (IsStateChanged(g_stateCache.ColorMask, ColorMask)) {
+        glColorMask((ColorMask & TColorMaskBits::R) == TColorMaskBits::R,
+                    (ColorMask & TColorMaskBits::G) == TColorMaskBits::G,
+                    (ColorMask & TColorMaskBits::B) == TColorMaskBits::B,
+                    (ColorMask & TColorMaskBits::A) == TColorMaskBits::A);
+    }
 }
 
 auto TGraphicsPipeline::BindBufferAsVertexBuffer(
@@ -1734,6 +2308,56 @@ auto TGraphicsPipeline::DrawElementsInstanced(
     glDrawElementsInstanced(PrimitiveTopology, elementCount, GL_UNSIGNED_INT, nullptr, instanceCount);
 }
 
+auto TGraphicsPipeline::MultiDrawElementsIndirect(
+    const uint32_t indexBuffer,
+    const uint32_t indirectBuffer,
+    const size_t indirectBufferOffset,
+    const size_t drawCount) -> void {
+
+    if (g_lastIndexBuffer != indexBuffer) {
+        glVertexArrayElementBuffer(InputLayout.has_value() ? InputLayout.value() : g_defaultInputLayout, indexBuffer);
+        g_lastIndexBuffer = indexBuffer;
+    }
+
+    if (IsStateChanged(g_stateCache.DrawIndirectBuffer, indirectBuffer)) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    }
+    glMultiDrawElementsIndirect(
+        PrimitiveTopology,
+        GL_UNSIGNED_INT,
+        reinterpret_cast<const void*>(indirectBufferOffset),
+        static_cast<int32_t>(drawCount),
+        sizeof(TDrawElementsIndirectCommand));
+}
+
+auto TGraphicsPipeline::MultiDrawElementsIndirectCount(
+    const uint32_t indexBuffer,
+    const uint32_t indirectBuffer,
+    const size_t indirectBufferOffset,
+    const uint32_t countBuffer,
+    const size_t countBufferOffset,
+    const size_t maxDrawCount) -> void {
+
+    if (g_lastIndexBuffer != indexBuffer) {
+        glVertexArrayElementBuffer(InputLayout.has_value() ? InputLayout.value() : g_defaultInputLayout, indexBuffer);
+        g_lastIndexBuffer = indexBuffer;
+    }
+
+    if (IsStateChanged(g_stateCache.DrawIndirectBuffer, indirectBuffer)) {
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    }
+    if (IsStateChanged(g_stateCache.ParameterBuffer, countBuffer)) {
+        glBindBuffer(GL_PARAMETER_BUFFER, countBuffer);
+    }
+    glMultiDrawElementsIndirectCount(
+        PrimitiveTopology,
+        GL_UNSIGNED_INT,
+        reinterpret_cast<const void*>(indirectBufferOffset),
+        static_cast<intptr_t>(countBufferOffset),
+        static_cast<int32_t>(maxDrawCount),
+        sizeof(TDrawElementsIndirectCommand));
+}
+
 auto TComputePipeline::Dispatch(
     const int32_t workGroupSizeX,
     const int32_t workGroupSizeY,
@@ -1742,6 +2366,16 @@ auto TComputePipeline::Dispatch(
     glDispatchCompute(workGroupSizeX, workGroupSizeY, workGroupSizeZ);
 }
 
+auto GetShaderSourceHash(std::string_view shaderFilePath) -> std::expected<uint64_t, std::string> {
+
+    const auto shaderSourceResult = ReadShaderSourceFromFile(shaderFilePath);
+    if (!shaderSourceResult) {
+        return std::unexpected(shaderSourceResult.error());
+    }
+
+    return Cache::HashBytes(std::as_bytes(std::span(*shaderSourceResult)));
+}
+
 auto RhiInitialize(bool isDebug) -> void {
 
     g_samplers.reserve(128);
@@ -1761,21 +2395,70 @@ auto RhiInitialize(bool isDebug) -> void {
     int32_t g_maxComputeWorkgroupInvocations = 0;
     glGetIntegerv(GL_MAX_COMPUTE_WORK_GROUP_INVOCATIONS, &g_maxComputeWorkgroupInvocations);
 
+    InvalidateStateCache();
+
     glEnable(GL_FRAMEBUFFER_SRGB);
-    glEnable(GL_CULL_FACE);
+    SetCapability(g_stateCache.IsCullFaceEnabled, GL_CULL_FACE, true);
     glCullFace(GL_BACK);
+    g_stateCache.CullFace = GL_BACK;
     glFrontFace(GL_CCW);
-    glEnable(GL_DEPTH_TEST);
+    g_stateCache.FrontFace = GL_CCW;
+    SetCapability(g_stateCache.IsDepthTestEnabled, GL_DEPTH_TEST, true);
     glClearColor(0.03f, 0.05f, 0.07f, 1.0f);
 
     const auto gpuVendor = std::string((const char*)glGetString(GL_VENDOR));
     const auto gpuRenderer = std::string((const char*)glGetString(GL_RENDERER));
 
+    const auto gpuDriverVersion = std::string((const char*)glGetString(GL_VERSION));
+
     spdlog::info("OpenGL Vendor: {}", gpuVendor);
     spdlog::info("OpenGL Renderer: {}", gpuRenderer);
+    spdlog::info("OpenGL Version: {}", gpuDriverVersion);
+
+    // let the driver compile shaders on as many threads as it likes, status queries are deferred to ResolvePipelines
+    if (GLAD_GL_KHR_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    } else if (GLAD_GL_ARB_parallel_shader_compile) {
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFF);
+    }
+
+    int32_t programBinaryFormatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &programBinaryFormatCount);
+    g_isProgramBinaryCacheEnabled = programBinaryFormatCount > 0;
+
+    const auto driverIdentity = std::format("{}\n{}\n{}", gpuVendor, gpuRenderer, gpuDriverVersion);
+    g_programBinaryDriverHash = Cache::HashBytes(std::as_bytes(std::span(driverIdentity)));
+    g_programCacheStatistics = {};
 }
 
 auto RhiShutdown() -> void {
+    for (const auto& [computeShaderFilePath, computePipeline] : g_computePipelines) {
+        DeletePipeline(computePipeline);
+    }
+    g_computePipelines.clear();
     DeleteTextures();
     glDeleteVertexArrays(1, &g_defaultInputLayout);
+    InvalidateStateCache();
+}
+
+auto InvalidateStateCache() -> void {
+
+    g_stateCache = {};
+}
+
+auto GetProgramCacheStatistics() -> const TProgramCacheStatistics& {
+
+    return g_programCacheStatistics;
+}
+
+#ifndef NDEBUG
+auto GetStateCacheStatistics() -> const TStateCacheStatistics& {
+
+    return g_stateCacheStatistics;
+}
+
+auto ResetStateCacheStatistics() -> void {
+
+    g_stateCacheStatistics = {};
 }
+#endif
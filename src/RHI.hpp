@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 using TTextureId = TId<struct GTextureId>;
 using TSamplerId = TId<struct GSamplerId>;
 using TFramebufferId = TId<struct GFramebufferId>;
@@ -300,26 +302,37 @@ struct TFramebufferDepthStencilAttachmentDescriptor {
     TFramebufferAttachmentClearDepthStencil ClearDepthStencil;
 };
 
+struct TFramebufferExistingColorAttachmentDescriptor {
+    const TTexture& ExistingColorTexture;
+    TFramebufferAttachmentLoadOperation LoadOperation = TFramebufferAttachmentLoadOperation::DontCare;
+    TFramebufferAttachmentClearColor ClearColor = {};
+};
+
 struct TFramebufferExistingDepthStencilAttachmentDescriptor {
     TTexture& ExistingDepthTexture;
+    TFramebufferAttachmentLoadOperation LoadOperation = TFramebufferAttachmentLoadOperation::DontCare;
+    TFramebufferAttachmentClearDepthStencil ClearDepthStencil = {};
 };
 
 struct TFramebufferDescriptor {
     std::string_view Label;
-    std::array<std::optional<TFramebufferColorAttachmentDescriptor>, 8> ColorAttachments;
+    std::array<std::optional<std::variant<TFramebufferColorAttachmentDescriptor, TFramebufferExistingColorAttachmentDescriptor>>, 8> ColorAttachments;
     std::optional<std::variant<TFramebufferDepthStencilAttachmentDescriptor, TFramebufferExistingDepthStencilAttachmentDescriptor>> DepthStencilAttachment;
 };
 
+// existing attachments are not owned, DeleteFramebuffer leaves their textures alone
 struct TFramebufferColorAttachment {
     TTexture Texture;
     TFramebufferAttachmentClearColor ClearColor;
     TFramebufferAttachmentLoadOperation LoadOperation;
+    bool IsTextureOwned = false;
 };
 
 struct TFramebufferDepthStencilAttachment {
     TTexture Texture;
     TFramebufferAttachmentClearDepthStencil ClearDepthStencil;
     TFramebufferAttachmentLoadOperation LoadOperation;
+    bool IsTextureOwned = false;
 };
 
 struct TFramebuffer {
@@ -456,6 +469,14 @@ struct TGraphicsPipelineDescriptor {
     TOutputMergerState OutputMergerState = {};
 };
 
+struct TDrawElementsIndirectCommand {
+    uint32_t IndexCount;
+    uint32_t InstanceCount;
+    uint32_t FirstIndex;
+    int32_t BaseVertex;
+    uint32_t BaseInstance;
+};
+
 struct TComputePipelineDescriptor {
     std::string_view Label;
     std::string_view ComputeShaderFilePath;
@@ -506,6 +527,8 @@ struct TGraphicsPipeline : public TPipeline {
     auto DrawArrays(int32_t vertexOffset, size_t vertexCount) -> void;
     auto DrawElements(uint32_t indexBuffer, size_t elementCount) -> void;
     auto DrawElementsInstanced(uint32_t indexBuffer, size_t elementCount, size_t instanceCount) -> void;
+    auto MultiDrawElementsIndirect(uint32_t indexBuffer, uint32_t indirectBuffer, size_t indirectBufferOffset, size_t drawCount) -> void;
+    auto MultiDrawElementsIndirectCount(uint32_t indexBuffer, uint32_t indirectBuffer, size_t indirectBufferOffset, uint32_t countBuffer, size_t countBufferOffset, size_t maxDrawCount) -> void;
 
     // Input Assembly
     std::optional<uint32_t> InputLayout = {};
@@ -533,6 +556,17 @@ struct TGraphicsPipeline : public TPipeline {
     TDepthFunction DepthFunction = {};
 };
 
+struct TStateCacheStatistics {
+    uint64_t IssuedCallCount = 0;
+    uint64_t SkippedCallCount = 0;
+};
+
+struct TProgramCacheStatistics {
+    uint32_t ProgramCount = 0;
+    uint32_t CachedProgramCount = 0;
+    float CreationTimeInSeconds = 0.0f;
+};
+
 struct TComputePipeline : public TPipeline {
     auto Dispatch(
         int32_t workGroupSizeX,
@@ -568,6 +602,26 @@ struct TSamplerDescriptor {
     }
 };
 
+constexpr auto RING_BUFFER_FRAME_COUNT = 3u;
+
+struct TRingBufferAllocation {
+    uint32_t Buffer = 0;
+    int64_t Offset = 0;
+    int64_t Size = 0;
+};
+
+// persistently mapped buffer split into one region per frame in flight,
+// a region is written again only after the fence of the frame which last used it has signaled
+struct TRingBuffer {
+    uint32_t Id = 0;
+    uint8_t* MappedData = nullptr;
+    int64_t RegionSize = 0;
+    int64_t Alignment = 0;
+    uint32_t RegionIndex = 0;
+    int64_t RegionCursor = 0;
+    std::array<void*, RING_BUFFER_FRAME_COUNT> Fences = {};
+};
+
 namespace std {
     template<>
     struct hash<TSamplerDescriptor> {
@@ -599,6 +653,7 @@ auto SetDebugLabel(
     const std::string_view label) -> void;
 auto PushDebugGroup(const std::string_view label) -> void;
 auto PopDebugGroup() -> void;
+auto InsertMemoryBarrier(TMemoryBarrierMask memoryBarrierMask) -> void;
 
 auto CreateBuffer(
     std::string_view label,
@@ -610,7 +665,23 @@ auto UpdateBuffer(
     int64_t offsetInBytes,
     int64_t sizeInBytes,
     const void* data) -> void;
+auto ClearBuffer(
+    uint32_t buffer,
+    int64_t offsetInBytes,
+    int64_t sizeInBytes) -> void;
 auto DeleteBuffer(uint32_t buffer) -> void;
+
+auto CreateRingBuffer(
+    std::string_view label,
+    int64_t regionSizeInBytes) -> TRingBuffer;
+auto BeginRingBufferFrame(TRingBuffer& ringBuffer) -> void;
+auto AllocateFromRingBuffer(
+    TRingBuffer& ringBuffer,
+    int64_t sizeInBytes,
+    const void* data) -> TRingBufferAllocation;
+auto EndRingBufferFrame(TRingBuffer& ringBuffer) -> void;
+auto DeleteRingBuffer(TRingBuffer& ringBuffer) -> void;
+
 auto DeletePipeline(const TPipeline& pipeline) -> void;
 
 auto GetTexture(TTextureId id) -> TTexture&;
@@ -627,6 +698,19 @@ auto MakeTextureResident(
     const TTextureId& textureId,
     const TSamplerId& samplerId) -> uint64_t;
 auto GenerateMipmaps(const TTextureId& textureId) -> void;
+// whole mip levels, faces of cube maps count as depth. sizes and downloads use the upload format and
+// type UploadTexture picks with TUploadFormat::Auto and TUploadType::Auto, so downloads can be uploaded as is
+auto GetTextureLevelExtent(
+    const TTextureId& textureId,
+    uint32_t level) -> TExtent3D;
+auto GetTextureLevelSizeInBytes(
+    const TTextureId& textureId,
+    uint32_t level) -> std::size_t;
+auto DownloadTexture(
+    const TTextureId& textureId,
+    uint32_t level,
+    std::span<std::byte> pixelData) -> void;
+auto DeleteTexture(const TTextureId& textureId) -> void;
 
 auto GetSampler(const TSamplerId& id) -> TSampler&;
 auto GetOrCreateSampler(const TSamplerDescriptor& samplerDescriptor) -> TSamplerId;
@@ -637,6 +721,29 @@ auto DeleteFramebuffer(const TFramebuffer& framebuffer) -> void;
 
 auto CreateGraphicsPipeline(const TGraphicsPipelineDescriptor& graphicsPipelineDescriptor) -> std::expected<TGraphicsPipeline, std::string>;
 auto CreateComputePipeline(const TComputePipelineDescriptor& computePipelineDescriptor) -> std::expected<TComputePipeline, std::string>;
+// compute pipelines are fully described by their shader, every caller asking for the same shader gets the
+// same program. cached pipelines are owned by the rhi and deleted in RhiShutdown, not by DeletePipeline,
+// one which fails to resolve is dropped from the cache
+auto GetOrCreateComputePipeline(const TComputePipelineDescriptor& computePipelineDescriptor) -> std::expected<TComputePipeline, std::string>;
+// pipeline creation only submits the shaders to the driver, compile and link errors are reported by
+// ResolvePipelines, which has to run before a pipeline created since is bound. it waits for the given
+// pipelines only, a program which failed is deleted and the Id of every given pipeline using it reset to 0
+auto ResolvePipelines(std::initializer_list<TPipeline*> pipelines) -> std::expected<void, std::string>;
+
+// hash of the shader source with its includes expanded, for caches of data a shader produced
+auto GetShaderSourceHash(std::string_view shaderFilePath) -> std::expected<uint64_t, std::string>;
 
 auto RhiInitialize(bool isDebug) -> void;
 auto RhiShutdown() -> void;
+
+// linked programs are kept as driver binaries in the disk cache, keyed on the preprocessed shader sources
+// and the driver identity. a missing or rejected binary falls back to compiling from source
+auto GetProgramCacheStatistics() -> const TProgramCacheStatistics&;
+
+// the rhi skips gl calls which would not change the state it last set, code which changes gl state
+// behind its back (imgui, raw gl calls) has to invalidate the cache afterwards
+auto InvalidateStateCache() -> void;
+#ifndef NDEBUG
+auto GetStateCacheStatistics() -> const TStateCacheStatistics&;
+auto ResetStateCacheStatistics() -> void;
+#endif
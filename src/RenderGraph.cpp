@@ -0,0 +1,476 @@
+#include "RenderGraph.hpp"
+#include "Profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <limits>
+
+namespace {
+
+constexpr auto ToIndex(const TRenderGraphResourceId resourceId) -> std::size_t {
+    return static_cast<std::size_t>(resourceId);
+}
+
+constexpr auto ToIndex(const TRenderGraphPassId passId) -> std::size_t {
+    return static_cast<std::size_t>(passId);
+}
+
+// only shader image stores and storage buffer writes bypass gl's implicit ordering
+constexpr auto IsIncoherentWrite(const TRenderGraphResourceUsage usage) -> bool {
+    return usage == TRenderGraphResourceUsage::StorageImage || usage == TRenderGraphResourceUsage::StorageBuffer;
+}
+
+// the barrier bit which makes incoherent writes visible to the given kind of access
+constexpr auto UsageToMemoryBarrierMask(const TRenderGraphResourceUsage usage) -> TMemoryBarrierMask {
+    switch (usage) {
+        case TRenderGraphResourceUsage::ColorAttachment:
+        case TRenderGraphResourceUsage::DepthStencilAttachment: return TMemoryBarrierMaskBits::Framebuffer;
+        case TRenderGraphResourceUsage::SampledTexture: return TMemoryBarrierMaskBits::TextureFetch;
+        case TRenderGraphResourceUsage::StorageImage: return TMemoryBarrierMaskBits::ShaderImageAccess;
+        case TRenderGraphResourceUsage::StorageBuffer: return TMemoryBarrierMaskBits::ShaderStorage;
+        case TRenderGraphResourceUsage::UniformBuffer: return TMemoryBarrierMaskBits::Uniform;
+        case TRenderGraphResourceUsage::IndirectBuffer: return TMemoryBarrierMaskBits::Command;
+        default: std::unreachable();
+    }
+}
+
+}
+
+auto TRenderGraph::Reset() -> void {
+
+    PROFILER_ZONESCOPEDN("RenderGraph Reset");
+
+    // pass entries are reused to keep the capacity of their access lists
+    for (uint32_t passIndex = 0; passIndex < PassCount; ++passIndex) {
+        auto& pass = Passes[passIndex];
+        pass.Execute = {};
+        pass.Accesses.clear();
+        pass.ColorAttachments = {};
+        pass.DepthStencilAttachment.reset();
+        pass.Framebuffer = {};
+        pass.MemoryBarrierMask = {};
+        pass.HasSideEffects = false;
+        pass.IsCulled = false;
+    }
+    PassCount = 0;
+    Resources.clear();
+
+    for (auto& cachedFramebuffer : FramebufferCache) {
+        cachedFramebuffer.UnusedFrameCount = cachedFramebuffer.IsUsed ? 0 : cachedFramebuffer.UnusedFrameCount + 1;
+        cachedFramebuffer.IsUsed = false;
+    }
+
+    for (auto& pooledTexture : TexturePool) {
+        pooledTexture.UnusedFrameCount = pooledTexture.IsUsed ? 0 : pooledTexture.UnusedFrameCount + 1;
+        pooledTexture.IsUsed = false;
+        pooledTexture.IsAcquired = false;
+
+        if (pooledTexture.UnusedFrameCount > RENDER_GRAPH_MAX_UNUSED_FRAMES) {
+            // framebuffers must not outlive their attachments, gl may hand out the same name again
+            const auto textureId = ::GetTexture(pooledTexture.TextureId).Id;
+            for (auto& cachedFramebuffer : FramebufferCache) {
+                const auto isAttached = cachedFramebuffer.DepthStencilTexture == textureId ||
+                                        std::ranges::find(cachedFramebuffer.ColorTextures, textureId) != cachedFramebuffer.ColorTextures.end();
+                if (isAttached) {
+                    cachedFramebuffer.UnusedFrameCount = std::numeric_limits<uint32_t>::max();
+                }
+            }
+            DeleteTexture(pooledTexture.TextureId);
+            pooledTexture.TextureId = TTextureId::Invalid;
+        }
+    }
+    std::erase_if(TexturePool, [](const TPooledTexture& pooledTexture) {
+        return pooledTexture.TextureId == TTextureId::Invalid;
+    });
+
+    std::erase_if(FramebufferCache, [](const TCachedFramebuffer& cachedFramebuffer) {
+        if (cachedFramebuffer.UnusedFrameCount > RENDER_GRAPH_MAX_UNUSED_FRAMES) {
+            DeleteFramebuffer(cachedFramebuffer.Framebuffer);
+            return true;
+        }
+        return false;
+    });
+}
+
+auto TRenderGraph::CreateTexture(const TRenderGraphTextureDescriptor& textureDescriptor) -> TRenderGraphResourceId {
+
+    Resources.push_back(TResource{
+        .TextureDescriptor = textureDescriptor,
+        .IsTexture = true,
+    });
+    return static_cast<TRenderGraphResourceId>(Resources.size() - 1);
+}
+
+auto TRenderGraph::ImportTexture(
+    const std::string_view label,
+    const TTexture& texture) -> TRenderGraphResourceId {
+
+    Resources.push_back(TResource{
+        .TextureDescriptor = TRenderGraphTextureDescriptor{
+            .Label = label,
+            .Format = texture.Format,
+            .Extent = TExtent2D(texture.Extent.Width, texture.Extent.Height),
+        },
+        .Texture = texture,
+        .IsTexture = true,
+        .IsImported = true,
+    });
+    return static_cast<TRenderGraphResourceId>(Resources.size() - 1);
+}
+
+auto TRenderGraph::ImportBuffer(
+    const std::string_view label,
+    const uint32_t buffer) -> TRenderGraphResourceId {
+
+    Resources.push_back(TResource{
+        .TextureDescriptor = TRenderGraphTextureDescriptor{
+            .Label = label,
+        },
+        .Buffer = buffer,
+        .IsImported = true,
+    });
+    return static_cast<TRenderGraphResourceId>(Resources.size() - 1);
+}
+
+auto TRenderGraph::AddPass(
+    const std::string_view label,
+    std::function<void()> execute) -> TRenderGraphPassId {
+
+    if (PassCount == Passes.size()) {
+        Passes.emplace_back();
+    }
+
+    auto& pass = Passes[PassCount];
+    pass.Label = label;
+    pass.Execute = std::move(execute);
+    return static_cast<TRenderGraphPassId>(PassCount++);
+}
+
+auto TRenderGraph::SetSideEffect(const TRenderGraphPassId passId) -> void {
+
+    Passes[ToIndex(passId)].HasSideEffects = true;
+}
+
+auto TRenderGraph::Read(
+    const TRenderGraphPassId passId,
+    const TRenderGraphResourceId resourceId,
+    const TRenderGraphResourceUsage usage) -> void {
+
+    assert(resourceId != TRenderGraphResourceId::Invalid);
+    Passes[ToIndex(passId)].Accesses.push_back(TAccess{
+        .ResourceId = resourceId,
+        .Usage = usage,
+        .IsWrite = false,
+    });
+}
+
+auto TRenderGraph::Write(
+    const TRenderGraphPassId passId,
+    const TRenderGraphResourceId resourceId,
+    const TRenderGraphResourceUsage usage) -> void {
+
+    assert(resourceId != TRenderGraphResourceId::Invalid);
+    Passes[ToIndex(passId)].Accesses.push_back(TAccess{
+        .ResourceId = resourceId,
+        .Usage = usage,
+        .IsWrite = true,
+    });
+}
+
+auto TRenderGraph::WriteColorAttachment(
+    const TRenderGraphPassId passId,
+    const TRenderGraphResourceId resourceId,
+    const uint32_t colorAttachmentIndex,
+    const TFramebufferAttachmentLoadOperation loadOperation,
+    const TFramebufferAttachmentClearColor& clearColor) -> void {
+
+    // loading what an earlier pass left behind makes that pass a dependency
+    if (loadOperation == TFramebufferAttachmentLoadOperation::Load) {
+        Read(passId, resourceId, TRenderGraphResourceUsage::ColorAttachment);
+    }
+    Write(passId, resourceId, TRenderGraphResourceUsage::ColorAttachment);
+
+    Passes[ToIndex(passId)].ColorAttachments[colorAttachmentIndex] = TColorAttachment{
+        .ResourceId = resourceId,
+        .LoadOperation = loadOperation,
+        .ClearColor = clearColor,
+    };
+}
+
+auto TRenderGraph::WriteDepthStencilAttachment(
+    const TRenderGraphPassId passId,
+    const TRenderGraphResourceId resourceId,
+    const TFramebufferAttachmentLoadOperation loadOperation,
+    const TFramebufferAttachmentClearDepthStencil& clearDepthStencil) -> void {
+
+    if (loadOperation == TFramebufferAttachmentLoadOperation::Load) {
+        Read(passId, resourceId, TRenderGraphResourceUsage::DepthStencilAttachment);
+    }
+    Write(passId, resourceId, TRenderGraphResourceUsage::DepthStencilAttachment);
+
+    Passes[ToIndex(passId)].DepthStencilAttachment = TDepthStencilAttachment{
+        .ResourceId = resourceId,
+        .LoadOperation = loadOperation,
+        .ClearDepthStencil = clearDepthStencil,
+    };
+}
+
+auto TRenderGraph::Compile() -> void {
+
+    PROFILER_ZONESCOPEDN("RenderGraph Compile");
+
+    Statistics = TRenderGraphStatistics{
+        .PassCount = PassCount,
+    };
+
+    // walk back from the passes with visible results, everything they read is needed by someone
+    for (auto passIndex = static_cast<int32_t>(PassCount) - 1; passIndex >= 0; --passIndex) {
+        auto& pass = Passes[passIndex];
+        pass.IsCulled = !pass.HasSideEffects && std::ranges::none_of(pass.Accesses, [&](const TAccess& access) {
+            const auto& resource = Resources[ToIndex(access.ResourceId)];
+            return access.IsWrite && (resource.IsImported || resource.IsNeeded);
+        });
+
+        if (pass.IsCulled) {
+            Statistics.CulledPassCount++;
+            continue;
+        }
+
+        for (const auto& access : pass.Accesses) {
+            if (!access.IsWrite) {
+                Resources[ToIndex(access.ResourceId)].IsNeeded = true;
+            }
+        }
+    }
+
+    // lifetimes of transient textures span from the first to the last surviving pass touching them
+    for (auto& resource : Resources) {
+        resource.FirstPassIndex = std::numeric_limits<uint32_t>::max();
+        resource.LastPassIndex = 0;
+    }
+    for (uint32_t passIndex = 0; passIndex < PassCount; ++passIndex) {
+        if (Passes[passIndex].IsCulled) {
+            continue;
+        }
+        for (const auto& access : Passes[passIndex].Accesses) {
+            auto& resource = Resources[ToIndex(access.ResourceId)];
+            resource.FirstPassIndex = std::min(resource.FirstPassIndex, passIndex);
+            resource.LastPassIndex = std::max(resource.LastPassIndex, passIndex);
+        }
+    }
+
+    for (uint32_t passIndex = 0; passIndex < PassCount; ++passIndex) {
+        auto& pass = Passes[passIndex];
+        if (pass.IsCulled) {
+            continue;
+        }
+
+        // textures are acquired before any is released, inputs and outputs of a pass never alias
+        for (const auto& access : pass.Accesses) {
+            auto& resource = Resources[ToIndex(access.ResourceId)];
+            if (resource.IsTexture && !resource.IsImported && resource.FirstPassIndex == passIndex && resource.Texture.Id == 0) {
+                AcquireTexture(resource);
+            }
+        }
+        for (const auto& access : pass.Accesses) {
+            const auto& resource = Resources[ToIndex(access.ResourceId)];
+            if (resource.IsTexture && !resource.IsImported && resource.LastPassIndex == passIndex) {
+                for (auto& pooledTexture : TexturePool) {
+                    if (pooledTexture.IsAcquired && ::GetTexture(pooledTexture.TextureId).Id == resource.Texture.Id) {
+                        pooledTexture.IsAcquired = false;
+                    }
+                }
+            }
+        }
+
+        // one glMemoryBarrier covers every outstanding write, so a bit is only set once per write
+        auto memoryBarrierMask = TMemoryBarrierMask{};
+        for (const auto& access : pass.Accesses) {
+            const auto& resource = Resources[ToIndex(access.ResourceId)];
+            if (resource.HasIncoherentWrite) {
+                memoryBarrierMask |= UsageToMemoryBarrierMask(access.Usage) & ~resource.IssuedMemoryBarrierMask;
+            }
+        }
+
+        pass.MemoryBarrierMask = memoryBarrierMask;
+        if (memoryBarrierMask) {
+            Statistics.MemoryBarrierCount++;
+            for (auto& resource : Resources) {
+                if (resource.HasIncoherentWrite) {
+                    resource.IssuedMemoryBarrierMask |= memoryBarrierMask;
+                }
+            }
+        }
+
+        for (const auto& access : pass.Accesses) {
+            if (access.IsWrite && IsIncoherentWrite(access.Usage)) {
+                auto& resource = Resources[ToIndex(access.ResourceId)];
+                resource.HasIncoherentWrite = true;
+                resource.IssuedMemoryBarrierMask = {};
+            }
+        }
+
+        ResolveFramebuffer(pass);
+    }
+
+    for (const auto& resource : Resources) {
+        if (resource.IsTexture && !resource.IsImported && resource.Texture.Id != 0) {
+            Statistics.TransientTextureCount++;
+        }
+    }
+    Statistics.PhysicalTextureCount = static_cast<uint32_t>(std::ranges::count_if(TexturePool, [](const TPooledTexture& pooledTexture) {
+        return pooledTexture.IsUsed;
+    }));
+}
+
+auto TRenderGraph::Execute() -> void {
+
+    PROFILER_ZONESCOPEDN("RenderGraph Execute");
+
+    for (uint32_t passIndex = 0; passIndex < PassCount; ++passIndex) {
+        const auto& pass = Passes[passIndex];
+        if (pass.IsCulled) {
+            continue;
+        }
+
+        if (pass.MemoryBarrierMask) {
+            InsertMemoryBarrier(pass.MemoryBarrierMask);
+        }
+        pass.Execute();
+    }
+}
+
+auto TRenderGraph::IsPassCulled(const TRenderGraphPassId passId) const -> bool {
+
+    return Passes[ToIndex(passId)].IsCulled;
+}
+
+auto TRenderGraph::GetTexture(const TRenderGraphResourceId resourceId) const -> const TTexture& {
+
+    return Resources[ToIndex(resourceId)].Texture;
+}
+
+auto TRenderGraph::GetFramebuffer(const TRenderGraphPassId passId) const -> const TFramebuffer& {
+
+    return Passes[ToIndex(passId)].Framebuffer;
+}
+
+auto TRenderGraph::Destroy() -> void {
+
+    for (const auto& cachedFramebuffer : FramebufferCache) {
+        DeleteFramebuffer(cachedFramebuffer.Framebuffer);
+    }
+    FramebufferCache.clear();
+
+    for (const auto& pooledTexture : TexturePool) {
+        DeleteTexture(pooledTexture.TextureId);
+    }
+    TexturePool.clear();
+
+    for (auto& resource : Resources) {
+        if (!resource.IsImported) {
+            resource.Texture = {};
+        }
+    }
+}
+
+auto TRenderGraph::AcquireTexture(TResource& resource) -> void {
+
+    const auto& textureDescriptor = resource.TextureDescriptor;
+    auto pooledTextureIterator = std::ranges::find_if(TexturePool, [&](const TPooledTexture& pooledTexture) {
+        return !pooledTexture.IsAcquired &&
+               pooledTexture.Format == textureDescriptor.Format &&
+               pooledTexture.Extent == textureDescriptor.Extent &&
+               pooledTexture.MipMapLevels == textureDescriptor.MipMapLevels;
+    });
+
+    if (pooledTextureIterator == TexturePool.end()) {
+        const auto textureId = ::CreateTexture({
+            .TextureType = TTextureType::Texture2D,
+            .Format = textureDescriptor.Format,
+            .Extent = TExtent3D{textureDescriptor.Extent.Width, textureDescriptor.Extent.Height, 1u},
+            .MipMapLevels = textureDescriptor.MipMapLevels,
+            .Layers = 0,
+            .SampleCount = TSampleCount::One,
+            .Label = std::format("RenderGraph-{}-{}x{}", textureDescriptor.Label, textureDescriptor.Extent.Width, textureDescriptor.Extent.Height),
+        });
+        TexturePool.push_back(TPooledTexture{
+            .TextureId = textureId,
+            .Format = textureDescriptor.Format,
+            .Extent = textureDescriptor.Extent,
+            .MipMapLevels = textureDescriptor.MipMapLevels,
+        });
+        pooledTextureIterator = std::prev(TexturePool.end());
+    }
+
+    pooledTextureIterator->IsAcquired = true;
+    pooledTextureIterator->IsUsed = true;
+    resource.Texture = ::GetTexture(pooledTextureIterator->TextureId);
+}
+
+auto TRenderGraph::ResolveFramebuffer(TPass& pass) -> void {
+
+    const auto hasColorAttachment = std::ranges::any_of(pass.ColorAttachments, [](const auto& colorAttachment) {
+        return colorAttachment.has_value();
+    });
+    if (!hasColorAttachment && !pass.DepthStencilAttachment.has_value()) {
+        return;
+    }
+
+    auto colorTextures = std::array<uint32_t, 8>{};
+    for (std::size_t colorAttachmentIndex = 0; colorAttachmentIndex < pass.ColorAttachments.size(); ++colorAttachmentIndex) {
+        if (pass.ColorAttachments[colorAttachmentIndex].has_value()) {
+            colorTextures[colorAttachmentIndex] = Resources[ToIndex(pass.ColorAttachments[colorAttachmentIndex]->ResourceId)].Texture.Id;
+        }
+    }
+    const auto depthStencilTexture = pass.DepthStencilAttachment.has_value()
+        ? Resources[ToIndex(pass.DepthStencilAttachment->ResourceId)].Texture.Id
+        : 0u;
+
+    auto cachedFramebufferIterator = std::ranges::find_if(FramebufferCache, [&](const TCachedFramebuffer& cachedFramebuffer) {
+        return cachedFramebuffer.ColorTextures == colorTextures && cachedFramebuffer.DepthStencilTexture == depthStencilTexture;
+    });
+
+    if (cachedFramebufferIterator == FramebufferCache.end()) {
+        auto framebufferDescriptor = TFramebufferDescriptor{
+            .Label = pass.Label,
+        };
+        for (std::size_t colorAttachmentIndex = 0; colorAttachmentIndex < pass.ColorAttachments.size(); ++colorAttachmentIndex) {
+            if (pass.ColorAttachments[colorAttachmentIndex].has_value()) {
+                framebufferDescriptor.ColorAttachments[colorAttachmentIndex].emplace(TFramebufferExistingColorAttachmentDescriptor{
+                    .ExistingColorTexture = Resources[ToIndex(pass.ColorAttachments[colorAttachmentIndex]->ResourceId)].Texture,
+                });
+            }
+        }
+        if (pass.DepthStencilAttachment.has_value()) {
+            framebufferDescriptor.DepthStencilAttachment.emplace(TFramebufferExistingDepthStencilAttachmentDescriptor{
+                .ExistingDepthTexture = Resources[ToIndex(pass.DepthStencilAttachment->ResourceId)].Texture,
+            });
+        }
+
+        FramebufferCache.push_back(TCachedFramebuffer{
+            .ColorTextures = colorTextures,
+            .DepthStencilTexture = depthStencilTexture,
+            .Framebuffer = ::CreateFramebuffer(framebufferDescriptor),
+        });
+        cachedFramebufferIterator = std::prev(FramebufferCache.end());
+    }
+
+    cachedFramebufferIterator->IsUsed = true;
+
+    // the gl object is shared, load operations and clear values are per pass
+    pass.Framebuffer = cachedFramebufferIterator->Framebuffer;
+    for (std::size_t colorAttachmentIndex = 0; colorAttachmentIndex < pass.ColorAttachments.size(); ++colorAttachmentIndex) {
+        if (pass.ColorAttachments[colorAttachmentIndex].has_value()) {
+            auto& colorAttachment = *pass.Framebuffer.ColorAttachments[colorAttachmentIndex];
+            colorAttachment.LoadOperation = pass.ColorAttachments[colorAttachmentIndex]->LoadOperation;
+            colorAttachment.ClearColor = pass.ColorAttachments[colorAttachmentIndex]->ClearColor;
+        }
+    }
+    if (pass.DepthStencilAttachment.has_value()) {
+        auto& depthStencilAttachment = *pass.Framebuffer.DepthStencilAttachment;
+        depthStencilAttachment.LoadOperation = pass.DepthStencilAttachment->LoadOperation;
+        depthStencilAttachment.ClearDepthStencil = pass.DepthStencilAttachment->ClearDepthStencil;
+    }
+}
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "RHI.hpp"
+
+#include <array>
+#include <functional>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+using TRenderGraphResourceId = TId<struct GRenderGraphResourceId>;
+using TRenderGraphPassId = TId<struct GRenderGraphPassId>;
+
+// pooled textures and framebuffers nobody asked for in this many frames are deleted
+constexpr auto RENDER_GRAPH_MAX_UNUSED_FRAMES = 4u;
+
+enum class TRenderGraphResourceUsage : uint8_t {
+    ColorAttachment,
+    DepthStencilAttachment,
+    SampledTexture,
+    StorageImage,
+    StorageBuffer,
+    UniformBuffer,
+    IndirectBuffer,
+};
+
+struct TRenderGraphTextureDescriptor {
+    std::string_view Label;
+    TFormat Format = TFormat::Undefined;
+    TExtent2D Extent = {};
+    uint32_t MipMapLevels = 1;
+};
+
+struct TRenderGraphStatistics {
+    uint32_t PassCount = 0;
+    uint32_t CulledPassCount = 0;
+    uint32_t TransientTextureCount = 0;
+    uint32_t PhysicalTextureCount = 0;
+    uint32_t MemoryBarrierCount = 0;
+};
+
+// passes are declared every frame in execution order together with the resources they read and write.
+// Compile drops passes whose writes nobody reads (unless they have side effects or write imported
+// resources), hands transient textures out of a pool so textures with the same format and extent
+// share memory once their lifetimes stop overlapping, and works out the one glMemoryBarrier each pass
+// needs after incoherent image and storage buffer writes. attachments written through the graph get a
+// cached framebuffer. labels are referenced, not copied, and have to outlive the frame
+struct TRenderGraph {
+    auto Reset() -> void;
+
+    auto CreateTexture(const TRenderGraphTextureDescriptor& textureDescriptor) -> TRenderGraphResourceId;
+    auto ImportTexture(
+        std::string_view label,
+        const TTexture& texture) -> TRenderGraphResourceId;
+    auto ImportBuffer(
+        std::string_view label,
+        uint32_t buffer) -> TRenderGraphResourceId;
+
+    auto AddPass(
+        std::string_view label,
+        std::function<void()> execute) -> TRenderGraphPassId;
+    auto SetSideEffect(TRenderGraphPassId passId) -> void;
+    auto Read(
+        TRenderGraphPassId passId,
+        TRenderGraphResourceId resourceId,
+        TRenderGraphResourceUsage usage) -> void;
+    auto Write(
+        TRenderGraphPassId passId,
+        TRenderGraphResourceId resourceId,
+        TRenderGraphResourceUsage usage) -> void;
+    auto WriteColorAttachment(
+        TRenderGraphPassId passId,
+        TRenderGraphResourceId resourceId,
+        uint32_t colorAttachmentIndex,
+        TFramebufferAttachmentLoadOperation loadOperation,
+        const TFramebufferAttachmentClearColor& clearColor = {}) -> void;
+    auto WriteDepthStencilAttachment(
+        TRenderGraphPassId passId,
+        TRenderGraphResourceId resourceId,
+        TFramebufferAttachmentLoadOperation loadOperation,
+        const TFramebufferAttachmentClearDepthStencil& clearDepthStencil = {}) -> void;
+
+    auto Compile() -> void;
+    auto Execute() -> void;
+
+    // valid between Compile and the next Reset
+    auto IsPassCulled(TRenderGraphPassId passId) const -> bool;
+    auto GetTexture(TRenderGraphResourceId resourceId) const -> const TTexture&;
+    auto GetFramebuffer(TRenderGraphPassId passId) const -> const TFramebuffer&;
+    auto GetStatistics() const -> const TRenderGraphStatistics& { return Statistics; }
+
+    // deletes pooled textures and cached framebuffers, imported textures are left alone
+    auto Destroy() -> void;
+
+private:
+    struct TAccess {
+        TRenderGraphResourceId ResourceId = TRenderGraphResourceId::Invalid;
+        TRenderGraphResourceUsage Usage = {};
+        bool IsWrite = false;
+    };
+
+    struct TColorAttachment {
+        TRenderGraphResourceId ResourceId = TRenderGraphResourceId::Invalid;
+        TFramebufferAttachmentLoadOperation LoadOperation = {};
+        TFramebufferAttachmentClearColor ClearColor = {};
+    };
+
+    struct TDepthStencilAttachment {
+        TRenderGraphResourceId ResourceId = TRenderGraphResourceId::Invalid;
+        TFramebufferAttachmentLoadOperation LoadOperation = {};
+        TFramebufferAttachmentClearDepthStencil ClearDepthStencil = {};
+    };
+
+    struct TPass {
+        std::string_view Label = {};
+        std::function<void()> Execute = {};
+        std::vector<TAccess> Accesses = {};
+        std::array<std::optional<TColorAttachment>, 8> ColorAttachments = {};
+        std::optional<TDepthStencilAttachment> DepthStencilAttachment = {};
+        TFramebuffer Framebuffer = {};
+        TMemoryBarrierMask MemoryBarrierMask = {};
+        bool HasSideEffects = false;
+        bool IsCulled = false;
+    };
+
+    struct TResource {
+        TRenderGraphTextureDescriptor TextureDescriptor = {};
+        TTexture Texture = {};
+        uint32_t Buffer = 0;
+        uint32_t FirstPassIndex = 0;
+        uint32_t LastPassIndex = 0;
+        TMemoryBarrierMask IssuedMemoryBarrierMask = {};
+        bool IsTexture = false;
+        bool IsImported = false;
+        bool IsNeeded = false;
+        bool HasIncoherentWrite = false;
+    };
+
+    struct TPooledTexture {
+        TTextureId TextureId = TTextureId::Invalid;
+        TFormat Format = TFormat::Undefined;
+        TExtent2D Extent = {};
+        uint32_t MipMapLevels = 0;
+        uint32_t UnusedFrameCount = 0;
+        bool IsAcquired = false;
+        bool IsUsed = false;
+    };
+
+    struct TCachedFramebuffer {
+        std::array<uint32_t, 8> ColorTextures = {};
+        uint32_t DepthStencilTexture = 0;
+        TFramebuffer Framebuffer = {};
+        uint32_t UnusedFrameCount = 0;
+        bool IsUsed = false;
+    };
+
+    auto AcquireTexture(TResource& resource) -> void;
+    auto ResolveFramebuffer(TPass& pass) -> void;
+
+    std::vector<TPass> Passes;
+    uint32_t PassCount = 0;
+    std::vector<TResource> Resources;
+    std::vector<TPooledTexture> TexturePool;
+    std::vector<TCachedFramebuffer> FramebufferCache;
+    TRenderGraphStatistics Statistics = {};
+};
@@ -0,0 +1,114 @@
+#include "RenderQueue.hpp"
+
+#define POOLSTL_STD_SUPPLEMENT
+#include <poolstl/poolstl.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+constexpr auto RADIX_BITS = 8u;
+constexpr auto RADIX_SIZE = 1u << RADIX_BITS;
+constexpr auto RADIX_PASS_COUNT = 64u / RADIX_BITS;
+constexpr auto MIN_ITEMS_PER_CHUNK = 4096u;
+
+auto CreateSortKey(
+    const TRenderPass pass,
+    const TRenderPipeline pipeline,
+    const uint32_t material,
+    const uint32_t mesh,
+    const float depth) -> uint64_t {
+
+    // non negative floats keep their order when compared as integers, the top bits are enough for ordering
+    uint32_t depthBits = 0;
+    const auto clampedDepth = depth > 0.0f ? depth : 0.0f;
+    std::memcpy(&depthBits, &clampedDepth, sizeof(depthBits));
+    const auto quantizedDepth = depthBits >> (32u - SORT_KEY_DEPTH_BITS);
+
+    const auto mask = [](const uint32_t bits) { return (1ull << bits) - 1ull; };
+
+    auto sortKey = static_cast<uint64_t>(pass) & mask(SORT_KEY_PASS_BITS);
+    sortKey = (sortKey << SORT_KEY_PIPELINE_BITS) | (static_cast<uint64_t>(pipeline) & mask(SORT_KEY_PIPELINE_BITS));
+    sortKey = (sortKey << SORT_KEY_MATERIAL_BITS) | (material & mask(SORT_KEY_MATERIAL_BITS));
+    sortKey = (sortKey << SORT_KEY_MESH_BITS) | (mesh & mask(SORT_KEY_MESH_BITS));
+    sortKey = (sortKey << SORT_KEY_DEPTH_BITS) | (quantizedDepth & mask(SORT_KEY_DEPTH_BITS));
+    return sortKey;
+}
+
+auto GetSortKeyState(const uint64_t sortKey) -> uint64_t {
+
+    return sortKey >> SORT_KEY_STATE_SHIFT;
+}
+
+auto SortRenderQueue(std::vector<TRenderQueueItem>& renderQueue) -> void {
+
+    PROFILER_ZONESCOPEDN("SortRenderQueue");
+
+    const auto itemCount = renderQueue.size();
+    if (itemCount < 2) {
+        return;
+    }
+
+    const auto chunkCount = std::max<std::size_t>(1, std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()),
+        itemCount / MIN_ITEMS_PER_CHUNK));
+    const auto chunkSize = (itemCount + chunkCount - 1) / chunkCount;
+    const auto chunkIndices = std::ranges::iota_view{IndexZero, chunkCount};
+
+    std::vector<TRenderQueueItem> scratch(itemCount);
+    std::vector<std::array<std::size_t, RADIX_SIZE>> histograms(chunkCount);
+
+    auto* source = &renderQueue;
+    auto* destination = &scratch;
+
+    for (auto pass = 0u; pass < RADIX_PASS_COUNT; ++pass) {
+        const auto shift = pass * RADIX_BITS;
+
+        std::for_each(poolstl::execution::par, chunkIndices.begin(), chunkIndices.end(), [&](const std::size_t chunkIndex) {
+            auto& histogram = histograms[chunkIndex];
+            histogram.fill(0);
+
+            const auto begin = chunkIndex * chunkSize;
+            const auto end = std::min(begin + chunkSize, itemCount);
+            for (auto itemIndex = begin; itemIndex < end; ++itemIndex) {
+                histogram[((*source)[itemIndex].SortKey >> shift) & (RADIX_SIZE - 1)]++;
+            }
+        });
+
+        // turn the histograms into scatter offsets, digit major, chunk minor, which keeps the sort stable
+        std::size_t offset = 0;
+        auto isDigitShared = false;
+        for (auto digit = 0u; digit < RADIX_SIZE; ++digit) {
+            std::size_t digitCount = 0;
+            for (auto& histogram : histograms) {
+                const auto count = histogram[digit];
+                histogram[digit] = offset + digitCount;
+                digitCount += count;
+            }
+            isDigitShared |= digitCount == itemCount;
+            offset += digitCount;
+        }
+
+        // every key has the same digit here, scattering would only copy
+        if (isDigitShared) {
+            continue;
+        }
+
+        std::for_each(poolstl::execution::par, chunkIndices.begin(), chunkIndices.end(), [&](const std::size_t chunkIndex) {
+            auto& histogram = histograms[chunkIndex];
+
+            const auto begin = chunkIndex * chunkSize;
+            const auto end = std::min(begin + chunkSize, itemCount);
+            for (auto itemIndex = begin; itemIndex < end; ++itemIndex) {
+                const auto& item = (*source)[itemIndex];
+                (*destination)[histogram[(item.SortKey >> shift) & (RADIX_SIZE - 1)]++] = item;
+            }
+        });
+
+        std::swap(source, destination);
+    }
+
+    if (source != &renderQueue) {
+        renderQueue.swap(*source);
+    }
+}
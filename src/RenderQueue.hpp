@@ -0,0 +1,37 @@
+#pragma once
+
+enum class TRenderPass : uint32_t {
+    Opaque = 0,
+};
+
+enum class TRenderPipeline : uint32_t {
+    Default = 0,
+};
+
+// sort key layout, most significant first
+// | pass 4 | pipeline 4 | material 16 | mesh 16 | depth 24 |
+constexpr auto SORT_KEY_DEPTH_BITS = 24u;
+constexpr auto SORT_KEY_MESH_BITS = 16u;
+constexpr auto SORT_KEY_MATERIAL_BITS = 16u;
+constexpr auto SORT_KEY_PIPELINE_BITS = 4u;
+constexpr auto SORT_KEY_PASS_BITS = 4u;
+
+// the part of a key that decides pipeline state, draws only need a state change when it differs
+constexpr auto SORT_KEY_STATE_SHIFT = SORT_KEY_DEPTH_BITS + SORT_KEY_MESH_BITS + SORT_KEY_MATERIAL_BITS;
+
+struct TRenderQueueItem {
+    uint64_t SortKey;
+    uint32_t Index;
+};
+
+auto CreateSortKey(
+    TRenderPass pass,
+    TRenderPipeline pipeline,
+    uint32_t material,
+    uint32_t mesh,
+    float depth) -> uint64_t;
+
+auto GetSortKeyState(uint64_t sortKey) -> uint64_t;
+
+// stable, least significant digit first radix sort, histograms and scatters run on the thread pool
+auto SortRenderQueue(std::vector<TRenderQueueItem>& renderQueue) -> void;
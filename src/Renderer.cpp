@@ -1,8 +1,18 @@
 #include "Renderer.hpp"
 #include "RHI.hpp"
+#include "CommandList.hpp"
+#include "RenderGraph.hpp"
 #include "Components.hpp"
 #include "Assets.hpp"
 #include "Images.hpp"
+#include "Culling.hpp"
+#include "OcclusionCulling.hpp"
+#include "OffsetAllocator.hpp"
+#include "RenderQueue.hpp"
+#include "TextureStreaming.hpp"
+#include "VirtualTexture.hpp"
+#include "Cache.hpp"
+#include "Io.hpp"
 
 #include <glad/gl.h>
 #include <GLFW/glfw3.h>
@@ -34,6 +44,9 @@
 #define POOLSTL_STD_SUPPLEMENT
 #include <poolstl/poolstl.hpp>
 
+#include <cstring>
+#include <limits>
+
 enum class TImGuizmoOperation {
     Translate,
     Rotate,
@@ -73,9 +86,15 @@ struct TGpuGlobalLight {
     glm::ivec4 LightProperties; // IsEnabled, CanCastShadows, padding, padding
 };
 
-constexpr auto MAX_GLOBAL_LIGHTS = 8;
+// mirrors TGpuLocalLight in Include.LightClusters.glsl
+struct TGpuLocalLight {
+    glm::vec4 PositionAndRadius;
+    glm::vec4 ColorAndIntensity;
+    glm::vec4 DirectionAndType; // w = 0 point, 1 spot
+    glm::vec4 CosConeAngles; // x = cos inner, y = cos outer, padding, padding
+};
 
-entt::entity g_playerEntity = entt::null;
+constexpr auto MAX_GLOBAL_LIGHTS = 8;
 
 TWindowSettings g_windowSettings = {};
 
@@ -93,34 +112,45 @@ struct TDebugLinesPass {
     bool IsEnabled = true;
     std::vector<TGpuDebugLine> DebugLines;
     uint32_t InputLayout = 0;
-    uint32_t VertexBuffer = 0;
     TGraphicsPipeline Pipeline = {};
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
 } g_debugLinesPass;
 
 struct TDepthPrePass {
-    TFramebuffer Framebuffer = {};
     TGraphicsPipeline Pipeline = {};
+    TCommandList CommandList = {};
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
 } g_depthPrePass;
 
 struct TGeometryPass {
-    TFramebuffer Framebuffer = {};
     TGraphicsPipeline Pipeline = {};
+    TCommandList CommandList = {};
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
 } g_geometryPass;
 
+// flags the virtual texture pages the geometry pass is going to sample, at a fraction of its resolution
+struct TVirtualTextureFeedbackPass {
+    TGraphicsPipeline Pipeline = {};
+    TCommandList CommandList = {};
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
+} g_virtualTextureFeedbackPass;
+
 struct TComposePass {
-    TFramebuffer Framebuffer = {};
     TGraphicsPipeline Pipeline = {};
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
 } g_composePass;
 
 struct TFxaaPass {
-    TFramebuffer Framebuffer = {};
     TGraphicsPipeline Pipeline = {};
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
     bool IsEnabled = false;
 } g_fxaaPass;
 
+// the only screen sized targets which outlive a frame, everything else is transient in the render graph
 struct TTaaPass {
-    std::array<TFramebuffer, 2> Framebuffers = {};
+    std::array<TTextureId, 2> HistoryTextures = { TTextureId::Invalid, TTextureId::Invalid };
     TGraphicsPipeline Pipeline = {};
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
     size_t HistoryIndex = 0;
     TSamplerId Sampler = {};
     bool IsEnabled = true;
@@ -133,18 +163,108 @@ struct TShadowPass {
     std::array<TFramebuffer, MAX_GLOBAL_LIGHTS> Framebuffers = {};
     std::array<TTexture, MAX_GLOBAL_LIGHTS> ShadowMaps = {};
     TGraphicsPipeline Pipeline = {};
+    TCommandList CommandList = {};
     bool IsEnabled = true;
 } g_shadowPass;
 
+struct TCullingPass {
+    TComputePipeline Pipeline = {};
+    TComputePipeline BuildDrawCommandsPipeline = {};
+    uint32_t CullViewsBuffer = 0;
+    uint32_t InstanceCountsBuffer = 0;
+    uint32_t DrawCountsBuffer = 0;
+    bool IsEnabled = true;
+} g_cullingPass;
+
+// farthest depth pyramid of the depth pre-pass, the geometry pass only draws what it does not occlude
+struct THiZPass {
+    TComputePipeline Pipeline = {};
+    uint32_t MipLevelCount = 0;
+    bool IsEnabled = true;
+} g_hiZPass;
+
+constexpr auto MAX_LOCAL_LIGHTS = 4096;
+// mirrored in Include.LightClusters.glsl, the view frustum is cut into froxels of COUNT_X * COUNT_Y
+// screen tiles and COUNT_Z exponential depth slices
+constexpr auto LIGHT_CLUSTER_COUNT_X = 16u;
+constexpr auto LIGHT_CLUSTER_COUNT_Y = 9u;
+constexpr auto LIGHT_CLUSTER_COUNT_Z = 24u;
+constexpr auto LIGHT_CLUSTER_COUNT = LIGHT_CLUSTER_COUNT_X * LIGHT_CLUSTER_COUNT_Y * LIGHT_CLUSTER_COUNT_Z;
+constexpr auto LIGHT_CLUSTER_MAX_LIGHTS = 128u; // per cluster, the rest is dropped
+
+// bins point and spot lights into the froxels the depth pre-pass left something in, compose only
+// iterates the lights of the cluster a pixel falls into
+struct TLightClusterPass {
+    TComputePipeline Pipeline = {};
+    std::vector<TGpuLocalLight> LocalLights;
+    uint32_t LocalLightCount = 0;
+    TRingBufferAllocation LocalLightsAllocation = {};
+    uint32_t LightClustersBuffer = 0; // counts of all clusters, then LIGHT_CLUSTER_MAX_LIGHTS indices per cluster
+    TRenderGraphPassId GraphPass = TRenderGraphPassId::Invalid;
+} g_lightClusterPass;
+
+// gpu independent alternative, large occluders are rasterized on worker threads before culling is dispatched
+struct TCpuOcclusionPass {
+    TMaskedOcclusionBuffer Buffer = {};
+    std::vector<TOccluder> Occluders;
+    std::vector<TBoundingSphere> BoundingSpheres;
+    std::vector<uint8_t> IsVisible;
+    std::vector<uint32_t> VisibilityBits;
+    uint32_t VisibilityBuffer = 0;
+    bool IsEnabled = false;
+} g_cpuOcclusionPass;
+
+// what the passes of the current frame read and write, declared in BuildRenderGraph
+struct TRenderGraphResources {
+    TRenderGraphResourceId CulledDraws = TRenderGraphResourceId::Invalid;
+    std::array<TRenderGraphResourceId, MAX_GLOBAL_LIGHTS> ShadowMaps = {};
+    TRenderGraphResourceId Depth = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId HiZ = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId LightClusters = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId Albedo = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId Normals = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId Velocity = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId Emissive = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId AoRoughnessMetalness = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId VirtualTextureFeedback = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId VirtualTextureFeedbackDepth = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId Composed = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId Fxaa = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId TaaHistory = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId TaaOutput = TRenderGraphResourceId::Invalid;
+    TRenderGraphResourceId Output = TRenderGraphResourceId::Invalid;
+} g_renderGraphResources;
+
+TRenderGraph g_renderGraph = {};
+
+auto inline GetSceneViewerResource(const int32_t sceneViewerTextureIndex) -> TRenderGraphResourceId {
+    switch (sceneViewerTextureIndex) {
+        case 0: return g_renderGraphResources.Output;
+        case 1: return g_renderGraphResources.Depth;
+        case 2: return g_renderGraphResources.Albedo;
+        case 3: return g_renderGraphResources.Normals;
+        case 4: return g_renderGraphResources.Velocity;
+        case 5: return g_renderGraphResources.Emissive;
+        case 6: return g_renderGraphResources.Fxaa;
+        case 7: return g_renderGraphResources.AoRoughnessMetalness;
+        default: std::unreachable();
+    }
+}
+
+constexpr auto MAX_DEBUG_LINES = 16384;
+
+TRingBuffer g_frameRingBuffer = {};
+
 std::array<TGpuGlobalLight, MAX_GLOBAL_LIGHTS> g_gpuGlobalLights;
-uint32_t g_globalLightsBuffer = {};
+uint32_t g_gpuGlobalLightCount = 0; // compose does not look past these
+TRingBufferAllocation g_globalLightsAllocation = {};
 
 TGpuGlobalUniforms g_globalUniforms = {};
 glm::mat4 g_previousViewMatrix = {};
 glm::mat4 g_previousJitteredProjectionMatrix = {};
 glm::mat4 g_currentJitteredProjectionMatrix = {};
 
-uint32_t g_globalUniformsBuffer = {};
+TRingBufferAllocation g_globalUniformsAllocation = {};
 uint32_t g_objectsBuffer = {};
 glm::vec3 g_sunPosition = glm::vec3{100, 110, 120};
 
@@ -244,18 +364,35 @@ struct TGpuVertexPositionColor {
 
 struct TGpuMesh {
     std::string_view Name;
-    uint32_t VertexPositionBuffer;
-    uint32_t VertexNormalUvTangentBuffer;
-    uint32_t IndexBuffer;
+    uint32_t Index;
+    TOffsetAllocation VertexAllocation; // in vertices, into g_geometryBuffers' vertex buffers
+    TOffsetAllocation IndexAllocation; // in indices, into g_geometryBuffers' index buffer
 
     size_t VertexCount;
     size_t IndexCount;
 
     glm::mat4 InitialTransform;
+
+    TBoundingBox BoundingBox;
+    TBoundingSphere BoundingSphere;
+
+    float UvDensity; // sqrt of uv area per world area, uv units per world unit along an average edge
 };
 
+constexpr auto MAX_GEOMETRY_VERTICES = 4 * 1024 * 1024;
+constexpr auto MAX_GEOMETRY_INDICES = 16 * 1024 * 1024;
+
+// all meshes live in these, so draws never switch vertex or index buffers
+struct TGeometryBuffers {
+    uint32_t VertexPositionBuffer = 0;
+    uint32_t VertexNormalUvTangentBuffer = 0;
+    uint32_t IndexBuffer = 0;
+    TOffsetAllocator VertexAllocator = {};
+    TOffsetAllocator IndexAllocator = {};
+} g_geometryBuffers;
+
 struct TCpuTexture {
-    uint32_t Id;
+    TStreamedTextureId StreamedTextureId;
     std::optional<uint32_t> SamplerId;
     std::optional<uint64_t> BindlessHandle;
 };
@@ -265,6 +402,7 @@ enum TCpuTextureFlag {
     HasNormal = 1 << 1,
     HasArm = 1 << 2,
     HasEmissive = 1 << 3,
+    HasVirtualBaseColor = 1 << 4,
 };
 
 struct TCpuMaterial {
@@ -279,20 +417,24 @@ struct TCpuMaterial {
     TCpuTexture EmissiveTexture;
 
     uint32_t HasTextureFlags = 0;
+    uint32_t GpuMaterialIndex = 0;
+    TVirtualTextureId VirtualBaseColorTexture = TVirtualTextureId::Invalid;
 };
 
+// mirrors TGpuMaterial in Geometry.fs.glsl
 struct TGpuMaterial {
     glm::vec4 BaseColor;
-    glm::vec4 Factors; // use .x = normal strength .y = metalness, .z = roughness, .w = emission strength
+    glm::vec4 Factors; // use .x = normal strength, .y = roughness, .z = metalness, .w = emissive strength
+    glm::vec4 EmissiveColor;
 
     uint64_t BaseColorTexture;
     uint64_t NormalTexture;
+    uint64_t ArmTexture; // holds the metallic roughness texture when there is no arm texture
+    uint64_t MetallicRoughnessTexture;
 
-    uint64_t ArmTexture;
     uint64_t EmissiveTexture;
-
-    uint64_t MetallicRoughnessTexture;
-    uint64_t _padding1;
+    uint32_t TextureFlags;
+    uint32_t VirtualTexture; // with TCpuTextureFlag::HasVirtualBaseColor
 };
 
 struct TCpuGlobalLight {
@@ -315,60 +457,215 @@ bool g_globalLightsWasModified = true;
 std::unordered_map<std::string, TGpuMesh> g_gpuMeshes = {};
 std::unordered_map<std::string, TSampler> g_gpuSamplers = {};
 std::unordered_map<std::string, TCpuMaterial> g_cpuMaterials = {};
-std::unordered_map<std::string, TGpuMaterial> g_gpuMaterials = {};
 
-auto ComputeIrradianceMap(const TTextureId textureId) -> std::expected<TTextureId, std::string> {
+constexpr auto MAX_GPU_MATERIALS = 4096;
+
+// material index 0 is the default material for renderables without one
+std::vector<TGpuMaterial> g_gpuMaterials = {};
+uint32_t g_gpuMaterialsBuffer = {};
+
+// material textures start with their mip tail and get finer mips streamed in as the camera comes close
+TTextureStreamer g_textureStreamer;
+
+// where a streamed texture's bindless handle lives, so it can be patched when the streamer reallocates it
+struct TStreamedTextureBinding {
+    uint32_t GpuMaterialIndex = 0;
+    std::vector<uint64_t TGpuMaterial::*> Handles;
+};
+
+std::vector<TStreamedTextureBinding> g_streamedTextureBindings = {}; // indexed by TStreamedTextureId
+std::vector<std::vector<TStreamedTextureId>> g_gpuMaterialStreamedTextures = {}; // indexed by gpu material
+
+// planet base colors, only the pages the feedback pass sees are resident
+TVirtualTextureSystem g_virtualTextures;
+
+constexpr auto MAX_GPU_OBJECTS = 16384;
+constexpr auto CULL_VIEW_COUNT = 2 + MAX_GLOBAL_LIGHTS; // camera first, then one view per global light, then the camera again with occlusion culling
+constexpr auto CULL_VIEW_OCCLUDED_CAMERA = CULL_VIEW_COUNT - 1;
+constexpr auto DEPTH_BUCKET_COUNT = 4; // survivors are binned by distance on the gpu and drawn near to far, see CullObjects.cs.glsl
 
-    auto computeIrradianceMapComputePipelineResult = CreateComputePipeline(TComputePipelineDescriptor{
+struct TGpuDrawRecord {
+    glm::vec4 LocalBoundingSphere; // xyz = center, w = radius
+    uint32_t InstanceGroupIndex;
+    uint32_t InstanceGroupFirstObject;
+    uint32_t _padding1;
+    uint32_t _padding2;
+};
+
+// objects sharing mesh and material, drawn with a single instanced command per view and depth bucket
+struct TGpuInstanceGroup {
+    uint32_t IndexCount;
+    uint32_t FirstIndex;
+    int32_t BaseVertex;
+    uint32_t FirstObject;
+    uint32_t BatchIndex;
+    uint32_t BatchFirstInstanceGroup;
+    uint32_t _padding1;
+    uint32_t _padding2;
+};
+
+struct TGpuCullView {
+    glm::mat4 ViewProjection;
+    std::array<glm::vec4, 6> Planes;
+    glm::uvec4 Properties; // IsEnabled, IsCullingEnabled, IsOcclusionCullingEnabled, padding
+};
+
+// a run of the render queue sharing the state part of the sort key,
+// each batch owns the command slice [FirstInstanceGroup, FirstInstanceGroup + InstanceGroupCount) of every view and depth bucket
+struct TDrawBatch {
+    uint64_t State = 0;
+    uint32_t FirstInstanceGroup = 0;
+    uint32_t InstanceGroupCount = 0;
+};
+
+struct TIndirectDrawData {
+    std::vector<TGpuObject> Objects;
+    std::vector<TGpuDrawRecord> DrawRecords;
+    std::vector<TGpuInstanceGroup> InstanceGroups;
+    std::vector<TDrawBatch> Batches;
+    std::array<TGpuCullView, CULL_VIEW_COUNT> CullViews = {};
+    std::vector<uint32_t> RenderableObjectIndices; // snapshot renderable -> object
+    std::vector<float> ObjectUvDensities; // per object, see TGpuMesh::UvDensity
+    uint32_t FirstDirtyObject = std::numeric_limits<uint32_t>::max();
+    uint32_t LastDirtyObject = 0;
+    bool IsDirty = true;
+    uint32_t DrawRecordsBuffer = 0;
+    uint32_t InstanceGroupsBuffer = 0;
+    uint32_t InstanceIndicesBuffer = 0;
+    uint32_t CommandBuffer = 0;
+} g_indirectDrawData;
+
+auto inline MarkGpuObjectDirty(
+    const uint32_t objectIndex,
+    const glm::mat4& worldMatrix) -> void {
+
+    if (objectIndex >= g_indirectDrawData.Objects.size()) {
+        return;
+    }
+
+    g_indirectDrawData.Objects[objectIndex].WorldMatrix = worldMatrix;
+    g_indirectDrawData.FirstDirtyObject = std::min(g_indirectDrawData.FirstDirtyObject, objectIndex);
+    g_indirectDrawData.LastDirtyObject = std::max(g_indirectDrawData.LastDirtyObject, objectIndex);
+}
+
+constexpr auto COMPUTE_IRRADIANCE_MAP_SHADER_FILE_PATH = "data/shaders/ComputeIrradianceMap.cs.glsl";
+constexpr auto COMPUTE_PREFILTERED_RADIANCE_MAP_SHADER_FILE_PATH = "data/shaders/ComputePrefilteredRadianceMap.cs.glsl";
+constexpr auto COMPUTE_BRDF_LUT_SHADER_FILE_PATH = "data/shaders/ComputeBrdfLut.cs.glsl";
+
+constexpr auto IRRADIANCE_MAP_SIZE = 64u;
+constexpr auto PREFILTERED_RADIANCE_MAP_SIZE = 512u;
+constexpr auto BRDF_LUT_SIZE = 512u;
+
+constexpr auto ENVIRONMENT_MAPS_CACHE_CATEGORY = "environment";
+// bump when the layout of cached environment maps changes
+constexpr auto ENVIRONMENT_MAPS_CACHE_VERSION = 1u;
+
+struct TEnvironmentMapTextures {
+    TTextureId EnvironmentMap = TTextureId::Invalid;
+    TTextureId IrradianceMap = TTextureId::Invalid;
+    TTextureId PrefilteredRadianceMap = TTextureId::Invalid;
+    TTextureId BrdfLut = TTextureId::Invalid;
+};
+
+struct TEnvironmentMapsCacheHeader {
+    uint32_t EnvironmentMapWidth = 0;
+    uint32_t EnvironmentMapHeight = 0;
+};
+
+auto GetMipMapLevelCount(const TExtent2D extent) -> uint32_t {
+    return 1 + static_cast<uint32_t>(glm::floor(glm::log2(glm::max(static_cast<float>(extent.Width), static_cast<float>(extent.Height)))));
+}
+
+auto CreateEnvironmentMapTextures(
+    const std::string& skyBoxName,
+    const TExtent2D environmentMapExtent) -> TEnvironmentMapTextures {
+
+    return TEnvironmentMapTextures{
+        .EnvironmentMap = CreateTexture(TCreateTextureDescriptor{
+            .TextureType = TTextureType::TextureCube,
+            .Format = TFormat::R8G8B8A8_SRGB,
+            .Extent = TExtent3D{environmentMapExtent.Width, environmentMapExtent.Height, 1u},
+            .MipMapLevels = GetMipMapLevelCount(environmentMapExtent),
+            .Layers = 6,
+            .SampleCount = TSampleCount::One,
+            .Label = std::format("TextureCube-{}x{}-{}", environmentMapExtent.Width, environmentMapExtent.Height, skyBoxName),
+        }),
+        .IrradianceMap = CreateTexture(TCreateTextureDescriptor{
+            .TextureType = TTextureType::TextureCube,
+            .Format = TFormat::R16G16B16A16_FLOAT,
+            .Extent = TExtent3D(IRRADIANCE_MAP_SIZE, IRRADIANCE_MAP_SIZE, 1),
+            .MipMapLevels = 1,
+            .Layers = 1,
+            .SampleCount = TSampleCount::One,
+            .Label = std::format("TextureCube-{}x{}-Irradiance", IRRADIANCE_MAP_SIZE, IRRADIANCE_MAP_SIZE),
+        }),
+        .PrefilteredRadianceMap = CreateTexture(TCreateTextureDescriptor{
+            .TextureType = TTextureType::TextureCube,
+            .Format = TFormat::R16G16B16A16_FLOAT,
+            .Extent = TExtent3D(PREFILTERED_RADIANCE_MAP_SIZE, PREFILTERED_RADIANCE_MAP_SIZE, 1),
+            .MipMapLevels = GetMipMapLevelCount(TExtent2D{PREFILTERED_RADIANCE_MAP_SIZE, PREFILTERED_RADIANCE_MAP_SIZE}),
+            .Layers = 1,
+            .SampleCount = TSampleCount::One,
+            .Label = std::format("TextureCube-{}x{}-PrefilteredRadiance", PREFILTERED_RADIANCE_MAP_SIZE, PREFILTERED_RADIANCE_MAP_SIZE),
+        }),
+        .BrdfLut = CreateTexture(TCreateTextureDescriptor{
+            .TextureType = TTextureType::Texture2D,
+            .Format = TFormat::R16G16_FLOAT,
+            .Extent = TExtent3D(BRDF_LUT_SIZE, BRDF_LUT_SIZE, 1),
+            .MipMapLevels = 1,
+            .Layers = 1,
+            .SampleCount = TSampleCount::One,
+            .Label = std::format("Texture2D-{}x{}-BrdfLut", BRDF_LUT_SIZE, BRDF_LUT_SIZE),
+        }),
+    };
+}
+
+auto GetEnvironmentMapTextureLevels(const TEnvironmentMapTextures& environmentMapTextures) -> std::array<std::pair<TTextureId, uint32_t>, 4> {
+
+    return {
+        std::pair{environmentMapTextures.EnvironmentMap, GetMipMapLevelCount(GetTexture(environmentMapTextures.EnvironmentMap).Extent)},
+        std::pair{environmentMapTextures.IrradianceMap, 1u},
+        std::pair{environmentMapTextures.PrefilteredRadianceMap, GetMipMapLevelCount(GetTexture(environmentMapTextures.PrefilteredRadianceMap).Extent)},
+        std::pair{environmentMapTextures.BrdfLut, 1u},
+    };
+}
+
+auto ComputeIrradianceMap(const TEnvironmentMapTextures& environmentMapTextures) -> std::expected<void, std::string> {
+
+    auto computeIrradianceMapComputePipelineResult = GetOrCreateComputePipeline(TComputePipelineDescriptor{
         .Label = "Compute Irradiance Map",
-        .ComputeShaderFilePath = "data/shaders/ComputeIrradianceMap.cs.glsl",
+        .ComputeShaderFilePath = COMPUTE_IRRADIANCE_MAP_SHADER_FILE_PATH,
     });
 
     if (!computeIrradianceMapComputePipelineResult) {
         return std::unexpected(computeIrradianceMapComputePipelineResult.error());
     }
 
-    const auto& environmentTexture = GetTexture(textureId);
-
     auto computeIrradianceMapComputePipeline = *computeIrradianceMapComputePipelineResult;
+    if (auto resolvePipelinesResult = ResolvePipelines({&computeIrradianceMapComputePipeline}); !resolvePipelinesResult) {
+        return std::unexpected(resolvePipelinesResult.error());
+    }
 
-    constexpr auto width = 64;
-    constexpr auto height = 64;
-    constexpr auto format = TFormat::R16G16B16A16_FLOAT;
-
-    auto convolvedTextureId = CreateTexture(TCreateTextureDescriptor{
-        .TextureType = TTextureType::TextureCube,
-        .Format = format,
-        .Extent = TExtent3D(width, height, 1),
-        .MipMapLevels = 1,
-        .Layers = 1,
-        .SampleCount = TSampleCount::One,
-        .Label = std::format("TextureCube-{}x{}-Irradiance", width, height),
-    });
-
-    const auto& convolvedTexture = GetTexture(convolvedTextureId);
+    const auto& environmentTexture = GetTexture(environmentMapTextures.EnvironmentMap);
+    const auto& convolvedTexture = GetTexture(environmentMapTextures.IrradianceMap);
 
-    constexpr auto groupX = static_cast<uint32_t>((width + 31) / 32);
-    constexpr auto groupY = static_cast<uint32_t>((height + 31) / 32);
+    constexpr auto groupX = (IRRADIANCE_MAP_SIZE + 31) / 32;
+    constexpr auto groupY = (IRRADIANCE_MAP_SIZE + 31) / 32;
     constexpr auto groupZ = 6u;
 
     computeIrradianceMapComputePipeline.Bind();
     computeIrradianceMapComputePipeline.BindTexture(0, environmentTexture.Id);
-    computeIrradianceMapComputePipeline.BindImage(0, convolvedTexture.Id, 0, 0, TMemoryAccess::WriteOnly, format);
+    computeIrradianceMapComputePipeline.BindImage(0, convolvedTexture.Id, 0, 0, TMemoryAccess::WriteOnly, convolvedTexture.Format);
     computeIrradianceMapComputePipeline.Dispatch(groupX, groupY, groupZ);
-    computeIrradianceMapComputePipeline.InsertMemoryBarrier(TMemoryBarrierMaskBits::All);
-    GenerateMipmaps(convolvedTextureId);
 
-    return convolvedTextureId;
+    return {};
 }
 
-auto ComputePrefilteredRadianceMap(
-    const TTextureId environmentMapTextureId,
-    const int32_t prefilteredMapBaseSize = 512) -> std::expected<TTextureId, std::string> {
+auto ComputePrefilteredRadianceMap(const TEnvironmentMapTextures& environmentMapTextures) -> std::expected<void, std::string> {
 
-    auto computePrefilteredRadianceMapComputePipelineResult = CreateComputePipeline(TComputePipelineDescriptor{
+    auto computePrefilteredRadianceMapComputePipelineResult = GetOrCreateComputePipeline(TComputePipelineDescriptor{
         .Label = "Compute Prefiltered Radiance Map",
-        .ComputeShaderFilePath = "data/shaders/ComputePrefilteredRadianceMap.cs.glsl",
+        .ComputeShaderFilePath = COMPUTE_PREFILTERED_RADIANCE_MAP_SHADER_FILE_PATH,
     });
 
     if (!computePrefilteredRadianceMapComputePipelineResult) {
@@ -376,45 +673,63 @@ auto ComputePrefilteredRadianceMap(
     }
 
     auto computePrefilteredRadianceMapComputePipeline = *computePrefilteredRadianceMapComputePipelineResult;
+    if (auto resolvePipelinesResult = ResolvePipelines({&computePrefilteredRadianceMapComputePipeline}); !resolvePipelinesResult) {
+        return std::unexpected(resolvePipelinesResult.error());
+    }
 
-    const auto maxMipLevels = 1 + static_cast<uint32_t>(glm::floor(glm::log2(static_cast<float>(prefilteredMapBaseSize))));
-    constexpr auto format = TFormat::R16G16B16A16_FLOAT;
-
-    auto prefilteredEnvironmentMapId = CreateTexture(TCreateTextureDescriptor{
-        .TextureType = TTextureType::TextureCube,
-        .Format = format,
-        .Extent = TExtent3D(prefilteredMapBaseSize, prefilteredMapBaseSize, 1),
-        .MipMapLevels = maxMipLevels,
-        .Layers = 1,
-        .SampleCount = TSampleCount::One,
-        .Label = std::format("TextureCube-{}x{}-PrefilteredRadiance", prefilteredMapBaseSize, prefilteredMapBaseSize),
-    });
-
-    const auto& environmentTexture = GetTexture(environmentMapTextureId);
-    const auto& prefilteredEnvironmentMap = GetTexture(prefilteredEnvironmentMapId);
+    const auto& environmentTexture = GetTexture(environmentMapTextures.EnvironmentMap);
+    const auto& prefilteredEnvironmentMap = GetTexture(environmentMapTextures.PrefilteredRadianceMap);
+    const auto maxMipLevels = GetMipMapLevelCount(prefilteredEnvironmentMap.Extent);
 
     computePrefilteredRadianceMapComputePipeline.Bind();
     computePrefilteredRadianceMapComputePipeline.BindTexture(0, environmentTexture.Id);
 
     for (auto mipLevel = 0; mipLevel < maxMipLevels; mipLevel++) {
-        const auto mipSize = prefilteredMapBaseSize >> mipLevel;
+        const auto mipSize = PREFILTERED_RADIANCE_MAP_SIZE >> mipLevel;
         const auto roughness = static_cast<float>(mipLevel) / static_cast<float>(maxMipLevels - 1);
 
-        computePrefilteredRadianceMapComputePipeline.BindImage(0, prefilteredEnvironmentMap.Id, mipLevel, 0, TMemoryAccess::WriteOnly, format);
+        computePrefilteredRadianceMapComputePipeline.BindImage(0, prefilteredEnvironmentMap.Id, mipLevel, 0, TMemoryAccess::WriteOnly, prefilteredEnvironmentMap.Format);
         computePrefilteredRadianceMapComputePipeline.SetUniform(0, roughness);
 
         const auto numGroups = (mipSize + 31) / 32;
         computePrefilteredRadianceMapComputePipeline.Dispatch(numGroups, numGroups, 6u);
+    }
+
+    return {};
+}
+
+// split sum scale and bias over (NdotV, roughness), replaces the 8 bit lut which was sampled as srgb
+auto ComputeBrdfLut(const TEnvironmentMapTextures& environmentMapTextures) -> std::expected<void, std::string> {
+
+    auto computeBrdfLutComputePipelineResult = GetOrCreateComputePipeline(TComputePipelineDescriptor{
+        .Label = "Compute Brdf Lut",
+        .ComputeShaderFilePath = COMPUTE_BRDF_LUT_SHADER_FILE_PATH,
+    });
+
+    if (!computeBrdfLutComputePipelineResult) {
+        return std::unexpected(computeBrdfLutComputePipelineResult.error());
+    }
 
-        computePrefilteredRadianceMapComputePipeline.InsertMemoryBarrier(TMemoryBarrierMaskBits::All);
+    auto computeBrdfLutComputePipeline = *computeBrdfLutComputePipelineResult;
+    if (auto resolvePipelinesResult = ResolvePipelines({&computeBrdfLutComputePipeline}); !resolvePipelinesResult) {
+        return std::unexpected(resolvePipelinesResult.error());
     }
 
-    return prefilteredEnvironmentMapId;
+    const auto& brdfLut = GetTexture(environmentMapTextures.BrdfLut);
+
+    constexpr auto groupX = (BRDF_LUT_SIZE + 31) / 32;
+    constexpr auto groupY = (BRDF_LUT_SIZE + 31) / 32;
+
+    computeBrdfLutComputePipeline.Bind();
+    computeBrdfLutComputePipeline.BindImage(0, brdfLut.Id, 0, 0, TMemoryAccess::WriteOnly, brdfLut.Format);
+    computeBrdfLutComputePipeline.Dispatch(groupX, groupY, 1);
+
+    return {};
 }
 
 auto ComputeSHCoefficients(const TTextureId irradianceMapTextureId) -> std::expected<uint32_t, std::string> {
 
-    auto computeSHCoefficientsComputePipelineResult = CreateComputePipeline(TComputePipelineDescriptor{
+    auto computeSHCoefficientsComputePipelineResult = GetOrCreateComputePipeline(TComputePipelineDescriptor{
         .Label = "Compute SH Coefficients",
         .ComputeShaderFilePath = "data/shaders/ComputeSHCoefficients.cs.glsl",
     });
@@ -424,6 +739,10 @@ auto ComputeSHCoefficients(const TTextureId irradianceMapTextureId) -> std::expe
     }
 
     auto computeSHCoefficientsComputePipeline = *computeSHCoefficientsComputePipelineResult;
+    if (auto resolvePipelinesResult = ResolvePipelines({&computeSHCoefficientsComputePipeline}); !resolvePipelinesResult) {
+        return std::unexpected(resolvePipelinesResult.error());
+    }
+
     auto shCoefficientBuffer = CreateBuffer("CoefficientBuffer", sizeof(float) * 3 * 9, nullptr, GL_DYNAMIC_STORAGE_BIT);
     constexpr auto zeroValue = 0.0f;
     UpdateBuffer(shCoefficientBuffer, 0, sizeof(float) * 3 * 9, &zeroValue);
@@ -445,20 +764,119 @@ auto ComputeSHCoefficients(const TTextureId irradianceMapTextureId) -> std::expe
     return shCoefficientBuffer;
 }
 
-auto LoadEnvironmentMaps(const std::string& skyBoxName) -> std::expected<TEnvironmentMaps, std::string> {
+// environment maps depend on the sky images and the shaders deriving the ibl maps from them
+auto GetEnvironmentMapsCacheKey(const std::array<std::string, 6>& skyBoxNames) -> std::expected<uint64_t, std::string> {
 
-    TEnvironmentMaps environmentMaps = {};
+    PROFILER_ZONESCOPEDN("GetEnvironmentMapsCacheKey");
 
-    const std::array<std::string, 6> skyBoxNames = {
-        std::format("data/sky/TC_{}_Xp.png", skyBoxName),
-        std::format("data/sky/TC_{}_Xn.png", skyBoxName),
-        std::format("data/sky/TC_{}_Yp.png", skyBoxName),
-        std::format("data/sky/TC_{}_Yn.png", skyBoxName),
-        std::format("data/sky/TC_{}_Zp.png", skyBoxName),
-        std::format("data/sky/TC_{}_Zn.png", skyBoxName),
+    auto cacheKey = Cache::HashBytes(std::as_bytes(std::span(&ENVIRONMENT_MAPS_CACHE_VERSION, 1)));
+
+    for (const auto shaderFilePath : {COMPUTE_IRRADIANCE_MAP_SHADER_FILE_PATH, COMPUTE_PREFILTERED_RADIANCE_MAP_SHADER_FILE_PATH, COMPUTE_BRDF_LUT_SHADER_FILE_PATH}) {
+        const auto shaderSourceHashResult = GetShaderSourceHash(shaderFilePath);
+        if (!shaderSourceHashResult) {
+            return std::unexpected(shaderSourceHashResult.error());
+        }
+        cacheKey = Cache::HashBytes(std::as_bytes(std::span(&*shaderSourceHashResult, 1)), cacheKey);
+    }
+
+    for (const auto& skyBoxImageName : skyBoxNames) {
+        if (!std::filesystem::exists(skyBoxImageName)) {
+            return std::unexpected(std::format("Sky image {} does not exist", skyBoxImageName));
+        }
+        const auto [imageFileData, imageFileSize] = ReadBinaryFromFile(skyBoxImageName);
+        cacheKey = Cache::HashBytes(std::span(imageFileData.get(), imageFileSize), cacheKey);
+    }
+
+    return cacheKey;
+}
+
+auto LoadEnvironmentMapsFromCache(
+    const std::string& skyBoxName,
+    const uint64_t cacheKey) -> std::optional<TEnvironmentMapTextures> {
+
+    PROFILER_ZONESCOPEDN("LoadEnvironmentMapsFromCache");
+
+    const auto cachedEnvironmentMaps = Cache::Load(ENVIRONMENT_MAPS_CACHE_CATEGORY, cacheKey);
+    if (!cachedEnvironmentMaps || (*cachedEnvironmentMaps).size() < sizeof(TEnvironmentMapsCacheHeader)) {
+        return std::nullopt;
+    }
+
+    TEnvironmentMapsCacheHeader environmentMapsCacheHeader = {};
+    std::memcpy(&environmentMapsCacheHeader, (*cachedEnvironmentMaps).data(), sizeof(TEnvironmentMapsCacheHeader));
+
+    const auto environmentMapTextures = CreateEnvironmentMapTextures(skyBoxName, TExtent2D{
+        environmentMapsCacheHeader.EnvironmentMapWidth,
+        environmentMapsCacheHeader.EnvironmentMapHeight
+    });
+    const auto environmentMapTextureLevels = GetEnvironmentMapTextureLevels(environmentMapTextures);
+
+    auto cachedSizeInBytes = sizeof(TEnvironmentMapsCacheHeader);
+    for (const auto& [textureId, mipMapLevels] : environmentMapTextureLevels) {
+        for (auto level = 0u; level < mipMapLevels; ++level) {
+            cachedSizeInBytes += GetTextureLevelSizeInBytes(textureId, level);
+        }
+    }
+
+    if (cachedSizeInBytes != (*cachedEnvironmentMaps).size()) {
+        for (const auto& [textureId, mipMapLevels] : environmentMapTextureLevels) {
+            DeleteTexture(textureId);
+        }
+        return std::nullopt;
+    }
+
+    // every level was written in the format UploadTexture expects, mips included
+    auto offset = sizeof(TEnvironmentMapsCacheHeader);
+    for (const auto& [textureId, mipMapLevels] : environmentMapTextureLevels) {
+        for (auto level = 0u; level < mipMapLevels; ++level) {
+            UploadTexture(textureId, TUploadTextureDescriptor{
+                .Level = level,
+                .Offset = TOffset3D{0, 0, 0},
+                .Extent = GetTextureLevelExtent(textureId, level),
+                .UploadFormat = TUploadFormat::Auto,
+                .UploadType = TUploadType::Auto,
+                .PixelData = (*cachedEnvironmentMaps).data() + offset
+            });
+            offset += GetTextureLevelSizeInBytes(textureId, level);
+        }
+    }
+
+    return environmentMapTextures;
+}
+
+auto StoreEnvironmentMapsInCache(
+    const TEnvironmentMapTextures& environmentMapTextures,
+    const uint64_t cacheKey) -> void {
+
+    PROFILER_ZONESCOPEDN("StoreEnvironmentMapsInCache");
+
+    const auto& environmentMap = GetTexture(environmentMapTextures.EnvironmentMap);
+    const auto environmentMapsCacheHeader = TEnvironmentMapsCacheHeader{
+        .EnvironmentMapWidth = environmentMap.Extent.Width,
+        .EnvironmentMapHeight = environmentMap.Extent.Height,
     };
 
-    TTextureId environmentMapId = {};
+    auto environmentMapsData = std::vector<std::byte>(sizeof(TEnvironmentMapsCacheHeader));
+    std::memcpy(environmentMapsData.data(), &environmentMapsCacheHeader, sizeof(TEnvironmentMapsCacheHeader));
+
+    for (const auto& [textureId, mipMapLevels] : GetEnvironmentMapTextureLevels(environmentMapTextures)) {
+        for (auto level = 0u; level < mipMapLevels; ++level) {
+            const auto offset = environmentMapsData.size();
+            const auto levelSizeInBytes = GetTextureLevelSizeInBytes(textureId, level);
+            environmentMapsData.resize(offset + levelSizeInBytes);
+            DownloadTexture(textureId, level, std::span(environmentMapsData).subspan(offset, levelSizeInBytes));
+        }
+    }
+
+    Cache::Store(ENVIRONMENT_MAPS_CACHE_CATEGORY, cacheKey, environmentMapsData);
+}
+
+auto ComputeEnvironmentMaps(
+    const std::string& skyBoxName,
+    const std::array<std::string, 6>& skyBoxNames) -> std::expected<TEnvironmentMapTextures, std::string> {
+
+    PROFILER_ZONESCOPEDN("ComputeEnvironmentMaps");
+
+    auto environmentMapTextures = TEnvironmentMapTextures{};
 
     for (auto imageIndex = 0; imageIndex < skyBoxNames.size(); imageIndex++) {
 
@@ -469,18 +887,13 @@ auto LoadEnvironmentMaps(const std::string& skyBoxName) -> std::expected<TEnviro
         const auto imageData = Image::LoadImageFromFile(imageName, &imageWidth, &imageHeight, &imageComponents);
 
         if (imageIndex == 0) {
-            environmentMapId = CreateTexture(TCreateTextureDescriptor{
-                .TextureType = TTextureType::TextureCube,
-                .Format = TFormat::R8G8B8A8_SRGB,
-                .Extent = TExtent3D{ static_cast<uint32_t>(imageWidth), static_cast<uint32_t>(imageHeight), 1u},
-                .MipMapLevels = 1 + static_cast<uint32_t>(glm::floor(glm::log2(glm::max(static_cast<float>(imageWidth), static_cast<float>(imageHeight))))),
-                .Layers = 6,
-                .SampleCount = TSampleCount::One,
-                .Label = std::format("TextureCube-{}x{}-{}", imageWidth, imageHeight, skyBoxName),
+            environmentMapTextures = CreateEnvironmentMapTextures(skyBoxName, TExtent2D{
+                static_cast<uint32_t>(imageWidth),
+                static_cast<uint32_t>(imageHeight)
             });
         }
 
-        UploadTexture(environmentMapId, TUploadTextureDescriptor{
+        UploadTexture(environmentMapTextures.EnvironmentMap, TUploadTextureDescriptor{
             .Level = 0,
             .Offset = TOffset3D{0, 0, static_cast<uint32_t>(imageIndex)},
             .Extent = TExtent3D{static_cast<uint32_t>(imageWidth), static_cast<uint32_t>(imageHeight), 1u},
@@ -492,31 +905,61 @@ auto LoadEnvironmentMaps(const std::string& skyBoxName) -> std::expected<TEnviro
         Image::FreeImage(imageData);
     }
 
-    GenerateMipmaps(environmentMapId);
+    GenerateMipmaps(environmentMapTextures.EnvironmentMap);
 
-    environmentMaps.EnvironmentMap = GetTexture(environmentMapId).Id;
-
-    const auto computeIrradianceMapResult = ComputeIrradianceMap(environmentMapId);
-    if (!computeIrradianceMapResult) {
+    if (const auto computeIrradianceMapResult = ComputeIrradianceMap(environmentMapTextures); !computeIrradianceMapResult) {
         return std::unexpected(std::format("Unable to compute irradiance map from environment map {}", computeIrradianceMapResult.error()));
     }
-    environmentMaps.IrradianceMap = GetTexture(*computeIrradianceMapResult).Id;
 
-    const auto computePrefilteredRadianceMapResult = ComputePrefilteredRadianceMap(environmentMapId);
-    if (!computePrefilteredRadianceMapResult) {
+    if (const auto computePrefilteredRadianceMapResult = ComputePrefilteredRadianceMap(environmentMapTextures); !computePrefilteredRadianceMapResult) {
         return std::unexpected(std::format("Unable to compute prefiltered radiance map from environment map {}", computePrefilteredRadianceMapResult.error()));
     }
 
-    environmentMaps.PrefilteredRadianceMap = GetTexture(*computePrefilteredRadianceMapResult).Id;
+    if (const auto computeBrdfLutResult = ComputeBrdfLut(environmentMapTextures); !computeBrdfLutResult) {
+        return std::unexpected(std::format("Unable to compute brdf lut {}", computeBrdfLutResult.error()));
+    }
+
+    // irradiance, every prefiltered mip and the lut only read the environment map and write their own
+    // image, the whole chain runs back to back and is made visible to sampling and readback with one barrier
+    InsertMemoryBarrier(TMemoryBarrierMaskBits::ShaderImageAccess | TMemoryBarrierMaskBits::TextureFetch | TMemoryBarrierMaskBits::TextureUpdate);
+
+    return environmentMapTextures;
+}
+
+auto LoadEnvironmentMaps(const std::string& skyBoxName) -> std::expected<TEnvironmentMaps, std::string> {
+
+    const std::array<std::string, 6> skyBoxNames = {
+        std::format("data/sky/TC_{}_Xp.png", skyBoxName),
+        std::format("data/sky/TC_{}_Xn.png", skyBoxName),
+        std::format("data/sky/TC_{}_Yp.png", skyBoxName),
+        std::format("data/sky/TC_{}_Yn.png", skyBoxName),
+        std::format("data/sky/TC_{}_Zp.png", skyBoxName),
+        std::format("data/sky/TC_{}_Zn.png", skyBoxName),
+    };
+
+    const auto cacheKeyResult = GetEnvironmentMapsCacheKey(skyBoxNames);
+    if (!cacheKeyResult) {
+        return std::unexpected(cacheKeyResult.error());
+    }
+
+    auto environmentMapTextures = LoadEnvironmentMapsFromCache(skyBoxName, *cacheKeyResult);
+    if (!environmentMapTextures) {
 
-    const auto brdfLutMapId = CreateTexture2DFromFile(
-        "data/default/T_Lut_Brdf.png",
-        TFormat::R8G8B8A8_SRGB,
-        false);
+        auto computeEnvironmentMapsResult = ComputeEnvironmentMaps(skyBoxName, skyBoxNames);
+        if (!computeEnvironmentMapsResult) {
+            return std::unexpected(computeEnvironmentMapsResult.error());
+        }
 
-    environmentMaps.BrdfIntegrationMap = GetTexture(brdfLutMapId).Id;
+        environmentMapTextures = *computeEnvironmentMapsResult;
+        StoreEnvironmentMapsInCache(*environmentMapTextures, *cacheKeyResult);
+    }
 
-    return environmentMaps;
+    return TEnvironmentMaps{
+        .EnvironmentMap = GetTexture((*environmentMapTextures).EnvironmentMap).Id,
+        .IrradianceMap = GetTexture((*environmentMapTextures).IrradianceMap).Id,
+        .PrefilteredRadianceMap = GetTexture((*environmentMapTextures).PrefilteredRadianceMap).Id,
+        .BrdfIntegrationMap = GetTexture((*environmentMapTextures).BrdfLut).Id,
+    };
 }
 
 inline auto SignNotZero(const glm::vec2 v) -> glm::vec2 {
@@ -543,6 +986,27 @@ auto RendererCreateGpuMesh(
     const Assets::TAssetPrimitive& assetPrimitive,
     const std::string& label) -> void {
 
+    if (g_gpuMeshes.contains(label)) {
+        return;
+    }
+
+    // texture streaming picks mips from how densely uvs are laid out over the surface
+    auto uvArea = 0.0f;
+    auto worldArea = 0.0f;
+    if (!assetPrimitive.Uvs.empty()) {
+        for (size_t i = 0; i + 2 < assetPrimitive.Indices.size(); i += 3) {
+            const auto i0 = assetPrimitive.Indices[i + 0];
+            const auto i1 = assetPrimitive.Indices[i + 1];
+            const auto i2 = assetPrimitive.Indices[i + 2];
+            const auto uvEdge1 = assetPrimitive.Uvs[i1] - assetPrimitive.Uvs[i0];
+            const auto uvEdge2 = assetPrimitive.Uvs[i2] - assetPrimitive.Uvs[i0];
+            uvArea += 0.5f * glm::abs(uvEdge1.x * uvEdge2.y - uvEdge1.y * uvEdge2.x);
+            worldArea += 0.5f * glm::length(glm::cross(
+                assetPrimitive.Positions[i1] - assetPrimitive.Positions[i0],
+                assetPrimitive.Positions[i2] - assetPrimitive.Positions[i0]));
+        }
+    }
+
     std::vector<TGpuVertexPosition> vertexPositions;
     std::vector<TGpuPackedVertexNormalTangentUvTangentSign> vertexNormalUvTangents;
     vertexPositions.resize(assetPrimitive.Positions.size());
@@ -560,39 +1024,71 @@ auto RendererCreateGpuMesh(
         };
     }
 
-    uint32_t buffers[3] = {};
-    {
-        PROFILER_ZONESCOPEDN("Create GL Buffers + Upload Data");
+    const auto vertexAllocation = g_geometryBuffers.VertexAllocator.Allocate(static_cast<uint32_t>(vertexPositions.size()));
+    const auto indexAllocation = g_geometryBuffers.IndexAllocator.Allocate(static_cast<uint32_t>(assetPrimitive.Indices.size()));
+    if (!vertexAllocation || !indexAllocation) {
+        spdlog::error("Geometry buffers are full, unable to create gpu mesh {} with {} vertices and {} indices",
+            label,
+            vertexPositions.size(),
+            assetPrimitive.Indices.size());
+        if (vertexAllocation) {
+            g_geometryBuffers.VertexAllocator.Free(*vertexAllocation);
+        }
+        if (indexAllocation) {
+            g_geometryBuffers.IndexAllocator.Free(*indexAllocation);
+        }
+        return;
+    }
 
-        glCreateBuffers(3, buffers);
-        SetDebugLabel(buffers[0], GL_BUFFER, std::format("Geometry Pass-{}-Position", label));
-        SetDebugLabel(buffers[1], GL_BUFFER, std::format("Geometry Pass-{}-Normal-Tangent-UvTangentSign", label));
-        SetDebugLabel(buffers[2], GL_BUFFER, std::format("Geometry Pass-{}-Indices", label));
-        glNamedBufferStorage(buffers[0], sizeof(TGpuVertexPosition) * vertexPositions.size(),
-                                vertexPositions.data(), 0);
-        glNamedBufferStorage(buffers[1], sizeof(TGpuPackedVertexNormalTangentUvTangentSign) * vertexNormalUvTangents.size(),
-                                vertexNormalUvTangents.data(), 0);
-        glNamedBufferStorage(buffers[2], sizeof(uint32_t) * assetPrimitive.Indices.size(), assetPrimitive.Indices.data(), 0);
+    {
+        PROFILER_ZONESCOPEDN("Upload Geometry Data");
+
+        UpdateBuffer(
+            g_geometryBuffers.VertexPositionBuffer,
+            sizeof(TGpuVertexPosition) * vertexAllocation->Offset,
+            sizeof(TGpuVertexPosition) * vertexPositions.size(),
+            vertexPositions.data());
+        UpdateBuffer(
+            g_geometryBuffers.VertexNormalUvTangentBuffer,
+            sizeof(TGpuPackedVertexNormalTangentUvTangentSign) * vertexAllocation->Offset,
+            sizeof(TGpuPackedVertexNormalTangentUvTangentSign) * vertexNormalUvTangents.size(),
+            vertexNormalUvTangents.data());
+        UpdateBuffer(
+            g_geometryBuffers.IndexBuffer,
+            sizeof(uint32_t) * indexAllocation->Offset,
+            sizeof(uint32_t) * assetPrimitive.Indices.size(),
+            assetPrimitive.Indices.data());
     }
 
     {
         PROFILER_ZONESCOPEDN("Add Gpu Mesh");
         g_gpuMeshes[label] = TGpuMesh{
             .Name = label,
-            .VertexPositionBuffer = buffers[0],
-            .VertexNormalUvTangentBuffer = buffers[1],
-            .IndexBuffer = buffers[2],
+            .Index = static_cast<uint32_t>(g_gpuMeshes.size()),
+            .VertexAllocation = *vertexAllocation,
+            .IndexAllocation = *indexAllocation,
 
             .VertexCount = vertexPositions.size(),
             .IndexCount = assetPrimitive.Indices.size(),
+
+            .BoundingBox = assetPrimitive.BoundingBox,
+            .BoundingSphere = assetPrimitive.BoundingSphere,
+
+            .UvDensity = worldArea > 0.0f
+                ? glm::sqrt(uvArea / worldArea)
+                : 0.0f,
         };
     }
 }
 
-auto GetGpuMesh(const std::string_view assetMeshName) -> TGpuMesh& {
+// nullptr when the mesh was never created, e.g. because the geometry buffers were full
+auto GetGpuMesh(const std::string_view assetMeshName) -> const TGpuMesh* {
     assert(!assetMeshName.empty());
 
-    return g_gpuMeshes[assetMeshName.data()];
+    const auto gpuMesh = g_gpuMeshes.find(std::string(assetMeshName));
+    return gpuMesh != g_gpuMeshes.end()
+        ? &gpuMesh->second
+        : nullptr;
 }
 
 auto GetCpuMaterial(const std::string_view assetMaterialName) -> TCpuMaterial& {
@@ -604,7 +1100,7 @@ auto GetCpuMaterial(const std::string_view assetMaterialName) -> TCpuMaterial& {
 auto GetGpuMaterial(const std::string_view assetMaterialName) -> TGpuMaterial& {
     assert(!assetMaterialName.empty());
 
-    return g_gpuMaterials[assetMaterialName.data()];
+    return g_gpuMaterials[GetCpuMaterial(assetMaterialName).GpuMaterialIndex];
 }
 
 auto CreateResidentTextureForMaterialChannel(const std::string_view materialDataName) -> int64_t {
@@ -641,38 +1137,44 @@ auto CreateResidentTextureForMaterialChannel(const std::string_view materialData
 
 auto CreateTextureForMaterialChannel(
     const std::string& imageDataName,
-    const Assets::TAssetMaterialChannel channel) -> uint32_t {
+    const Assets::TAssetMaterialChannel channel,
+    const uint32_t sampler) -> TStreamedTextureId {
 
     PROFILER_ZONESCOPEDN("CreateTextureForMaterialChannel");
 
     const auto& imageData = Assets::GetAssetImage(imageDataName);
 
-    const auto textureId = CreateTexture(TCreateTextureDescriptor{
-        .TextureType = TTextureType::Texture2D,
-        .Format = channel == Assets::TAssetMaterialChannel::Normals
-            ? TFormat::R8G8B8A8_UNORM
-            : TFormat::R8G8B8A8_SRGB,
-        .Extent = TExtent3D{ static_cast<uint32_t>(imageData.Width), static_cast<uint32_t>(imageData.Height), 1u },
-        .MipMapLevels = 1 + static_cast<uint32_t>(glm::floor(glm::log2(glm::max(static_cast<float>(imageData.Width), static_cast<float>(imageData.Height))))),
-        .Layers = 1,
-        .SampleCount = TSampleCount::One,
-        .Label = std::format("Texture-{}x{}-{}", imageData.Width, imageData.Height, imageData.Name),
-    });
+    // only the mip tail is uploaded here, the rest follows once something close to the camera uses it
+    const auto textureId = g_textureStreamer.CreateTexture(
+        std::format("Texture-{}x{}-{}", imageData.Width, imageData.Height, imageData.Name),
+        static_cast<uint32_t>(imageData.Width),
+        static_cast<uint32_t>(imageData.Height),
+        imageData.Data.get(),
+        channel != Assets::TAssetMaterialChannel::Normals,
+        sampler);
 
-    UploadTexture(textureId, TUploadTextureDescriptor{
-        .Level = 0,
-        .Offset = TOffset3D{ 0, 0, 0 },
-        .Extent = TExtent3D{ static_cast<uint32_t>(imageData.Width), static_cast<uint32_t>(imageData.Height), 1u },
-        .UploadFormat = TUploadFormat::Auto,
-        .UploadType = TUploadType::Auto,
-        .PixelData = imageData.Data.get()
-    });
+    g_streamedTextureBindings.resize(static_cast<std::size_t>(textureId) + 1);
 
-    GenerateMipmaps(textureId);
+    return textureId;
+}
 
-    //auto& sampler = GetAssetSampler(assetMaterialChannel.Sampler);
+auto BindStreamedTexture(
+    const TCpuTexture& cpuTexture,
+    const uint32_t gpuMaterialIndex,
+    uint64_t TGpuMaterial::* handle) -> void {
+
+    if (!cpuTexture.BindlessHandle.has_value() || gpuMaterialIndex == 0) {
+        return;
+    }
+
+    auto& binding = g_streamedTextureBindings[static_cast<std::size_t>(cpuTexture.StreamedTextureId)];
+    binding.GpuMaterialIndex = gpuMaterialIndex;
+    binding.Handles.push_back(handle);
 
-    return GetTexture(textureId).Id;
+    auto& materialTextures = g_gpuMaterialStreamedTextures[gpuMaterialIndex];
+    if (std::ranges::find(materialTextures, cpuTexture.StreamedTextureId) == materialTextures.end()) {
+        materialTextures.push_back(cpuTexture.StreamedTextureId);
+    }
 }
 
 constexpr auto ToAddressMode(const Assets::TAssetSamplerWrapMode wrapMode) -> TTextureAddressMode {
@@ -723,7 +1225,42 @@ auto CreateSamplerDescriptor(const Assets::TAssetSampler& assetSampler) -> TSamp
     };
 }
 
-auto RendererCreateCpuMaterial(const std::string& assetMaterialName) -> void {
+auto RendererCreateGpuMaterial(const TCpuMaterial& cpuMaterial) -> uint32_t {
+
+    if (g_gpuMaterials.size() >= MAX_GPU_MATERIALS) {
+        spdlog::error("Unable to create more than {} gpu materials, using the default material instead", MAX_GPU_MATERIALS);
+        return 0;
+    }
+
+    const auto armTexture = cpuMaterial.ArmTexture.BindlessHandle.has_value()
+        ? cpuMaterial.ArmTexture.BindlessHandle
+        : cpuMaterial.MetallicRoughnessTexture.BindlessHandle;
+
+    const auto gpuMaterialIndex = static_cast<uint32_t>(g_gpuMaterials.size());
+    const auto& gpuMaterial = g_gpuMaterials.emplace_back(TGpuMaterial{
+        .BaseColor = cpuMaterial.BaseColor,
+        .Factors = cpuMaterial.NormalStrengthRoughnessMetalnessEmissiveStrength,
+        .EmissiveColor = cpuMaterial.EmissiveColor,
+        .BaseColorTexture = cpuMaterial.BaseColorTexture.BindlessHandle.value_or(0),
+        .NormalTexture = cpuMaterial.NormalTexture.BindlessHandle.value_or(0),
+        .ArmTexture = armTexture.value_or(0),
+        .MetallicRoughnessTexture = cpuMaterial.MetallicRoughnessTexture.BindlessHandle.value_or(0),
+        .EmissiveTexture = cpuMaterial.EmissiveTexture.BindlessHandle.value_or(0),
+        .TextureFlags = cpuMaterial.HasTextureFlags,
+        .VirtualTexture = cpuMaterial.VirtualBaseColorTexture != TVirtualTextureId::Invalid
+            ? static_cast<uint32_t>(cpuMaterial.VirtualBaseColorTexture)
+            : 0u,
+    });
+
+    UpdateBuffer(g_gpuMaterialsBuffer, sizeof(TGpuMaterial) * gpuMaterialIndex, sizeof(TGpuMaterial), &gpuMaterial);
+    g_gpuMaterialStreamedTextures.emplace_back();
+    return gpuMaterialIndex;
+}
+
+// materials are shared by name, the first renderable using one decides whether its base color is virtual
+auto RendererCreateCpuMaterial(
+    const std::string& assetMaterialName,
+    const bool isPlanet) -> void {
 
     PROFILER_ZONESCOPEDN("CreateCpuMaterial");
 
@@ -745,16 +1282,33 @@ auto RendererCreateCpuMaterial(const std::string& assetMaterialName) -> void {
     };
 
     const auto& baseColorChannel = assetMaterialData.BaseColorTextureChannel;
-    if (baseColorChannel) {
+    if (baseColorChannel && isPlanet) {
+        const auto& imageData = Assets::GetAssetImage(baseColorChannel->TextureName);
+        const auto pixelCount = static_cast<std::size_t>(imageData.Width) * static_cast<std::size_t>(imageData.Height);
+        const auto virtualTextureId = g_virtualTextures.CreateTexture(
+            std::format("VirtualTexture-{}x{}-{}", imageData.Width, imageData.Height, imageData.Name),
+            static_cast<uint32_t>(imageData.Width),
+            static_cast<uint32_t>(imageData.Height),
+            std::as_bytes(std::span(imageData.Data.get(), pixelCount * 4)));
+        if (virtualTextureId) {
+            cpuMaterial.VirtualBaseColorTexture = *virtualTextureId;
+            cpuMaterial.HasTextureFlags |= TCpuTextureFlag::HasVirtualBaseColor;
+        } else {
+            spdlog::error("{}, streaming the base color of {} instead", virtualTextureId.error(), assetMaterialName);
+        }
+    }
+
+    if (baseColorChannel && cpuMaterial.VirtualBaseColorTexture == TVirtualTextureId::Invalid) {
         const auto& baseColor = *baseColorChannel;
         const auto& baseColorSampler = Assets::GetAssetSampler(baseColor.SamplerName);
         const auto samplerId = GetOrCreateSampler(CreateSamplerDescriptor(baseColorSampler));
         const auto& sampler = GetSampler(samplerId);
 
+        const auto textureId = CreateTextureForMaterialChannel(baseColor.TextureName, baseColor.Channel, sampler.Id);
         cpuMaterial.BaseColorTexture = {
-            .Id = CreateTextureForMaterialChannel(baseColor.TextureName, baseColor.Channel),
+            .StreamedTextureId = textureId,
             .SamplerId = sampler.Id,
-            .BindlessHandle = std::nullopt,
+            .BindlessHandle = g_textureStreamer.GetBindlessHandle(textureId),
         };
         cpuMaterial.HasTextureFlags |= TCpuTextureFlag::HasBaseColor;
     }
@@ -765,10 +1319,11 @@ auto RendererCreateCpuMaterial(const std::string& assetMaterialName) -> void {
         const auto samplerId = GetOrCreateSampler(CreateSamplerDescriptor(normalTextureSampler));
         const auto& sampler = GetSampler(samplerId);
 
+        const auto textureId = CreateTextureForMaterialChannel(normalTexture.TextureName, normalTexture.Channel, sampler.Id);
         cpuMaterial.NormalTexture = {
-            .Id = CreateTextureForMaterialChannel(normalTexture.TextureName, normalTexture.Channel),
+            .StreamedTextureId = textureId,
             .SamplerId = sampler.Id,
-            .BindlessHandle = std::nullopt,
+            .BindlessHandle = g_textureStreamer.GetBindlessHandle(textureId),
         };
         cpuMaterial.HasTextureFlags |= TCpuTextureFlag::HasNormal;
     }
@@ -779,10 +1334,11 @@ auto RendererCreateCpuMaterial(const std::string& assetMaterialName) -> void {
         const auto samplerId = GetOrCreateSampler(CreateSamplerDescriptor(armTextureSampler));
         const auto& sampler = GetSampler(samplerId);
 
+        const auto textureId = CreateTextureForMaterialChannel(armTexture.TextureName, armTexture.Channel, sampler.Id);
         cpuMaterial.ArmTexture = {
-            .Id = CreateTextureForMaterialChannel(armTexture.TextureName, armTexture.Channel),
+            .StreamedTextureId = textureId,
             .SamplerId = sampler.Id,
-            .BindlessHandle = std::nullopt,
+            .BindlessHandle = g_textureStreamer.GetBindlessHandle(textureId),
         };
         cpuMaterial.HasTextureFlags |= TCpuTextureFlag::HasArm;
     }
@@ -793,10 +1349,11 @@ auto RendererCreateCpuMaterial(const std::string& assetMaterialName) -> void {
         const auto samplerId = GetOrCreateSampler(CreateSamplerDescriptor(metallicRoughnessSampler));
         const auto& sampler = GetSampler(samplerId);
 
+        const auto textureId = CreateTextureForMaterialChannel(metallicRoughnessTexture.TextureName, metallicRoughnessTexture.Channel, sampler.Id);
         cpuMaterial.MetallicRoughnessTexture = {
-            .Id = CreateTextureForMaterialChannel(metallicRoughnessTexture.TextureName, metallicRoughnessTexture.Channel),
+            .StreamedTextureId = textureId,
             .SamplerId = sampler.Id,
-            .BindlessHandle = std::nullopt,
+            .BindlessHandle = g_textureStreamer.GetBindlessHandle(textureId),
         };
         cpuMaterial.HasTextureFlags |= TCpuTextureFlag::HasArm;
     }
@@ -807,25 +1364,39 @@ auto RendererCreateCpuMaterial(const std::string& assetMaterialName) -> void {
         const auto samplerId = GetOrCreateSampler(CreateSamplerDescriptor(emissiveTextureSampler));
         const auto& sampler = GetSampler(samplerId);
 
+        const auto textureId = CreateTextureForMaterialChannel(emissiveTexture.TextureName, emissiveTexture.Channel, sampler.Id);
         cpuMaterial.EmissiveTexture = {
-            .Id = CreateTextureForMaterialChannel(emissiveTexture.TextureName, emissiveTexture.Channel),
+            .StreamedTextureId = textureId,
             .SamplerId = sampler.Id,
-            .BindlessHandle = std::nullopt,
+            .BindlessHandle = g_textureStreamer.GetBindlessHandle(textureId),
         };
         cpuMaterial.HasTextureFlags |= TCpuTextureFlag::HasEmissive;
     }
 
+    cpuMaterial.GpuMaterialIndex = RendererCreateGpuMaterial(cpuMaterial);
+
+    BindStreamedTexture(cpuMaterial.BaseColorTexture, cpuMaterial.GpuMaterialIndex, &TGpuMaterial::BaseColorTexture);
+    BindStreamedTexture(cpuMaterial.NormalTexture, cpuMaterial.GpuMaterialIndex, &TGpuMaterial::NormalTexture);
+    BindStreamedTexture(cpuMaterial.ArmTexture, cpuMaterial.GpuMaterialIndex, &TGpuMaterial::ArmTexture);
+    BindStreamedTexture(cpuMaterial.MetallicRoughnessTexture, cpuMaterial.GpuMaterialIndex, &TGpuMaterial::MetallicRoughnessTexture);
+    if (!cpuMaterial.ArmTexture.BindlessHandle.has_value()) {
+        BindStreamedTexture(cpuMaterial.MetallicRoughnessTexture, cpuMaterial.GpuMaterialIndex, &TGpuMaterial::ArmTexture);
+    }
+    BindStreamedTexture(cpuMaterial.EmissiveTexture, cpuMaterial.GpuMaterialIndex, &TGpuMaterial::EmissiveTexture);
+
     g_cpuMaterials[assetMaterialName] = cpuMaterial;
 }
 
 auto DeleteRendererFramebuffers() -> void {
 
-    DeleteFramebuffer(g_depthPrePass.Framebuffer);
-    DeleteFramebuffer(g_geometryPass.Framebuffer);
-    DeleteFramebuffer(g_composePass.Framebuffer);
-    DeleteFramebuffer(g_fxaaPass.Framebuffer);
-    DeleteFramebuffer(g_taaPass.Framebuffers[0]);
-    DeleteFramebuffer(g_taaPass.Framebuffers[1]);
+    g_renderGraph.Destroy();
+
+    for (auto& historyTexture : g_taaPass.HistoryTextures) {
+        if (historyTexture != TTextureId::Invalid) {
+            DeleteTexture(historyTexture);
+            historyTexture = TTextureId::Invalid;
+        }
+    }
 
     for (auto& framebuffer : g_shadowPass.Framebuffers) {
         if (framebuffer.Id != 0) {
@@ -838,105 +1409,17 @@ auto CreateRendererFramebuffers(const glm::vec2& scaledFramebufferSize) -> void
 
     PROFILER_ZONESCOPEDN("CreateRendererFramebuffers");
 
-    g_depthPrePass.Framebuffer = CreateFramebuffer({
-        .Label = "Depth PrePass-FBO",
-        .DepthStencilAttachment = TFramebufferDepthStencilAttachmentDescriptor{
-            .Label = std::format("Depth PrePass-FBO-Depth-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-            .Format = TFormat::D24_UNORM_S8_UINT,
-            .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-            .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-            .ClearDepthStencil = { 1.0f, 0 },
-        }
-    });
-
-    g_geometryPass.Framebuffer = CreateFramebuffer({
-        .Label = "Geometry Pass-FBO",
-        .ColorAttachments = {
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("Geometry Pass-Albedo-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R8G8B8A8_SRGB,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f },
-            },
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("Geometry Pass-Normals-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R32G32B32A32_FLOAT,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f },
-            },
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("Geometry Pass-TAA-Velocity-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R16G16B16A16_FLOAT,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f },
-            },
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("Geometry Pass-Emissive-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R16G16B16A16_FLOAT,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f },
-            }
-        },
-        .DepthStencilAttachment = TFramebufferExistingDepthStencilAttachmentDescriptor{
-            .ExistingDepthTexture = g_depthPrePass.Framebuffer.DepthStencilAttachment.value().Texture,
-        }
-    });
-
-    g_composePass.Framebuffer = CreateFramebuffer({
-        .Label = "Compose Pass-FBO",
-        .ColorAttachments = {
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("Compose Pass-FBO-Output-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R8G8B8A8_SRGB,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f },
-            },
-        },
-    });
-
-    g_fxaaPass.Framebuffer = CreateFramebuffer({
-        .Label = "Fxaa Pass-FBO",
-        .ColorAttachments = {
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("Fxaa Pass-FBO-Output-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R8G8B8A8_SRGB,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::DontCare,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 0.0f }
-            }
-        }
-    });
-
-    g_taaPass.Framebuffers[0] = CreateFramebuffer({
-        .Label = "TAA Pass-FBO-Taa1",
-        .ColorAttachments = {
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("TAA Pass-FBO-Taa1-Output-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R16G16B16A16_FLOAT,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f },
-            }
-        }
-    });
-
-    g_taaPass.Framebuffers[1] = CreateFramebuffer({
-        .Label = "TAA Pass-FBO-Taa2",
-        .ColorAttachments = {
-            TFramebufferColorAttachmentDescriptor{
-                .Label = std::format("TAA Pass-FBO-Taa2-Output-{}x{}", scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .Format = TFormat::R16G16B16A16_FLOAT,
-                .Extent = TExtent2D(scaledFramebufferSize.x, scaledFramebufferSize.y),
-                .LoadOperation = TFramebufferAttachmentLoadOperation::Clear,
-                .ClearColor = { 0.0f, 0.0f, 0.0f, 1.0f },
-            }
-        }
-    });
+    for (auto historyIndex = 0; historyIndex < 2; ++historyIndex) {
+        g_taaPass.HistoryTextures[historyIndex] = CreateTexture({
+            .TextureType = TTextureType::Texture2D,
+            .Format = TFormat::R16G16B16A16_FLOAT,
+            .Extent = TExtent3D{static_cast<uint32_t>(scaledFramebufferSize.x), static_cast<uint32_t>(scaledFramebufferSize.y), 1u},
+            .MipMapLevels = 1,
+            .Layers = 0,
+            .SampleCount = TSampleCount::One,
+            .Label = std::format("TAA History-{}-{}x{}", historyIndex, scaledFramebufferSize.x, scaledFramebufferSize.y),
+        });
+    }
 
     // Create shadow map framebuffers for each light
     for (int i = 0; i < MAX_GLOBAL_LIGHTS; ++i) {
@@ -980,16 +1463,6 @@ auto Renderer::Initialize(
 
     Assets::AddDefaultAssets();
 
-    const auto loadSkyTextureResult = LoadEnvironmentMaps("SkyRed");
-    if (!loadSkyTextureResult.has_value()) {
-        spdlog::error("Failed to load sky texture: {}", loadSkyTextureResult.error());
-        return false;
-    }
-    g_environmentMaps = *loadSkyTextureResult;
-
-    g_scaledFramebufferSize = initialFramebufferSize;
-    CreateRendererFramebuffers(g_scaledFramebufferSize);
-
     auto depthPrePassGraphicsPipelineResult = CreateGraphicsPipeline({
         .Label = "Depth PrePass",
         .VertexShaderFilePath = "data/shaders/DepthPrePass.vs.glsl",
@@ -1046,7 +1519,34 @@ auto Renderer::Initialize(
     }
     g_geometryPass.Pipeline = *geometryGraphicsPipelineResult;
 
-    auto composeDeferredGraphicsPipelineResult = CreateGraphicsPipeline({
+    auto virtualTextureFeedbackGraphicsPipelineResult = CreateGraphicsPipeline({
+        .Label = "Virtual Texture Feedback Pass",
+        .VertexShaderFilePath = "data/shaders/Geometry.vs.glsl",
+        .FragmentShaderFilePath = "data/shaders/VirtualTextureFeedback.fs.glsl",
+        .InputAssembly = {
+            .PrimitiveTopology = TPrimitiveTopology::Triangles,
+        },
+        .RasterizerState = {
+            .FillMode = TFillMode::Solid,
+            .CullMode = TCullMode::Back,
+            .FaceWindingOrder = TFaceWindingOrder::CounterClockwise,
+        },
+        .OutputMergerState = {
+            .ColorMask = TColorMaskBits::None,
+            .DepthState = {
+                .IsDepthTestEnabled = true,
+                .IsDepthWriteEnabled = true,
+                .DepthFunction = TDepthFunction::Less,
+            },
+        }
+    });
+    if (!virtualTextureFeedbackGraphicsPipelineResult) {
+        spdlog::error(virtualTextureFeedbackGraphicsPipelineResult.error());
+        return false;
+    }
+    g_virtualTextureFeedbackPass.Pipeline = *virtualTextureFeedbackGraphicsPipelineResult;
+
+    auto composeDeferredGraphicsPipelineResult = CreateGraphicsPipeline({
         .Label = "Compose Pass",
         .VertexShaderFilePath = "data/shaders/ComposeDeferred.vs.glsl",
         .FragmentShaderFilePath = "data/shaders/ComposeDeferred.fs.glsl",
@@ -1192,7 +1692,56 @@ auto Renderer::Initialize(
     }
     g_shadowPass.Pipeline = *shadowGraphicsPipelineResult;
 
-    g_debugLinesPass.VertexBuffer = CreateBuffer("Debug Lines Pass-VBO", sizeof(TGpuDebugLine) * 16384, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    auto cullingComputePipelineResult = GetOrCreateComputePipeline({
+        .Label = "Culling Pass",
+        .ComputeShaderFilePath = "data/shaders/CullObjects.cs.glsl",
+    });
+    if (!cullingComputePipelineResult) {
+        spdlog::error(cullingComputePipelineResult.error());
+        return false;
+    }
+    g_cullingPass.Pipeline = *cullingComputePipelineResult;
+
+    auto buildDrawCommandsComputePipelineResult = GetOrCreateComputePipeline({
+        .Label = "Build Draw Commands",
+        .ComputeShaderFilePath = "data/shaders/BuildDrawCommands.cs.glsl",
+    });
+    if (!buildDrawCommandsComputePipelineResult) {
+        spdlog::error(buildDrawCommandsComputePipelineResult.error());
+        return false;
+    }
+    g_cullingPass.BuildDrawCommandsPipeline = *buildDrawCommandsComputePipelineResult;
+
+    auto hiZComputePipelineResult = GetOrCreateComputePipeline({
+        .Label = "Build HiZ",
+        .ComputeShaderFilePath = "data/shaders/BuildHiZ.cs.glsl",
+    });
+    if (!hiZComputePipelineResult) {
+        spdlog::error(hiZComputePipelineResult.error());
+        return false;
+    }
+    g_hiZPass.Pipeline = *hiZComputePipelineResult;
+
+    auto lightClusterComputePipelineResult = GetOrCreateComputePipeline({
+        .Label = "Light Clusters",
+        .ComputeShaderFilePath = "data/shaders/LightClusters.cs.glsl",
+    });
+    if (!lightClusterComputePipelineResult) {
+        spdlog::error(lightClusterComputePipelineResult.error());
+        return false;
+    }
+    g_lightClusterPass.Pipeline = *lightClusterComputePipelineResult;
+
+    // the pipelines above are compiled by the driver while the sky is decoded and convolved
+    const auto loadSkyTextureResult = LoadEnvironmentMaps("SkyRed");
+    if (!loadSkyTextureResult.has_value()) {
+        spdlog::error("Failed to load sky texture: {}", loadSkyTextureResult.error());
+        return false;
+    }
+    g_environmentMaps = *loadSkyTextureResult;
+
+    g_scaledFramebufferSize = initialFramebufferSize;
+    CreateRendererFramebuffers(g_scaledFramebufferSize);
 
     for (int i = 0; i < g_jitterCount; ++i) {
         g_jitter[i].x = GetHaltonSequence(2, i + 1) - 0.5f;
@@ -1215,8 +1764,43 @@ auto Renderer::Initialize(
     g_previousViewMatrix = g_globalUniforms.ViewMatrix;
     g_previousJitteredProjectionMatrix = g_globalUniforms.ProjectionMatrix;
 
-    g_globalUniformsBuffer = CreateBuffer("TGpuGlobalUniforms", sizeof(TGpuGlobalUniforms), &g_globalUniforms, GL_DYNAMIC_STORAGE_BIT);
-    g_objectsBuffer = CreateBuffer("TGpuObjects", sizeof(TGpuObject) * 16384, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    // per frame data, uniforms, lights and debug lines of up to RING_BUFFER_FRAME_COUNT frames are in flight
+    g_frameRingBuffer = CreateRingBuffer("Frame Ring Buffer", sizeof(TGpuGlobalUniforms) + sizeof(TGpuGlobalLight) * MAX_GLOBAL_LIGHTS + sizeof(TGpuLocalLight) * MAX_LOCAL_LIGHTS + sizeof(TGpuDebugLine) * MAX_DEBUG_LINES + 4096);
+    g_objectsBuffer = CreateBuffer("TGpuObjects", sizeof(TGpuObject) * MAX_GPU_OBJECTS, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_gpuMaterialsBuffer = CreateBuffer("TGpuMaterials", sizeof(TGpuMaterial) * MAX_GPU_MATERIALS, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_lightClusterPass.LightClustersBuffer = CreateBuffer("Light Clusters", sizeof(uint32_t) * LIGHT_CLUSTER_COUNT * (1 + LIGHT_CLUSTER_MAX_LIGHTS), nullptr, 0);
+    g_textureStreamer.Initialize(static_cast<std::size_t>(g_windowSettings.TextureStreamingBudgetInMegabytes) * 1024 * 1024);
+    g_virtualTextures.Initialize();
+    RendererCreateGpuMaterial(TCpuMaterial{
+        .BaseColor = glm::vec4{1.0f},
+        .NormalStrengthRoughnessMetalnessEmissiveStrength = glm::vec4{1.0f, 0.5f, 0.0f, 0.0f},
+        .EmissiveColor = glm::vec4{0.0f, 0.0f, 0.0f, 1.0f},
+    });
+
+    g_geometryBuffers.VertexPositionBuffer = CreateBuffer("Geometry-Position", sizeof(TGpuVertexPosition) * MAX_GEOMETRY_VERTICES, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_geometryBuffers.VertexNormalUvTangentBuffer = CreateBuffer(
+        "Geometry-Normal-Tangent-UvTangentSign",
+        sizeof(TGpuPackedVertexNormalTangentUvTangentSign) * MAX_GEOMETRY_VERTICES,
+        nullptr,
+        GL_DYNAMIC_STORAGE_BIT);
+    g_geometryBuffers.IndexBuffer = CreateBuffer("Geometry-Indices", sizeof(uint32_t) * MAX_GEOMETRY_INDICES, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_geometryBuffers.VertexAllocator.Initialize(MAX_GEOMETRY_VERTICES);
+    g_geometryBuffers.IndexAllocator.Initialize(MAX_GEOMETRY_INDICES);
+
+    g_indirectDrawData.DrawRecordsBuffer = CreateBuffer("TGpuDrawRecords", sizeof(TGpuDrawRecord) * MAX_GPU_OBJECTS, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_indirectDrawData.InstanceGroupsBuffer = CreateBuffer("TGpuInstanceGroups", sizeof(TGpuInstanceGroup) * MAX_GPU_OBJECTS, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_indirectDrawData.InstanceIndicesBuffer = CreateBuffer("Instance Indices", sizeof(uint32_t) * MAX_GPU_OBJECTS * CULL_VIEW_COUNT * DEPTH_BUCKET_COUNT, nullptr, 0);
+    g_indirectDrawData.CommandBuffer = CreateBuffer(
+        "TDrawElementsIndirectCommands",
+        sizeof(TDrawElementsIndirectCommand) * MAX_GPU_OBJECTS * CULL_VIEW_COUNT * DEPTH_BUCKET_COUNT,
+        nullptr,
+        0);
+    g_cullingPass.CullViewsBuffer = CreateBuffer("TGpuCullViews", sizeof(TGpuCullView) * CULL_VIEW_COUNT, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_cullingPass.InstanceCountsBuffer = CreateBuffer("Instance Counts", sizeof(uint32_t) * MAX_GPU_OBJECTS * CULL_VIEW_COUNT * DEPTH_BUCKET_COUNT, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    g_cullingPass.DrawCountsBuffer = CreateBuffer("Draw Counts", sizeof(uint32_t) * MAX_GPU_OBJECTS * CULL_VIEW_COUNT * DEPTH_BUCKET_COUNT, nullptr, GL_DYNAMIC_STORAGE_BIT);
+
+    g_cpuOcclusionPass.Buffer.Initialize(256, 128);
+    g_cpuOcclusionPass.VisibilityBuffer = CreateBuffer("Object Visibility", sizeof(uint32_t) * (MAX_GPU_OBJECTS / 32), nullptr, GL_DYNAMIC_STORAGE_BIT);
 
     g_gpuGlobalLights.fill(TGpuGlobalLight{
         .ShadowViewProjectionMatrix = glm::mat4(1.0f),
@@ -1224,7 +1808,6 @@ auto Renderer::Initialize(
         .ColorAndIntensity = glm::vec4{1.0f, 1.0f, 1.0f, 1.0f},
         .LightProperties = glm::ivec4{0, 0, 0, 0}
     });
-    g_globalLightsBuffer = CreateBuffer("TGpuGlobalLights", g_gpuGlobalLights.size() * sizeof(TGpuGlobalLight), g_gpuGlobalLights.data(), GL_DYNAMIC_STORAGE_BIT);
 
     g_fstSamplerNearestClampToEdge = GetOrCreateSampler({
         .AddressModeU = TTextureAddressMode::ClampToEdge,
@@ -1233,14 +1816,53 @@ auto Renderer::Initialize(
         .MinFilter = TTextureMinFilter::Nearest
     });
 
+    if (auto resolvePipelinesResult = ResolvePipelines({
+            &g_depthPrePass.Pipeline,
+            &g_geometryPass.Pipeline,
+            &g_virtualTextureFeedbackPass.Pipeline,
+            &g_composePass.Pipeline,
+            &g_fstGraphicsPipeline,
+            &g_debugLinesPass.Pipeline,
+            &g_fxaaPass.Pipeline,
+            &g_taaPass.Pipeline,
+            &g_shadowPass.Pipeline,
+            &g_cullingPass.Pipeline,
+            &g_cullingPass.BuildDrawCommandsPipeline,
+            &g_hiZPass.Pipeline,
+            &g_lightClusterPass.Pipeline,
+        }); !resolvePipelinesResult) {
+        spdlog::error(resolvePipelinesResult.error());
+        return false;
+    }
+
+    const auto& programCacheStatistics = GetProgramCacheStatistics();
+    spdlog::info("Renderer: Created {} programs ({} from the program binary cache) in {:.3f}s",
+                 programCacheStatistics.ProgramCount,
+                 programCacheStatistics.CachedProgramCount,
+                 programCacheStatistics.CreationTimeInSeconds);
+
     return true;
 }
 
 auto Renderer::Unload() -> void {
 
-    DeleteBuffer(g_globalLightsBuffer);
-    DeleteBuffer(g_globalUniformsBuffer);
+    g_textureStreamer.Destroy();
+    g_virtualTextures.Destroy();
+    DeleteRingBuffer(g_frameRingBuffer);
     DeleteBuffer(g_objectsBuffer);
+    DeleteBuffer(g_gpuMaterialsBuffer);
+    DeleteBuffer(g_lightClusterPass.LightClustersBuffer);
+    DeleteBuffer(g_geometryBuffers.VertexPositionBuffer);
+    DeleteBuffer(g_geometryBuffers.VertexNormalUvTangentBuffer);
+    DeleteBuffer(g_geometryBuffers.IndexBuffer);
+    DeleteBuffer(g_indirectDrawData.DrawRecordsBuffer);
+    DeleteBuffer(g_indirectDrawData.InstanceGroupsBuffer);
+    DeleteBuffer(g_indirectDrawData.InstanceIndicesBuffer);
+    DeleteBuffer(g_indirectDrawData.CommandBuffer);
+    DeleteBuffer(g_cullingPass.CullViewsBuffer);
+    DeleteBuffer(g_cullingPass.InstanceCountsBuffer);
+    DeleteBuffer(g_cullingPass.DrawCountsBuffer);
+    DeleteBuffer(g_cpuOcclusionPass.VisibilityBuffer);
 
     DeleteRendererFramebuffers();
 
@@ -1249,6 +1871,7 @@ auto Renderer::Unload() -> void {
 
     DeletePipeline(g_depthPrePass.Pipeline);
     DeletePipeline(g_geometryPass.Pipeline);
+    DeletePipeline(g_virtualTextureFeedbackPass.Pipeline);
     DeletePipeline(g_composePass.Pipeline);
     DeletePipeline(g_fxaaPass.Pipeline);
     DeletePipeline(g_taaPass.Pipeline);
@@ -1496,6 +2119,34 @@ auto RenderEntityProperties(
         }
     }
 
+    if (registry.all_of<TComponentPointLight>(entity)) {
+
+        if (ImGui::CollapsingHeader((char*)ICON_MDI_LIGHTBULB " Point Light", ImGuiTreeNodeFlags_Leaf)) {
+            auto& pointLight = registry.get<TComponentPointLight>(entity);
+
+            ImGui::Indent();
+            ImGui::DragFloat3("Color", &pointLight.Color.x, 0.01f, 0.0f, 1.0f, "%.2f");
+            ImGui::DragFloat("Intensity", &pointLight.Intensity, 0.01f, 0.0f, 100.0f, "%.2f");
+            ImGui::DragFloat("Radius", &pointLight.Radius, 0.1f, 0.1f, 1000.0f, "%.1f");
+            ImGui::Unindent();
+        }
+    }
+
+    if (registry.all_of<TComponentSpotLight>(entity)) {
+
+        if (ImGui::CollapsingHeader((char*)ICON_MDI_SPOTLIGHT " Spot Light", ImGuiTreeNodeFlags_Leaf)) {
+            auto& spotLight = registry.get<TComponentSpotLight>(entity);
+
+            ImGui::Indent();
+            ImGui::DragFloat3("Color", &spotLight.Color.x, 0.01f, 0.0f, 1.0f, "%.2f");
+            ImGui::DragFloat("Intensity", &spotLight.Intensity, 0.01f, 0.0f, 100.0f, "%.2f");
+            ImGui::DragFloat("Radius", &spotLight.Radius, 0.1f, 0.1f, 1000.0f, "%.1f");
+            ImGui::DragFloat("Inner Cone Angle", &spotLight.InnerConeAngle, 0.01f, 0.0f, spotLight.OuterConeAngle, "%.2f");
+            ImGui::DragFloat("Outer Cone Angle", &spotLight.OuterConeAngle, 0.01f, spotLight.InnerConeAngle, glm::half_pi<float>(), "%.2f");
+            ImGui::Unindent();
+        }
+    }
+
     if (registry.all_of<TComponentCamera>(entity)) {
 
         if (ImGui::CollapsingHeader((char*)ICON_MDI_CIRCLE " Camera", ImGuiTreeNodeFlags_Leaf)) {
@@ -1586,12 +2237,10 @@ auto DrawDirectionalLightMarker(
     }
 }
 
-auto UpdateGlobalLights(entt::registry& registry) -> void {
-    const auto globalLightsEntities = registry.view<TComponentGlobalLight>();
+auto UpdateGlobalLights(const Renderer::TRenderSnapshot& snapshot) -> void {
 
     auto globalLightIndex = 0;
-    for (const auto globalLightEntity : globalLightsEntities) {
-        const auto& globalLight = registry.get<TComponentGlobalLight>(globalLightEntity);
+    for (const auto& globalLight : snapshot.GlobalLights) {
         const auto direction = PolarToCartesian(globalLight.Azimuth, globalLight.Elevation);
 
         // Calculate shadow view-projection matrix for directional light
@@ -1628,48 +2277,36 @@ auto UpdateGlobalLights(entt::registry& registry) -> void {
         }
     }
 
-    UpdateBuffer(g_globalLightsBuffer, 0, sizeof(TGpuGlobalLight) * 8, g_gpuGlobalLights.data());
+    g_gpuGlobalLightCount = static_cast<uint32_t>(globalLightIndex);
+    g_globalLightsAllocation = AllocateFromRingBuffer(g_frameRingBuffer, sizeof(TGpuGlobalLight) * MAX_GLOBAL_LIGHTS, g_gpuGlobalLights.data());
 }
 
-auto UpdateAllTransforms(entt::registry& registry) -> void{
-    const auto view = registry.view<TComponentPosition, TComponentOrientationEuler, TComponentScale, TComponentTransform, TComponentHierarchy>();
-    for (auto root : view) {
-        const auto& hierarchy = view.get<TComponentHierarchy>(root);
-        if (hierarchy.Parent != entt::null) {
-            continue;
-        }
-
-        std::stack<std::pair<entt::entity, const glm::mat4*>> stack;
-        stack.emplace(root, nullptr);
+auto UpdateLocalLights(const Renderer::TRenderSnapshot& snapshot) -> void {
 
-        while (!stack.empty()) {
-            auto [entity, parentGlobal] = stack.top();
-            stack.pop();
+    PROFILER_ZONESCOPEDN("Update Local Lights");
 
-            auto& localPosition = registry.get<TComponentPosition>(entity);
-            auto& localOrientation = registry.get<TComponentOrientationEuler>(entity);
-            auto& localScale = registry.get<TComponentScale>(entity);
-            auto& globalTransform = registry.get<TComponentTransform>(entity);
-            auto& renderTransform = registry.get<TComponentRenderTransform>(entity);
-
-            glm::mat4 localMatrix = glm::translate(glm::mat4(1.0f), localPosition)
-                                  * glm::eulerAngleYXZ(localOrientation.Yaw, localOrientation.Pitch, localOrientation.Roll)
-                                  * glm::scale(glm::mat4(1.0f), localScale);
-
-            if (parentGlobal) {
-                globalTransform = *parentGlobal * localMatrix;
-            } else {
-                globalTransform = localMatrix;
-            }
+    if (snapshot.LocalLights.size() > MAX_LOCAL_LIGHTS) {
+        spdlog::warn("Scene has more than {} local lights, the rest is not lit", MAX_LOCAL_LIGHTS);
+    }
 
-            renderTransform = globalTransform;
+    auto& localLights = g_lightClusterPass.LocalLights;
+    localLights.clear();
+    for (const auto& localLight : snapshot.LocalLights | std::views::take(MAX_LOCAL_LIGHTS)) {
+        localLights.push_back(TGpuLocalLight{
+            .PositionAndRadius = glm::vec4{localLight.Position, localLight.Radius},
+            .ColorAndIntensity = glm::vec4{localLight.Color, localLight.Intensity},
+            .DirectionAndType = glm::vec4{localLight.Direction, localLight.IsSpotLight ? 1.0f : 0.0f},
+            .CosConeAngles = glm::vec4{localLight.CosInnerConeAngle, localLight.CosOuterConeAngle, 0.0f, 0.0f},
+        });
+    }
 
-            const auto& entityHierarchy = registry.get<TComponentHierarchy>(entity);
-            for (auto child : entityHierarchy.Children) {
-                stack.emplace(child, &globalTransform);
-            }
-        }
+    // a bound range can't be empty, without lights an unused one keeps the allocation valid
+    g_lightClusterPass.LocalLightCount = static_cast<uint32_t>(localLights.size());
+    if (localLights.empty()) {
+        localLights.emplace_back();
     }
+
+    g_lightClusterPass.LocalLightsAllocation = AllocateFromRingBuffer(g_frameRingBuffer, sizeof(TGpuLocalLight) * localLights.size(), localLights.data());
 }
 
 bool g_uiIsMagnifierEnabled = true;
@@ -1717,45 +2354,18 @@ auto inline ResetDebugLines() -> void {
     }
 }
 
-auto inline CreateGpuResourcesIfNecessary(entt::registry& registry) -> void {
-    PROFILER_ZONESCOPEDN("Create Gpu Resources if necessary");
-
-    /*
-     * ECS - Create Gpu Resources if necessary
-     */
-    const auto createGpuResourcesNecessaryView = registry.view<TComponentCreateGpuResourcesNecessary>();
-    for (auto& entity : createGpuResourcesNecessaryView) {
-
-        PROFILER_ZONESCOPEDN("Create Gpu Resource");
-        auto& meshComponent = registry.get<TComponentMesh>(entity);
-        auto& materialComponent = registry.get<TComponentMaterial>(entity);
-
-        auto& assetPrimitive = Assets::GetAssetPrimitive(meshComponent.Mesh);
-        RendererCreateGpuMesh(assetPrimitive, assetPrimitive.Name);
-        RendererCreateCpuMaterial(materialComponent.Material);
-
-        registry.emplace<TComponentGpuMesh>(entity, meshComponent.Mesh);
-        registry.emplace<TComponentGpuMaterial>(entity, materialComponent.Material);
-
-        registry.remove<TComponentCreateGpuResourcesNecessary>(entity);
-    }
-}
-
-auto inline UpdateGlobalTransforms(entt::registry& registry) -> void {
+auto inline UpdateGlobalTransforms(const Renderer::TRenderSnapshot& snapshot) -> void {
 
     PROFILER_ZONESCOPEDN("Update Global Uniforms");
 
-    registry.view<TComponentCamera>().each([&](
-        const auto& entity,
-        const auto& cameraComponent) {
+    if (snapshot.CameraEntity != entt::null) {
 
-        auto cameraMatrix = registry.get<TComponentRenderTransform>(entity);
-        auto viewMatrix = glm::inverse(cameraMatrix);
+        const auto& cameraMatrix = snapshot.CameraMatrix;
         const glm::vec3 cameraPosition = cameraMatrix[3];
         const glm::vec3 cameraDirection = cameraMatrix[1];
 
         auto aspectRatio = g_scaledFramebufferSize.x / g_scaledFramebufferSize.y;
-        g_globalUniforms.ProjectionMatrix = glm::infinitePerspective(glm::radians(cameraComponent.FieldOfView), aspectRatio, 0.1f);
+        g_globalUniforms.ProjectionMatrix = glm::infinitePerspective(glm::radians(snapshot.CameraFieldOfView), aspectRatio, 0.1f);
         g_globalUniforms.ViewMatrix = glm::inverse(cameraMatrix);
 
         float jitterX = 0;
@@ -1779,14 +2389,14 @@ auto inline UpdateGlobalTransforms(entt::registry& registry) -> void {
         g_globalUniforms.CurrentJitteredViewProjectionMatrix = g_currentJitteredProjectionMatrix * g_globalUniforms.ViewMatrix;
         g_globalUniforms.PreviousJitteredViewProjectionMatrix = g_previousJitteredProjectionMatrix * g_previousViewMatrix;
 
-        g_globalUniforms.CameraPosition = glm::vec4(cameraPosition, glm::radians(cameraComponent.FieldOfView));
+        g_globalUniforms.CameraPosition = glm::vec4(cameraPosition, glm::radians(snapshot.CameraFieldOfView));
         g_globalUniforms.CameraDirection = glm::vec4(cameraDirection, aspectRatio);
-        UpdateBuffer(g_globalUniformsBuffer, 0, sizeof(TGpuGlobalUniforms), &g_globalUniforms);
 
         g_previousViewMatrix = g_globalUniforms.ViewMatrix;
         g_previousJitteredProjectionMatrix = g_currentJitteredProjectionMatrix;
+    }
 
-    });
+    g_globalUniformsAllocation = AllocateFromRingBuffer(g_frameRingBuffer, sizeof(TGpuGlobalUniforms), &g_globalUniforms);
 }
 
 auto inline ResizeFramebuffersIfNecessary() -> void {
@@ -1820,148 +2430,625 @@ auto inline ResizeFramebuffersIfNecessary() -> void {
     }
 }
 
-auto inline RenderShadowPass(entt::registry& registry) -> void {
+auto inline RebuildGpuScene(const Renderer::TRenderSnapshot& snapshot) -> void {
 
-    if (!g_shadowPass.IsEnabled) {
-        return;
+    PROFILER_ZONESCOPEDN("Rebuild Gpu Scene");
+
+    struct TRenderable {
+        uint32_t SnapshotIndex;
+        const TGpuMesh* Mesh;
+        uint32_t MaterialIndex;
+    };
+
+    auto& renderableObjectIndices = g_indirectDrawData.RenderableObjectIndices;
+    renderableObjectIndices.assign(snapshot.Renderables.size(), std::numeric_limits<uint32_t>::max());
+
+    std::vector<TRenderable> renderables;
+    for (uint32_t snapshotIndex = 0; snapshotIndex < snapshot.Renderables.size(); ++snapshotIndex) {
+        const auto& snapshotRenderable = snapshot.Renderables[snapshotIndex];
+        if (renderables.size() >= MAX_GPU_OBJECTS) {
+            spdlog::warn("Scene has more than {} renderables, the rest is not drawn", MAX_GPU_OBJECTS);
+            continue;
+        }
+
+        // meshes and materials are created the first time a renderable uses them
+        auto& assetPrimitive = Assets::GetAssetPrimitive(snapshotRenderable.Mesh);
+        RendererCreateGpuMesh(assetPrimitive, assetPrimitive.Name);
+        const auto* gpuMesh = GetGpuMesh(snapshotRenderable.Mesh);
+        if (gpuMesh == nullptr) {
+            // RendererCreateGpuMesh already reported why, the renderable is not drawn
+            continue;
+        }
+        if (!snapshotRenderable.Material.empty()) {
+            RendererCreateCpuMaterial(snapshotRenderable.Material, snapshotRenderable.IsPlanet);
+        }
+
+        renderables.push_back(TRenderable{
+            .SnapshotIndex = snapshotIndex,
+            .Mesh = gpuMesh,
+            .MaterialIndex = !snapshotRenderable.Material.empty()
+                ? GetCpuMaterial(snapshotRenderable.Material).GpuMaterialIndex
+                : 0u,
+        });
     }
 
-    PROFILER_ZONESCOPEDN("Shadow Pass");
-    PushDebugGroup("Shadow Pass");
+    // material major, ties broken front to back from where the camera is right now
+    const auto cameraPosition = glm::vec3(g_globalUniforms.CameraPosition);
+    std::vector<TRenderQueueItem> renderQueue(renderables.size());
+    for (uint32_t renderableIndex = 0; renderableIndex < renderables.size(); ++renderableIndex) {
+        const auto& renderable = renderables[renderableIndex];
+        const auto& renderTransform = snapshot.Renderables[renderable.SnapshotIndex].WorldMatrix;
+        renderQueue[renderableIndex] = TRenderQueueItem{
+            .SortKey = CreateSortKey(
+                TRenderPass::Opaque,
+                TRenderPipeline::Default,
+                renderable.MaterialIndex,
+                renderable.Mesh->Index,
+                glm::distance(cameraPosition, glm::vec3(renderTransform[3]))),
+            .Index = renderableIndex,
+        };
+    }
+    SortRenderQueue(renderQueue);
+
+    auto& objects = g_indirectDrawData.Objects;
+    auto& drawRecords = g_indirectDrawData.DrawRecords;
+    auto& instanceGroups = g_indirectDrawData.InstanceGroups;
+    auto& batches = g_indirectDrawData.Batches;
+    auto& objectUvDensities = g_indirectDrawData.ObjectUvDensities;
+    objects.resize(renderables.size());
+    drawRecords.resize(renderables.size());
+    objectUvDensities.resize(renderables.size());
+    instanceGroups.clear();
+    batches.clear();
+
+    // the queue is sorted by material then mesh, so objects which can share an instanced draw are adjacent
+    const TGpuMesh* previousMesh = nullptr;
+    uint32_t previousMaterialIndex = 0;
+    for (uint32_t objectIndex = 0; objectIndex < renderQueue.size(); ++objectIndex) {
+        const auto& renderable = renderables[renderQueue[objectIndex].Index];
+
+        const auto state = GetSortKeyState(renderQueue[objectIndex].SortKey);
+        const auto isNewBatch = batches.empty() || batches.back().State != state;
+        if (isNewBatch) {
+            batches.push_back(TDrawBatch{
+                .State = state,
+                .FirstInstanceGroup = static_cast<uint32_t>(instanceGroups.size()),
+                .InstanceGroupCount = 0,
+            });
+        }
+        if (isNewBatch || renderable.Mesh != previousMesh || renderable.MaterialIndex != previousMaterialIndex) {
+            instanceGroups.push_back(TGpuInstanceGroup{
+                .IndexCount = static_cast<uint32_t>(renderable.Mesh->IndexCount),
+                .FirstIndex = renderable.Mesh->IndexAllocation.Offset,
+                .BaseVertex = static_cast<int32_t>(renderable.Mesh->VertexAllocation.Offset),
+                .FirstObject = objectIndex,
+                .BatchIndex = static_cast<uint32_t>(batches.size() - 1),
+                .BatchFirstInstanceGroup = batches.back().FirstInstanceGroup,
+            });
+            batches.back().InstanceGroupCount++;
+            previousMesh = renderable.Mesh;
+            previousMaterialIndex = renderable.MaterialIndex;
+        }
 
-    const auto globalLightsEntities = registry.view<TComponentGlobalLight>();
-    auto lightIndex = 0;
+        renderableObjectIndices[renderable.SnapshotIndex] = objectIndex;
 
-    g_shadowPass.Pipeline.Bind();
+        objects[objectIndex] = TGpuObject{
+            .WorldMatrix = snapshot.Renderables[renderable.SnapshotIndex].WorldMatrix,
+            .InstanceParameter = glm::ivec4{static_cast<int32_t>(renderable.MaterialIndex), 0, 0, 0},
+        };
+        drawRecords[objectIndex] = TGpuDrawRecord{
+            .LocalBoundingSphere = glm::vec4{renderable.Mesh->BoundingSphere.Center, renderable.Mesh->BoundingSphere.Radius},
+            .InstanceGroupIndex = static_cast<uint32_t>(instanceGroups.size() - 1),
+            .InstanceGroupFirstObject = instanceGroups.back().FirstObject,
+        };
+        objectUvDensities[objectIndex] = renderable.Mesh->UvDensity;
+    }
 
-    for (const auto globalLightEntity : globalLightsEntities) {
-        if (lightIndex >= MAX_GLOBAL_LIGHTS) {
-            break;
+    if (!objects.empty()) {
+        UpdateBuffer(g_objectsBuffer, 0, sizeof(TGpuObject) * objects.size(), objects.data());
+        UpdateBuffer(g_indirectDrawData.DrawRecordsBuffer, 0, sizeof(TGpuDrawRecord) * drawRecords.size(), drawRecords.data());
+        UpdateBuffer(g_indirectDrawData.InstanceGroupsBuffer, 0, sizeof(TGpuInstanceGroup) * instanceGroups.size(), instanceGroups.data());
+    }
+
+    g_indirectDrawData.IsDirty = false;
+}
+
+auto inline UpdateGpuScene(const Renderer::TRenderSnapshot& snapshot) -> void {
+
+    PROFILER_ZONESCOPEDN("Update Gpu Scene");
+
+    // the object table is only rebuilt when renderables come or go, the ones the game thread moved just patch their transform
+    if (g_indirectDrawData.IsDirty || snapshot.IsRenderableSetChanged) {
+        RebuildGpuScene(snapshot);
+    } else {
+        for (const auto snapshotIndex : snapshot.MovedRenderables) {
+            const auto objectIndex = g_indirectDrawData.RenderableObjectIndices[snapshotIndex];
+            if (objectIndex < g_indirectDrawData.Objects.size()) {
+                MarkGpuObjectDirty(objectIndex, snapshot.Renderables[snapshotIndex].WorldMatrix);
+            }
         }
+    }
 
-        const auto& globalLight = registry.get<TComponentGlobalLight>(globalLightEntity);
+    if (g_indirectDrawData.FirstDirtyObject <= g_indirectDrawData.LastDirtyObject) {
+        const auto firstDirtyObject = g_indirectDrawData.FirstDirtyObject;
+        const auto dirtyObjectCount = g_indirectDrawData.LastDirtyObject - firstDirtyObject + 1;
+        UpdateBuffer(
+            g_objectsBuffer,
+            sizeof(TGpuObject) * firstDirtyObject,
+            sizeof(TGpuObject) * dirtyObjectCount,
+            &g_indirectDrawData.Objects[firstDirtyObject]);
+    }
 
-        if (!globalLight.IsEnabled || !globalLight.CanCastShadows) {
-            lightIndex++;
+    g_indirectDrawData.FirstDirtyObject = std::numeric_limits<uint32_t>::max();
+    g_indirectDrawData.LastDirtyObject = 0;
+}
+
+auto inline GetDrawCountOffset(
+    const size_t viewIndex,
+    const size_t batchIndex,
+    const size_t depthBucket) -> size_t {
+
+    return sizeof(uint32_t) * ((viewIndex * g_indirectDrawData.Batches.size() + batchIndex) * DEPTH_BUCKET_COUNT + depthBucket);
+}
+
+auto inline GetDrawCommandOffset(
+    const size_t viewIndex,
+    const TDrawBatch& drawBatch,
+    const size_t depthBucket) -> size_t {
+
+    return sizeof(TDrawElementsIndirectCommand) * ((viewIndex * DEPTH_BUCKET_COUNT + depthBucket) * MAX_GPU_OBJECTS + drawBatch.FirstInstanceGroup);
+}
+
+auto inline RecordCulledBatches(
+    TCommandList& commandList,
+    const size_t viewIndex) -> void {
+
+    for (std::size_t batchIndex = 0; batchIndex < g_indirectDrawData.Batches.size(); ++batchIndex) {
+
+        PROFILER_ZONESCOPEDN("Draw Batch");
+
+        // pipeline state changes go here once the render queue knows more than one pipeline
+        const auto& drawBatch = g_indirectDrawData.Batches[batchIndex];
+        for (std::size_t depthBucket = 0; depthBucket < DEPTH_BUCKET_COUNT; ++depthBucket) {
+            commandList.MultiDrawElementsIndirectCount(
+                g_geometryBuffers.IndexBuffer,
+                g_indirectDrawData.CommandBuffer,
+                GetDrawCommandOffset(viewIndex, drawBatch, depthBucket),
+                g_cullingPass.DrawCountsBuffer,
+                GetDrawCountOffset(viewIndex, batchIndex, depthBucket),
+                drawBatch.InstanceGroupCount);
+        }
+    }
+}
+
+// every object asks for the mip its material textures need at the object's nearest point. objects
+// outside the frustum ask too, so turning the camera around does not show blurry textures
+auto inline UpdateStreamedTextures(const uint64_t frameIndex) -> void {
+
+    PROFILER_ZONESCOPEDN("Update Streamed Textures");
+
+    const auto cameraPosition = glm::vec3(g_globalUniforms.CameraPosition);
+    const auto tanHalfFieldOfView = glm::tan(g_globalUniforms.CameraPosition.w * 0.5f);
+    const auto framebufferHeight = glm::max(g_scaledFramebufferSize.y, 1.0f);
+
+    const auto& objects = g_indirectDrawData.Objects;
+    for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+        const auto& materialTextures = g_gpuMaterialStreamedTextures[static_cast<std::size_t>(objects[objectIndex].InstanceParameter.x)];
+        const auto uvDensity = g_indirectDrawData.ObjectUvDensities[objectIndex];
+        if (materialTextures.empty() || uvDensity <= 0.0f) {
             continue;
         }
 
-        BindFramebuffer(g_shadowPass.Framebuffers[lightIndex]);
-        g_shadowPass.Pipeline.BindBufferAsUniformBuffer(g_globalLightsBuffer, 2);
-        g_shadowPass.Pipeline.SetUniform(0, lightIndex);
+        const auto& worldMatrix = objects[objectIndex].WorldMatrix;
+        const auto worldScale = glm::max(glm::max(
+            glm::length(glm::vec3(worldMatrix[0])),
+            glm::length(glm::vec3(worldMatrix[1]))),
+            glm::length(glm::vec3(worldMatrix[2])));
+        const auto& localBoundingSphere = g_indirectDrawData.DrawRecords[objectIndex].LocalBoundingSphere;
+        const auto center = glm::vec3(worldMatrix * glm::vec4(glm::vec3(localBoundingSphere), 1.0f));
+        const auto distance = glm::max(glm::distance(cameraPosition, center) - localBoundingSphere.w * worldScale, 0.1f);
+
+        // world units one pixel covers at that distance, then uv units, scaling the object stretches its uvs
+        const auto worldUnitsPerPixel = 2.0f * distance * tanHalfFieldOfView / framebufferHeight;
+        const auto uvPerPixel = worldUnitsPerPixel * uvDensity / glm::max(worldScale, 0.0001f);
+        for (const auto textureId : materialTextures) {
+            g_textureStreamer.RequestMip(textureId, uvPerPixel);
+        }
+    }
 
-        const auto& renderablesView = registry.view<TComponentGpuMesh, TComponentRenderTransform>();
-        renderablesView.each([&](
-            const entt::entity& entity,
-            const auto& meshComponent,
-            const auto& transformComponent) {
+    for (const auto textureId : g_textureStreamer.Update(frameIndex)) {
+        const auto& binding = g_streamedTextureBindings[static_cast<std::size_t>(textureId)];
+        if (binding.Handles.empty()) {
+            continue;
+        }
 
-            PROFILER_ZONESCOPEDN("Draw Shadow Geometry");
+        auto& gpuMaterial = g_gpuMaterials[binding.GpuMaterialIndex];
+        for (const auto handle : binding.Handles) {
+            gpuMaterial.*handle = g_textureStreamer.GetBindlessHandle(textureId);
+        }
+        UpdateBuffer(g_gpuMaterialsBuffer, sizeof(TGpuMaterial) * binding.GpuMaterialIndex, sizeof(TGpuMaterial), &gpuMaterial);
+    }
+}
+
+auto inline UpdateCpuOcclusion(const Renderer::TRenderSnapshot& snapshot) -> void {
 
-            const auto& gpuMesh = GetGpuMesh(meshComponent.GpuMesh);
+    if (!g_cpuOcclusionPass.IsEnabled || g_indirectDrawData.Objects.empty()) {
+        return;
+    }
 
-            g_shadowPass.Pipeline.BindBufferAsShaderStorageBuffer(gpuMesh.VertexPositionBuffer, 1);
-            g_shadowPass.Pipeline.SetUniform(1, transformComponent);
+    PROFILER_ZONESCOPEDN("Cpu Occlusion");
 
-            g_shadowPass.Pipeline.DrawElements(gpuMesh.IndexBuffer, gpuMesh.IndexCount);
+    auto& occluders = g_cpuOcclusionPass.Occluders;
+    occluders.clear();
+    for (const auto& renderable : snapshot.Renderables) {
+        if (!renderable.IsOccluder) {
+            continue;
+        }
+
+        const auto& assetPrimitive = Assets::GetAssetPrimitive(renderable.Mesh);
+        occluders.push_back(TOccluder{
+            .Positions = assetPrimitive.Positions,
+            .Indices = assetPrimitive.Indices,
+            .WorldMatrix = renderable.WorldMatrix,
         });
+    }
 
-        lightIndex++;
+    g_cpuOcclusionPass.Buffer.RenderOccluders(g_globalUniforms.ProjectionMatrix * g_globalUniforms.ViewMatrix, occluders);
+
+    const auto& objects = g_indirectDrawData.Objects;
+    const auto& drawRecords = g_indirectDrawData.DrawRecords;
+    auto& boundingSpheres = g_cpuOcclusionPass.BoundingSpheres;
+    boundingSpheres.resize(objects.size());
+    for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+        const auto& localBoundingSphere = drawRecords[objectIndex].LocalBoundingSphere;
+        boundingSpheres[objectIndex] = TransformBoundingSphere(
+            TBoundingSphere{glm::vec3{localBoundingSphere}, localBoundingSphere.w},
+            objects[objectIndex].WorldMatrix);
     }
 
+    auto& isVisible = g_cpuOcclusionPass.IsVisible;
+    isVisible.resize(objects.size());
+    g_cpuOcclusionPass.Buffer.TestBoundingSpheres(boundingSpheres, isVisible);
+
+    // one bit per object, the camera views of CullObjects.cs skip objects whose bit is cleared
+    auto& visibilityBits = g_cpuOcclusionPass.VisibilityBits;
+    visibilityBits.assign((objects.size() + 31) / 32, 0u);
+    for (std::size_t objectIndex = 0; objectIndex < objects.size(); ++objectIndex) {
+        if (isVisible[objectIndex] != 0) {
+            visibilityBits[objectIndex / 32] |= 1u << (objectIndex % 32);
+        }
+    }
+
+    UpdateBuffer(g_cpuOcclusionPass.VisibilityBuffer, 0, sizeof(uint32_t) * visibilityBits.size(), visibilityBits.data());
+}
+
+auto inline DispatchCulling(
+    const uint32_t firstViewIndex,
+    const uint32_t viewCount) -> void {
+
+    const auto objectCount = static_cast<uint32_t>(g_indirectDrawData.Objects.size());
+    const auto instanceGroupCount = static_cast<uint32_t>(g_indirectDrawData.InstanceGroups.size());
+    const auto batchCount = static_cast<uint32_t>(g_indirectDrawData.Batches.size());
+
+    // pass 1: append surviving objects to their instance group, per view and depth bucket
+    g_cullingPass.Pipeline.Bind();
+    g_cullingPass.Pipeline.BindBufferAsShaderStorageBuffer(g_objectsBuffer, 3);
+    g_cullingPass.Pipeline.BindBufferAsShaderStorageBuffer(g_indirectDrawData.DrawRecordsBuffer, 4);
+    g_cullingPass.Pipeline.BindBufferAsShaderStorageBuffer(g_cullingPass.CullViewsBuffer, 5);
+    g_cullingPass.Pipeline.BindBufferAsShaderStorageBuffer(g_indirectDrawData.InstanceIndicesBuffer, 6);
+    g_cullingPass.Pipeline.BindBufferAsShaderStorageBuffer(g_cullingPass.InstanceCountsBuffer, 7);
+    g_cullingPass.Pipeline.BindBufferAsShaderStorageBuffer(g_cpuOcclusionPass.VisibilityBuffer, 8);
+    g_cullingPass.Pipeline.SetUniform(0, objectCount);
+    g_cullingPass.Pipeline.SetUniform(1, instanceGroupCount);
+    g_cullingPass.Pipeline.SetUniform(2, static_cast<uint32_t>(MAX_GPU_OBJECTS));
+    g_cullingPass.Pipeline.SetUniform(3, static_cast<uint32_t>(DEPTH_BUCKET_COUNT));
+    g_cullingPass.Pipeline.SetUniform(4, firstViewIndex);
+    g_cullingPass.Pipeline.Dispatch(static_cast<int32_t>((objectCount + 63) / 64), static_cast<int32_t>(viewCount), 1);
+    g_cullingPass.Pipeline.InsertMemoryBarrier(TMemoryBarrierMaskBits::ShaderStorage);
+
+    // pass 2: one instanced draw command per non empty instance group
+    g_cullingPass.BuildDrawCommandsPipeline.Bind();
+    g_cullingPass.BuildDrawCommandsPipeline.BindBufferAsShaderStorageBuffer(g_indirectDrawData.InstanceGroupsBuffer, 4);
+    g_cullingPass.BuildDrawCommandsPipeline.BindBufferAsShaderStorageBuffer(g_cullingPass.InstanceCountsBuffer, 5);
+    g_cullingPass.BuildDrawCommandsPipeline.BindBufferAsShaderStorageBuffer(g_indirectDrawData.CommandBuffer, 6);
+    g_cullingPass.BuildDrawCommandsPipeline.BindBufferAsShaderStorageBuffer(g_cullingPass.DrawCountsBuffer, 7);
+    g_cullingPass.BuildDrawCommandsPipeline.SetUniform(0, instanceGroupCount);
+    g_cullingPass.BuildDrawCommandsPipeline.SetUniform(1, batchCount);
+    g_cullingPass.BuildDrawCommandsPipeline.SetUniform(2, static_cast<uint32_t>(MAX_GPU_OBJECTS));
+    g_cullingPass.BuildDrawCommandsPipeline.SetUniform(3, static_cast<uint32_t>(DEPTH_BUCKET_COUNT));
+    g_cullingPass.BuildDrawCommandsPipeline.SetUniform(4, firstViewIndex * DEPTH_BUCKET_COUNT);
+    g_cullingPass.BuildDrawCommandsPipeline.Dispatch(static_cast<int32_t>((instanceGroupCount + 63) / 64), static_cast<int32_t>(viewCount * DEPTH_BUCKET_COUNT), 1);
+
+    // the render graph issues the barrier in front of the first pass drawing from these buffers
+}
+
+auto inline CullRenderables() -> void {
+
+    PROFILER_ZONESCOPEDN("Cull Renderables");
+
+    const auto instanceGroupCount = static_cast<uint32_t>(g_indirectDrawData.InstanceGroups.size());
+    if (g_indirectDrawData.Objects.empty()) {
+        return;
+    }
+
+    PushDebugGroup("Culling Pass");
+
+    const auto createCullView = [](
+        const glm::mat4& viewProjection,
+        const bool isEnabled,
+        const bool isOcclusionCullingEnabled,
+        const bool isCpuOcclusionCullingEnabled) {
+
+        return TGpuCullView{
+            .ViewProjection = viewProjection,
+            .Planes = CreateFrustum(viewProjection).Planes,
+            .Properties = glm::uvec4{
+                isEnabled ? 1u : 0u,
+                g_cullingPass.IsEnabled ? 1u : 0u,
+                isOcclusionCullingEnabled ? 1u : 0u,
+                isCpuOcclusionCullingEnabled ? 1u : 0u
+            },
+        };
+    };
+
+    // frustum culling uses the unjittered camera, the jitter is sub pixel anyway,
+    // occlusion culling tests against the depth pre-pass and has to match it exactly
+    auto& cullViews = g_indirectDrawData.CullViews;
+    cullViews[0] = createCullView(g_globalUniforms.ProjectionMatrix * g_globalUniforms.ViewMatrix, true, false, g_cpuOcclusionPass.IsEnabled);
+    for (auto lightIndex = 0; lightIndex < MAX_GLOBAL_LIGHTS; ++lightIndex) {
+        const auto& gpuGlobalLight = g_gpuGlobalLights[lightIndex];
+        const auto isShadowViewEnabled = g_shadowPass.IsEnabled && gpuGlobalLight.LightProperties.x != 0 && gpuGlobalLight.LightProperties.y != 0;
+        cullViews[1 + lightIndex] = createCullView(gpuGlobalLight.ShadowViewProjectionMatrix, isShadowViewEnabled, false, false);
+    }
+    cullViews[CULL_VIEW_OCCLUDED_CAMERA] = createCullView(
+        g_globalUniforms.CurrentJitteredViewProjectionMatrix,
+        true,
+        g_hiZPass.IsEnabled,
+        g_cpuOcclusionPass.IsEnabled);
+
+    UpdateBuffer(g_cullingPass.CullViewsBuffer, 0, sizeof(TGpuCullView) * cullViews.size(), cullViews.data());
+    ClearBuffer(g_cullingPass.InstanceCountsBuffer, 0, sizeof(uint32_t) * CULL_VIEW_COUNT * DEPTH_BUCKET_COUNT * instanceGroupCount);
+    ClearBuffer(g_cullingPass.DrawCountsBuffer, 0, GetDrawCountOffset(CULL_VIEW_COUNT, 0, 0));
+
+    // the occluded camera view waits for the Hi-Z pyramid, see CullOccludedRenderables
+    DispatchCulling(0, CULL_VIEW_OCCLUDED_CAMERA);
+
     PopDebugGroup();
 }
 
-auto inline RenderDepthPrePass(entt::registry& registry) -> void {
+auto inline BuildHiZPyramid() -> void {
 
-    PROFILER_ZONESCOPEDN("All Depth PrePass Geometry");
-    PushDebugGroup("Depth PrePass");
-    BindFramebuffer(g_depthPrePass.Framebuffer);
-    {
-        g_depthPrePass.Pipeline.Bind();
-        g_depthPrePass.Pipeline.BindBufferAsUniformBuffer(g_globalUniformsBuffer, 0);
+    if (g_indirectDrawData.Objects.empty()) {
+        return;
+    }
 
-        const auto& renderablesView = registry.view<TComponentGpuMesh, TComponentTransform>();
-        renderablesView.each([&](
-            const entt::entity& entity,
-            const auto& meshComponent,
-            const auto& transformComponent) {
+    PROFILER_ZONESCOPEDN("Build HiZ Pyramid");
+    PushDebugGroup("HiZ Pass");
 
-            PROFILER_ZONESCOPEDN("Draw PrePass Geometry");
+    const auto& hiZTexture = g_renderGraph.GetTexture(g_renderGraphResources.HiZ);
 
-            const auto& gpuMesh = GetGpuMesh(meshComponent.GpuMesh);
+    g_hiZPass.Pipeline.Bind();
+    g_hiZPass.Pipeline.BindTexture(0, g_renderGraph.GetTexture(g_renderGraphResources.Depth).Id);
+    for (uint32_t level = 0; level < g_hiZPass.MipLevelCount; ++level) {
+        const auto levelWidth = std::max(1u, hiZTexture.Extent.Width >> level);
+        const auto levelHeight = std::max(1u, hiZTexture.Extent.Height >> level);
 
-            g_depthPrePass.Pipeline.BindBufferAsShaderStorageBuffer(gpuMesh.VertexPositionBuffer, 1);
-            g_depthPrePass.Pipeline.SetUniform(0, transformComponent);
+        g_hiZPass.Pipeline.BindImage(0, hiZTexture.Id, level == 0 ? 0 : static_cast<int32_t>(level - 1), 0, TMemoryAccess::ReadOnly, TFormat::R32_FLOAT);
+        g_hiZPass.Pipeline.BindImage(1, hiZTexture.Id, static_cast<int32_t>(level), 0, TMemoryAccess::WriteOnly, TFormat::R32_FLOAT);
+        g_hiZPass.Pipeline.SetUniform(0, level == 0 ? 1 : 0);
+        g_hiZPass.Pipeline.Dispatch(static_cast<int32_t>((levelWidth + 7) / 8), static_cast<int32_t>((levelHeight + 7) / 8), 1);
 
-            g_depthPrePass.Pipeline.DrawElements(gpuMesh.IndexBuffer, gpuMesh.IndexCount);
-        });
+        // the next level reads this one, culling samples the finished pyramid after the graph's barrier
+        if (level + 1 < g_hiZPass.MipLevelCount) {
+            g_hiZPass.Pipeline.InsertMemoryBarrier(TMemoryBarrierMaskBits::ShaderImageAccess);
+        }
     }
+
     PopDebugGroup();
 }
 
-auto inline RenderGeometryPass(const entt::registry& registry) -> void {
-    PROFILER_ZONESCOPEDN("Draw Geometry All");
-    PushDebugGroup("Geometry Pass");
-    BindFramebuffer(g_geometryPass.Framebuffer);
-    {
-        g_geometryPass.Pipeline.Bind();
-        g_geometryPass.Pipeline.BindBufferAsUniformBuffer(g_globalUniformsBuffer, 0);
-
-        const auto& renderablesView = registry.view<TComponentGpuMesh, TComponentGpuMaterial, TComponentRenderTransform>();
-        renderablesView.each([&](
-            const entt::entity& entity,
-            const auto& meshComponent,
-            const auto& materialComponent,
-            const auto& transformComponent) {
-
-            PROFILER_ZONESCOPEDN("Draw Geometry");
-
-            auto& cpuMaterial = GetCpuMaterial(materialComponent.GpuMaterial);
-            auto& gpuMesh = GetGpuMesh(meshComponent.GpuMesh);
-
-            g_geometryPass.Pipeline.BindBufferAsShaderStorageBuffer(gpuMesh.VertexPositionBuffer, 1);
-            g_geometryPass.Pipeline.BindBufferAsShaderStorageBuffer(gpuMesh.VertexNormalUvTangentBuffer, 2);
-            g_geometryPass.Pipeline.SetUniform(0, transformComponent);
-            g_geometryPass.Pipeline.SetUniform(5, cpuMaterial.NormalStrengthRoughnessMetalnessEmissiveStrength);
-            g_geometryPass.Pipeline.SetUniform(6, cpuMaterial.EmissiveColor);
-            g_geometryPass.Pipeline.SetUniform(7, cpuMaterial.HasTextureFlags);
-
-            g_geometryPass.Pipeline.BindTextureAndSampler(8, cpuMaterial.BaseColorTexture.Id, *cpuMaterial.BaseColorTexture.SamplerId);
-            g_geometryPass.Pipeline.BindTextureAndSampler(9, cpuMaterial.NormalTexture.Id, *cpuMaterial.NormalTexture.SamplerId);
-            if (cpuMaterial.ArmTexture.Id != 0) {
-                g_geometryPass.Pipeline.BindTextureAndSampler(10, cpuMaterial.ArmTexture.Id, *cpuMaterial.ArmTexture.SamplerId);
-            } else if (cpuMaterial.MetallicRoughnessTexture.Id != 0) {
-                g_geometryPass.Pipeline.BindTextureAndSampler(10, cpuMaterial.MetallicRoughnessTexture.Id, *cpuMaterial.MetallicRoughnessTexture.SamplerId);
-            } else {
-                g_geometryPass.Pipeline.BindTextureAndSampler(10, 0, 0);
-            }
-            if (cpuMaterial.EmissiveTexture.Id != 0) {
-                g_geometryPass.Pipeline.BindTextureAndSampler(11, cpuMaterial.EmissiveTexture.Id, *cpuMaterial.EmissiveTexture.SamplerId);
-            } else {
-                g_geometryPass.Pipeline.BindTextureAndSampler(11, 0, 0);
-            }
+// one work group per screen tile, it reduces the tile's depth range first so empty froxels get no lights
+auto inline BuildLightClusters() -> void {
 
-            g_geometryPass.Pipeline.DrawElements(gpuMesh.IndexBuffer, gpuMesh.IndexCount);
-        });
+    PROFILER_ZONESCOPEDN("Build Light Clusters");
+    PushDebugGroup("Light Cluster Pass");
+
+    g_lightClusterPass.Pipeline.Bind();
+    g_lightClusterPass.Pipeline.BindTexture(0, g_renderGraph.GetTexture(g_renderGraphResources.Depth).Id);
+    const auto& localLightsAllocation = g_lightClusterPass.LocalLightsAllocation;
+    g_lightClusterPass.Pipeline.BindBufferAsShaderStorageBuffer(localLightsAllocation.Buffer, 0, localLightsAllocation.Offset, localLightsAllocation.Size);
+    g_lightClusterPass.Pipeline.BindBufferAsShaderStorageBuffer(g_lightClusterPass.LightClustersBuffer, 1);
+    g_lightClusterPass.Pipeline.SetUniform(0, glm::inverse(g_globalUniforms.ProjectionMatrix));
+    g_lightClusterPass.Pipeline.SetUniform(4, g_globalUniforms.ViewMatrix);
+    g_lightClusterPass.Pipeline.SetUniform(8, g_lightClusterPass.LocalLightCount);
+    g_lightClusterPass.Pipeline.Dispatch(static_cast<int32_t>(LIGHT_CLUSTER_COUNT_X), static_cast<int32_t>(LIGHT_CLUSTER_COUNT_Y), 1);
+
+    PopDebugGroup();
+}
+
+auto inline CullOccludedRenderables() -> void {
+
+    if (g_indirectDrawData.Objects.empty()) {
+        return;
     }
+
+    PROFILER_ZONESCOPEDN("Cull Occluded Renderables");
+    PushDebugGroup("Occlusion Culling Pass");
+
+    if (g_hiZPass.IsEnabled) {
+        g_cullingPass.Pipeline.BindTexture(0, g_renderGraph.GetTexture(g_renderGraphResources.HiZ).Id);
+    }
+    DispatchCulling(CULL_VIEW_OCCLUDED_CAMERA, 1);
+
     PopDebugGroup();
 }
 
+auto inline RecordShadowPass(
+    TCommandList& commandList,
+    const Renderer::TRenderSnapshot& snapshot) -> void {
+
+    PROFILER_ZONESCOPEDN("Record Shadow Pass");
+
+    commandList.PushDebugGroup("Shadow Pass");
+
+    auto lightIndex = 0;
+
+    commandList.BindPipeline(g_shadowPass.Pipeline);
+
+    for (const auto& globalLight : snapshot.GlobalLights) {
+        if (lightIndex >= MAX_GLOBAL_LIGHTS) {
+            break;
+        }
+
+        if (!globalLight.IsEnabled || !globalLight.CanCastShadows) {
+            lightIndex++;
+            continue;
+        }
+
+        commandList.BindFramebuffer(g_shadowPass.Framebuffers[lightIndex]);
+        commandList.BindBufferAsUniformBuffer(g_globalLightsAllocation.Buffer, 2, g_globalLightsAllocation.Offset, g_globalLightsAllocation.Size);
+        commandList.BindBufferAsShaderStorageBuffer(g_geometryBuffers.VertexPositionBuffer, 1);
+        commandList.BindBufferAsShaderStorageBuffer(g_objectsBuffer, 3);
+        commandList.BindBufferAsShaderStorageBuffer(g_indirectDrawData.InstanceIndicesBuffer, 5);
+        commandList.SetUniform(0, lightIndex);
+
+        RecordCulledBatches(commandList, 1 + lightIndex);
+
+        lightIndex++;
+    }
+
+    commandList.PopDebugGroup();
+}
+
+auto inline RecordDepthPrePass(TCommandList& commandList) -> void {
+
+    PROFILER_ZONESCOPEDN("Record Depth PrePass");
+
+    commandList.PushDebugGroup("Depth PrePass");
+    commandList.BindFramebuffer(g_renderGraph.GetFramebuffer(g_depthPrePass.GraphPass));
+    commandList.BindPipeline(g_depthPrePass.Pipeline);
+    commandList.BindBufferAsUniformBuffer(g_globalUniformsAllocation.Buffer, 0, g_globalUniformsAllocation.Offset, g_globalUniformsAllocation.Size);
+    commandList.BindBufferAsShaderStorageBuffer(g_geometryBuffers.VertexPositionBuffer, 1);
+    commandList.BindBufferAsShaderStorageBuffer(g_objectsBuffer, 3);
+    commandList.BindBufferAsShaderStorageBuffer(g_indirectDrawData.InstanceIndicesBuffer, 5);
+
+    RecordCulledBatches(commandList, 0);
+
+    commandList.PopDebugGroup();
+}
+
+auto inline RecordGeometryPass(TCommandList& commandList) -> void {
+
+    PROFILER_ZONESCOPEDN("Record Geometry Pass");
+
+    commandList.PushDebugGroup("Geometry Pass");
+    commandList.BindFramebuffer(g_renderGraph.GetFramebuffer(g_geometryPass.GraphPass));
+    commandList.BindPipeline(g_geometryPass.Pipeline);
+    commandList.BindBufferAsUniformBuffer(g_globalUniformsAllocation.Buffer, 0, g_globalUniformsAllocation.Offset, g_globalUniformsAllocation.Size);
+    commandList.BindBufferAsShaderStorageBuffer(g_geometryBuffers.VertexPositionBuffer, 1);
+    commandList.BindBufferAsShaderStorageBuffer(g_geometryBuffers.VertexNormalUvTangentBuffer, 2);
+    commandList.BindBufferAsShaderStorageBuffer(g_objectsBuffer, 3);
+    commandList.BindBufferAsShaderStorageBuffer(g_gpuMaterialsBuffer, 4);
+    commandList.BindBufferAsShaderStorageBuffer(g_indirectDrawData.InstanceIndicesBuffer, 5);
+    commandList.BindBufferAsShaderStorageBuffer(g_virtualTextures.GetVirtualTexturesBuffer(), 6);
+    commandList.BindBufferAsShaderStorageBuffer(g_virtualTextures.GetPageTableBuffer(), 7);
+
+    RecordCulledBatches(commandList, CULL_VIEW_OCCLUDED_CAMERA);
+
+    commandList.PopDebugGroup();
+}
+
+auto inline RecordVirtualTextureFeedbackPass(TCommandList& commandList) -> void {
+
+    PROFILER_ZONESCOPEDN("Record Virtual Texture Feedback Pass");
+
+    commandList.PushDebugGroup("Virtual Texture Feedback Pass");
+    commandList.BindFramebuffer(g_renderGraph.GetFramebuffer(g_virtualTextureFeedbackPass.GraphPass));
+    commandList.BindPipeline(g_virtualTextureFeedbackPass.Pipeline);
+    commandList.BindBufferAsUniformBuffer(g_globalUniformsAllocation.Buffer, 0, g_globalUniformsAllocation.Offset, g_globalUniformsAllocation.Size);
+    commandList.BindBufferAsShaderStorageBuffer(g_geometryBuffers.VertexPositionBuffer, 1);
+    commandList.BindBufferAsShaderStorageBuffer(g_geometryBuffers.VertexNormalUvTangentBuffer, 2);
+    commandList.BindBufferAsShaderStorageBuffer(g_objectsBuffer, 3);
+    commandList.BindBufferAsShaderStorageBuffer(g_gpuMaterialsBuffer, 4);
+    commandList.BindBufferAsShaderStorageBuffer(g_indirectDrawData.InstanceIndicesBuffer, 5);
+    commandList.BindBufferAsShaderStorageBuffer(g_virtualTextures.GetVirtualTexturesBuffer(), 6);
+    commandList.BindBufferAsShaderStorageBuffer(g_virtualTextures.GetPageTableBuffer(), 7);
+    commandList.BindBufferAsShaderStorageBuffer(g_virtualTextures.GetFeedbackBuffer(), 8);
+    commandList.SetUniform(0, -std::log2(static_cast<float>(VIRTUAL_TEXTURE_FEEDBACK_SCALE)));
+
+    RecordCulledBatches(commandList, CULL_VIEW_OCCLUDED_CAMERA);
+
+    commandList.PopDebugGroup();
+}
+
+// everything the scene passes read on the cpu is final once the render graph is compiled, so their
+// lists are recorded side by side on the pool and only replayed on this thread, in frame order
+auto inline RecordScenePasses(const Renderer::TRenderSnapshot& snapshot) -> void {
+
+    PROFILER_ZONESCOPEDN("Record Scene Passes");
+
+    g_shadowPass.CommandList.Reset();
+    g_depthPrePass.CommandList.Reset();
+    g_geometryPass.CommandList.Reset();
+    g_virtualTextureFeedbackPass.CommandList.Reset();
+
+    const auto passIndices = std::ranges::iota_view{0, 4};
+    std::for_each(poolstl::execution::par, passIndices.begin(), passIndices.end(), [&](const int32_t passIndex) {
+        switch (passIndex) {
+            case 0:
+                if (g_shadowPass.IsEnabled) {
+                    RecordShadowPass(g_shadowPass.CommandList, snapshot);
+                }
+                break;
+            case 1:
+                RecordDepthPrePass(g_depthPrePass.CommandList);
+                break;
+            case 2:
+                RecordGeometryPass(g_geometryPass.CommandList);
+                break;
+            case 3:
+                if (g_virtualTextureFeedbackPass.GraphPass != TRenderGraphPassId::Invalid) {
+                    RecordVirtualTextureFeedbackPass(g_virtualTextureFeedbackPass.CommandList);
+                }
+                break;
+            default:
+                std::unreachable();
+        }
+    });
+}
+
+auto inline RenderShadowPass() -> void {
+
+    PROFILER_ZONESCOPEDN("Shadow Pass");
+    SubmitCommandList(g_shadowPass.CommandList);
+}
+
+auto inline RenderDepthPrePass() -> void {
+
+    PROFILER_ZONESCOPEDN("All Depth PrePass Geometry");
+    SubmitCommandList(g_depthPrePass.CommandList);
+}
+
+auto inline RenderGeometryPass() -> void {
+
+    PROFILER_ZONESCOPEDN("Draw Geometry All");
+    SubmitCommandList(g_geometryPass.CommandList);
+}
+
 auto inline RenderComposePass() -> void {
     PROFILER_ZONESCOPEDN("Draw ComposeGeometry");
     PushDebugGroup("ComposeGeometry");
-    BindFramebuffer(g_composePass.Framebuffer);
+    BindFramebuffer(g_renderGraph.GetFramebuffer(g_composePass.GraphPass));
     {
         const auto& sampler = GetSampler(g_fstSamplerNearestClampToEdge);
 
         g_composePass.Pipeline.Bind();
-        g_composePass.Pipeline.BindBufferAsUniformBuffer(g_globalLightsBuffer, 1);
-        g_composePass.Pipeline.BindTexture(0, g_depthPrePass.Framebuffer.DepthStencilAttachment->Texture.Id);
-        g_composePass.Pipeline.BindTexture(1, g_geometryPass.Framebuffer.ColorAttachments[0]->Texture.Id);
-        g_composePass.Pipeline.BindTexture(2, g_geometryPass.Framebuffer.ColorAttachments[1]->Texture.Id);
-        g_composePass.Pipeline.BindTexture(3, g_geometryPass.Framebuffer.ColorAttachments[2]->Texture.Id);
-        g_composePass.Pipeline.BindTexture(4, g_geometryPass.Framebuffer.ColorAttachments[3]->Texture.Id);
+        g_composePass.Pipeline.BindBufferAsUniformBuffer(g_globalLightsAllocation.Buffer, 1, g_globalLightsAllocation.Offset, g_globalLightsAllocation.Size);
+        g_composePass.Pipeline.BindTexture(0, g_renderGraph.GetTexture(g_renderGraphResources.Depth).Id);
+        g_composePass.Pipeline.BindTexture(1, g_renderGraph.GetTexture(g_renderGraphResources.Albedo).Id);
+        g_composePass.Pipeline.BindTexture(2, g_renderGraph.GetTexture(g_renderGraphResources.Normals).Id);
+        g_composePass.Pipeline.BindTexture(3, g_renderGraph.GetTexture(g_renderGraphResources.AoRoughnessMetalness).Id);
+        g_composePass.Pipeline.BindTexture(4, g_renderGraph.GetTexture(g_renderGraphResources.Emissive).Id);
 
         // Bind shadow maps
         for (int i = 0; i < MAX_GLOBAL_LIGHTS; ++i) {
@@ -1978,6 +3065,12 @@ auto inline RenderComposePass() -> void {
         g_composePass.Pipeline.SetUniform(4, g_globalUniforms.CameraPosition);
         g_composePass.Pipeline.SetUniform(5, g_sunPosition);
         g_composePass.Pipeline.SetUniform(6, g_scaledFramebufferSize);
+        g_composePass.Pipeline.SetUniform(7, g_globalUniforms.ViewMatrix);
+        g_composePass.Pipeline.SetUniform(11, g_gpuGlobalLightCount);
+
+        const auto& localLightsAllocation = g_lightClusterPass.LocalLightsAllocation;
+        g_composePass.Pipeline.BindBufferAsShaderStorageBuffer(localLightsAllocation.Buffer, 0, localLightsAllocation.Offset, localLightsAllocation.Size);
+        g_composePass.Pipeline.BindBufferAsShaderStorageBuffer(g_lightClusterPass.LightClustersBuffer, 1);
 
         g_composePass.Pipeline.DrawArrays(0, 3);
     }
@@ -1991,59 +3084,54 @@ auto inline RenderDebugLines() -> void {
         PROFILER_ZONESCOPEDN("Draw DebugLines");
 
         PushDebugGroup("Debug Lines");
-        glDisable(GL_CULL_FACE);
+        BindFramebuffer(g_renderGraph.GetFramebuffer(g_debugLinesPass.GraphPass));
 
-        UpdateBuffer(g_debugLinesPass.VertexBuffer, 0, sizeof(TGpuDebugLine) * g_debugLinesPass.DebugLines.size(), g_debugLinesPass.DebugLines.data());
+        const auto debugLineCount = std::min(g_debugLinesPass.DebugLines.size(), static_cast<std::size_t>(MAX_DEBUG_LINES));
+        const auto debugLinesAllocation = AllocateFromRingBuffer(g_frameRingBuffer, sizeof(TGpuDebugLine) * debugLineCount, g_debugLinesPass.DebugLines.data());
 
         g_debugLinesPass.Pipeline.Bind();
-        g_debugLinesPass.Pipeline.BindBufferAsVertexBuffer(g_debugLinesPass.VertexBuffer, 0, 0, sizeof(TGpuDebugLine) / 2);
-        g_debugLinesPass.Pipeline.BindBufferAsUniformBuffer(g_globalUniformsBuffer, 0);
-        g_debugLinesPass.Pipeline.DrawArrays(0, g_debugLinesPass.DebugLines.size() * 2);
+        g_debugLinesPass.Pipeline.BindBufferAsVertexBuffer(debugLinesAllocation.Buffer, 0, debugLinesAllocation.Offset, sizeof(TGpuDebugLine) / 2);
+        g_debugLinesPass.Pipeline.BindBufferAsUniformBuffer(g_globalUniformsAllocation.Buffer, 0, g_globalUniformsAllocation.Offset, g_globalUniformsAllocation.Size);
+        g_debugLinesPass.Pipeline.DrawArrays(0, debugLineCount * 2);
 
-        glEnable(GL_CULL_FACE);
         PopDebugGroup();
     }
 }
 
 auto inline RenderFxaaPass() -> void {
-    if (g_fxaaPass.IsEnabled) {
-        PROFILER_ZONESCOPEDN("PostFX FXAA");
-        PushDebugGroup("PostFX FXAA");
-        BindFramebuffer(g_fxaaPass.Framebuffer);
-        {
-            g_fxaaPass.Pipeline.Bind();
-            g_fxaaPass.Pipeline.BindTexture(0, g_composePass.Framebuffer.ColorAttachments[0]->Texture.Id);
-            g_fxaaPass.Pipeline.SetUniform(1, 1);
-            g_fxaaPass.Pipeline.DrawArrays(0, 3);
-        }
-        PopDebugGroup();
+    PROFILER_ZONESCOPEDN("PostFX FXAA");
+    PushDebugGroup("PostFX FXAA");
+    BindFramebuffer(g_renderGraph.GetFramebuffer(g_fxaaPass.GraphPass));
+    {
+        g_fxaaPass.Pipeline.Bind();
+        g_fxaaPass.Pipeline.BindTexture(0, g_renderGraph.GetTexture(g_renderGraphResources.Composed).Id);
+        g_fxaaPass.Pipeline.SetUniform(1, 1);
+        g_fxaaPass.Pipeline.DrawArrays(0, 3);
     }
+    PopDebugGroup();
 }
 
 auto inline RenderTaaPass() -> void {
-    if (g_taaPass.IsEnabled) {
-        PROFILER_ZONESCOPEDN("PostFX TAA");
-        PushDebugGroup("PostFX TAA");
-        const auto& taaFramebuffer = g_taaPass.Framebuffers[g_taaPass.HistoryIndex];
-        BindFramebuffer(taaFramebuffer);
+    PROFILER_ZONESCOPEDN("PostFX TAA");
+    PushDebugGroup("PostFX TAA");
+    BindFramebuffer(g_renderGraph.GetFramebuffer(g_taaPass.GraphPass));
 
-        const auto& taaSampler = GetSampler(g_taaPass.Sampler);
+    const auto& taaSampler = GetSampler(g_taaPass.Sampler);
 
-        g_taaPass.Pipeline.Bind();
-        g_taaPass.Pipeline.BindTextureAndSampler(0, g_composePass.Framebuffer.ColorAttachments[0]->Texture.Id, taaSampler.Id); // last color buffer
-        g_taaPass.Pipeline.BindTextureAndSampler(1, taaFramebuffer.ColorAttachments[0]->Texture.Id, taaSampler.Id); // taa history buffer
-        g_taaPass.Pipeline.BindTextureAndSampler(2, g_geometryPass.Framebuffer.ColorAttachments[2]->Texture.Id, taaSampler.Id); // velocity buffer
-        g_taaPass.Pipeline.BindTexture(3, g_geometryPass.Framebuffer.DepthStencilAttachment->Texture.Id); // depth buffer
-        g_taaPass.Pipeline.SetUniform(0, g_taaPass.BlendFactor);
-        g_taaPass.Pipeline.SetUniform(1, 0.1f);
-        g_taaPass.Pipeline.SetUniform(2, 256.0f);
+    g_taaPass.Pipeline.Bind();
+    g_taaPass.Pipeline.BindTextureAndSampler(0, g_renderGraph.GetTexture(g_renderGraphResources.Composed).Id, taaSampler.Id); // last color buffer
+    g_taaPass.Pipeline.BindTextureAndSampler(1, g_renderGraph.GetTexture(g_renderGraphResources.TaaHistory).Id, taaSampler.Id); // taa history buffer
+    g_taaPass.Pipeline.BindTextureAndSampler(2, g_renderGraph.GetTexture(g_renderGraphResources.Velocity).Id, taaSampler.Id); // velocity buffer
+    g_taaPass.Pipeline.BindTexture(3, g_renderGraph.GetTexture(g_renderGraphResources.Depth).Id); // depth buffer
+    g_taaPass.Pipeline.SetUniform(0, g_taaPass.BlendFactor);
+    g_taaPass.Pipeline.SetUniform(1, 0.1f);
+    g_taaPass.Pipeline.SetUniform(2, 256.0f);
 
-        g_taaPass.Pipeline.DrawArrays(0, 3);
+    g_taaPass.Pipeline.DrawArrays(0, 3);
 
-        PopDebugGroup();
+    PopDebugGroup();
 
-        g_taaPass.HistoryIndex ^= 1;
-    }
+    g_taaPass.HistoryIndex ^= 1;
 }
 
 auto inline RenderUi(Renderer::TRenderContext& renderContext, entt::registry& registry) -> void {
@@ -2053,10 +3141,10 @@ auto inline RenderUi(Renderer::TRenderContext& renderContext, entt::registry& re
         glClear(GL_COLOR_BUFFER_BIT);
     } else {
         glBlitNamedFramebuffer(g_fxaaPass.IsEnabled
-                                   ? g_fxaaPass.Framebuffer.Id
+                                   ? g_renderGraph.GetFramebuffer(g_fxaaPass.GraphPass).Id
                                    : g_taaPass.IsEnabled
-                                       ? g_taaPass.Framebuffers[g_taaPass.HistoryIndex].Id
-                                       : g_composePass.Framebuffer.Id,
+                                       ? g_renderGraph.GetFramebuffer(g_taaPass.GraphPass).Id
+                                       : g_renderGraph.GetFramebuffer(g_composePass.GraphPass).Id,
                                0,
                                0, 0, static_cast<int32_t>(g_scaledFramebufferSize.x), static_cast<int32_t>(g_scaledFramebufferSize.y),
                                0, 0, g_windowFramebufferSize.x, g_windowFramebufferSize.y,
@@ -2068,34 +3156,266 @@ auto inline RenderUi(Renderer::TRenderContext& renderContext, entt::registry& re
     PopDebugGroup();
 }
 
-auto Renderer::Render(
-    TRenderContext& renderContext,
+// declares this frame's passes in execution order, Compile culls and aliases, Execute replays them.
+// fxaa is always declared and only survives while something presents or views its output
+auto inline BuildRenderGraph(
+    Renderer::TRenderContext& renderContext,
     entt::registry& registry) -> void {
 
-    if (g_playerEntity == entt::null) {
-        g_playerEntity = registry.view<TComponentCamera>().front();
+    PROFILER_ZONESCOPEDN("Build Render Graph");
+
+    using enum TRenderGraphResourceUsage;
+
+    g_renderGraph.Reset();
+
+    auto& resources = g_renderGraphResources;
+    const auto extent = TExtent2D(static_cast<uint32_t>(g_scaledFramebufferSize.x), static_cast<uint32_t>(g_scaledFramebufferSize.y));
+    const auto& taaHistoryTexture = GetTexture(g_taaPass.HistoryTextures[g_taaPass.HistoryIndex ^ 1]);
+    const auto& taaOutputTexture = GetTexture(g_taaPass.HistoryTextures[g_taaPass.HistoryIndex]);
+
+    resources.CulledDraws = g_renderGraph.ImportBuffer("Culled Draws", g_indirectDrawData.CommandBuffer);
+    resources.LightClusters = g_renderGraph.ImportBuffer("Light Clusters", g_lightClusterPass.LightClustersBuffer);
+    for (auto lightIndex = 0; lightIndex < MAX_GLOBAL_LIGHTS; ++lightIndex) {
+        resources.ShadowMaps[lightIndex] = g_renderGraph.ImportTexture("Shadow Map", g_shadowPass.ShadowMaps[lightIndex]);
+    }
+    resources.TaaHistory = g_renderGraph.ImportTexture("TAA History", taaHistoryTexture);
+    resources.TaaOutput = g_renderGraph.ImportTexture("TAA Output", taaOutputTexture);
+
+    resources.Depth = g_renderGraph.CreateTexture({.Label = "Depth", .Format = TFormat::D24_UNORM_S8_UINT, .Extent = extent});
+    resources.Albedo = g_renderGraph.CreateTexture({.Label = "Albedo", .Format = TFormat::R8G8B8A8_SRGB, .Extent = extent});
+    // 20 bytes per pixel, normals are octahedral encoded, see Geometry.fs.glsl
+    resources.Normals = g_renderGraph.CreateTexture({.Label = "Normals", .Format = TFormat::R16G16_SNORM, .Extent = extent});
+    resources.Velocity = g_renderGraph.CreateTexture({.Label = "Velocity", .Format = TFormat::R16G16_FLOAT, .Extent = extent});
+    resources.Emissive = g_renderGraph.CreateTexture({.Label = "Emissive", .Format = TFormat::R11G11B10_FLOAT, .Extent = extent});
+    resources.AoRoughnessMetalness = g_renderGraph.CreateTexture({.Label = "AoRoughnessMetalness", .Format = TFormat::R8G8B8A8_UNORM, .Extent = extent});
+    resources.Composed = g_renderGraph.CreateTexture({.Label = "Composed", .Format = TFormat::R8G8B8A8_SRGB, .Extent = extent});
+    resources.Fxaa = g_renderGraph.CreateTexture({.Label = "Fxaa", .Format = TFormat::R8G8B8A8_SRGB, .Extent = extent});
+    resources.Output = g_taaPass.IsEnabled ? resources.TaaOutput : resources.Composed;
+
+    const auto cullingPass = g_renderGraph.AddPass("Culling", CullRenderables);
+    g_renderGraph.Write(cullingPass, resources.CulledDraws, StorageBuffer);
+
+    if (g_shadowPass.IsEnabled) {
+        const auto shadowPass = g_renderGraph.AddPass("Shadow Pass", RenderShadowPass);
+        g_renderGraph.Read(shadowPass, resources.CulledDraws, IndirectBuffer);
+        g_renderGraph.Read(shadowPass, resources.CulledDraws, StorageBuffer);
+        for (const auto shadowMap : resources.ShadowMaps) {
+            g_renderGraph.Write(shadowPass, shadowMap, DepthStencilAttachment);
+        }
     }
 
-    ResetDebugLines();
+    g_depthPrePass.GraphPass = g_renderGraph.AddPass("Depth PrePass", RenderDepthPrePass);
+    g_renderGraph.Read(g_depthPrePass.GraphPass, resources.CulledDraws, IndirectBuffer);
+    g_renderGraph.Read(g_depthPrePass.GraphPass, resources.CulledDraws, StorageBuffer);
+    g_renderGraph.WriteDepthStencilAttachment(g_depthPrePass.GraphPass, resources.Depth, TFramebufferAttachmentLoadOperation::Clear, {1.0f, 0});
+
+    resources.HiZ = TRenderGraphResourceId::Invalid;
+    if (g_hiZPass.IsEnabled) {
+        g_hiZPass.MipLevelCount = 1 + static_cast<uint32_t>(glm::floor(glm::log2(glm::max(g_scaledFramebufferSize.x, g_scaledFramebufferSize.y))));
+        resources.HiZ = g_renderGraph.CreateTexture({.Label = "HiZ", .Format = TFormat::R32_FLOAT, .Extent = extent, .MipMapLevels = g_hiZPass.MipLevelCount});
+
+        const auto hiZPass = g_renderGraph.AddPass("HiZ Pass", BuildHiZPyramid);
+        g_renderGraph.Read(hiZPass, resources.Depth, SampledTexture);
+        g_renderGraph.Write(hiZPass, resources.HiZ, StorageImage);
+    }
+
+    g_lightClusterPass.GraphPass = g_renderGraph.AddPass("Light Cluster Pass", BuildLightClusters);
+    g_renderGraph.Read(g_lightClusterPass.GraphPass, resources.Depth, SampledTexture);
+    g_renderGraph.Write(g_lightClusterPass.GraphPass, resources.LightClusters, StorageBuffer);
+
+    const auto occlusionCullingPass = g_renderGraph.AddPass("Occlusion Culling Pass", CullOccludedRenderables);
+    if (g_hiZPass.IsEnabled) {
+        g_renderGraph.Read(occlusionCullingPass, resources.HiZ, SampledTexture);
+    }
+    g_renderGraph.Read(occlusionCullingPass, resources.CulledDraws, StorageBuffer);
+    g_renderGraph.Write(occlusionCullingPass, resources.CulledDraws, StorageBuffer);
+
+    g_geometryPass.GraphPass = g_renderGraph.AddPass("Geometry Pass", RenderGeometryPass);
+    g_renderGraph.Read(g_geometryPass.GraphPass, resources.CulledDraws, IndirectBuffer);
+    g_renderGraph.Read(g_geometryPass.GraphPass, resources.CulledDraws, StorageBuffer);
+    g_renderGraph.WriteColorAttachment(g_geometryPass.GraphPass, resources.Albedo, 0, TFramebufferAttachmentLoadOperation::Clear, { 0.0f, 0.0f, 0.0f, 1.0f });
+    g_renderGraph.WriteColorAttachment(g_geometryPass.GraphPass, resources.Normals, 1, TFramebufferAttachmentLoadOperation::Clear, { 0.0f, 0.0f, 0.0f, 0.0f });
+    g_renderGraph.WriteColorAttachment(g_geometryPass.GraphPass, resources.Velocity, 2, TFramebufferAttachmentLoadOperation::Clear, { 0.0f, 0.0f, 0.0f, 0.0f });
+    g_renderGraph.WriteColorAttachment(g_geometryPass.GraphPass, resources.Emissive, 3, TFramebufferAttachmentLoadOperation::Clear, { 0.0f, 0.0f, 0.0f, 1.0f });
+    g_renderGraph.WriteColorAttachment(g_geometryPass.GraphPass, resources.AoRoughnessMetalness, 4, TFramebufferAttachmentLoadOperation::Clear, { 1.0f, 0.0f, 0.0f, 1.0f });
+    g_renderGraph.WriteDepthStencilAttachment(g_geometryPass.GraphPass, resources.Depth, TFramebufferAttachmentLoadOperation::Load);
+
+    // the flags are read back a few frames later by g_virtualTextures.Update, importing the buffer keeps the pass alive
+    g_virtualTextureFeedbackPass.GraphPass = TRenderGraphPassId::Invalid;
+    if (!g_virtualTextures.IsEmpty()) {
+        const auto feedbackExtent = TExtent2D(
+            std::max(extent.Width / VIRTUAL_TEXTURE_FEEDBACK_SCALE, 1u),
+            std::max(extent.Height / VIRTUAL_TEXTURE_FEEDBACK_SCALE, 1u));
+        resources.VirtualTextureFeedback = g_renderGraph.ImportBuffer("Virtual Texture Feedback", g_virtualTextures.GetFeedbackBuffer());
+        resources.VirtualTextureFeedbackDepth = g_renderGraph.CreateTexture({.Label = "Virtual Texture Feedback Depth", .Format = TFormat::D24_UNORM_S8_UINT, .Extent = feedbackExtent});
+
+        g_virtualTextureFeedbackPass.GraphPass = g_renderGraph.AddPass("Virtual Texture Feedback Pass", [&renderContext] {
+            PROFILER_ZONESCOPEDN("Draw Virtual Texture Feedback");
+            g_virtualTextures.BeginFeedback();
+            SubmitCommandList(g_virtualTextureFeedbackPass.CommandList);
+            g_virtualTextures.EndFeedback(renderContext.FrameCounter);
+        });
+        g_renderGraph.Read(g_virtualTextureFeedbackPass.GraphPass, resources.CulledDraws, IndirectBuffer);
+        g_renderGraph.Read(g_virtualTextureFeedbackPass.GraphPass, resources.CulledDraws, StorageBuffer);
+        g_renderGraph.Write(g_virtualTextureFeedbackPass.GraphPass, resources.VirtualTextureFeedback, StorageBuffer);
+        g_renderGraph.WriteDepthStencilAttachment(g_virtualTextureFeedbackPass.GraphPass, resources.VirtualTextureFeedbackDepth, TFramebufferAttachmentLoadOperation::Clear, {1.0f, 0});
+    }
+
+    g_composePass.GraphPass = g_renderGraph.AddPass("Compose Pass", RenderComposePass);
+    for (const auto gBufferTexture : {resources.Depth, resources.Albedo, resources.Normals, resources.AoRoughnessMetalness, resources.Emissive}) {
+        g_renderGraph.Read(g_composePass.GraphPass, gBufferTexture, SampledTexture);
+    }
+    for (const auto shadowMap : resources.ShadowMaps) {
+        g_renderGraph.Read(g_composePass.GraphPass, shadowMap, SampledTexture);
+    }
+    g_renderGraph.Read(g_composePass.GraphPass, resources.LightClusters, StorageBuffer);
+    g_renderGraph.WriteColorAttachment(g_composePass.GraphPass, resources.Composed, 0, TFramebufferAttachmentLoadOperation::Clear, { 0.0f, 0.0f, 0.0f, 1.0f });
+
+    if (g_debugLinesPass.IsEnabled && !g_debugLinesPass.DebugLines.empty()) {
+        g_debugLinesPass.GraphPass = g_renderGraph.AddPass("Debug Lines", RenderDebugLines);
+        g_renderGraph.WriteColorAttachment(g_debugLinesPass.GraphPass, resources.Composed, 0, TFramebufferAttachmentLoadOperation::Load);
+    }
+
+    g_fxaaPass.GraphPass = g_renderGraph.AddPass("PostFX FXAA", RenderFxaaPass);
+    g_renderGraph.Read(g_fxaaPass.GraphPass, resources.Composed, SampledTexture);
+    g_renderGraph.WriteColorAttachment(g_fxaaPass.GraphPass, resources.Fxaa, 0, TFramebufferAttachmentLoadOperation::DontCare);
+
+    if (g_taaPass.IsEnabled) {
+        g_taaPass.GraphPass = g_renderGraph.AddPass("PostFX TAA", RenderTaaPass);
+        for (const auto taaInput : {resources.Composed, resources.TaaHistory, resources.Velocity, resources.Depth}) {
+            g_renderGraph.Read(g_taaPass.GraphPass, taaInput, SampledTexture);
+        }
+        g_renderGraph.WriteColorAttachment(g_taaPass.GraphPass, resources.TaaOutput, 0, TFramebufferAttachmentLoadOperation::DontCare);
+    }
+
+    // the editor shows whichever target is picked in the scene viewer, that one has to stay alive
+    const auto uiPass = g_renderGraph.AddPass("UI", [&renderContext, &registry] {
+        RenderUi(renderContext, registry);
+    });
+    g_renderGraph.SetSideEffect(uiPass);
+    g_renderGraph.Read(uiPass, resources.Output, SampledTexture);
+    if (g_isEditor) {
+        g_renderGraph.Read(uiPass, GetSceneViewerResource(g_sceneViewerTextureIndex), SampledTexture);
+    } else if (g_fxaaPass.IsEnabled) {
+        g_renderGraph.Read(uiPass, resources.Fxaa, SampledTexture);
+    }
+
+    g_renderGraph.Compile();
+}
+
+auto Renderer::ExtractSnapshot(
+    entt::registry& registry,
+    TRenderSnapshot& snapshot) -> void {
 
-    CreateGpuResourcesIfNecessary(registry);
+    PROFILER_ZONESCOPEDN("Extract Render Snapshot");
 
-    UpdateGlobalLights(registry);
+    snapshot.CameraEntity = entt::null;
+    registry.view<TComponentCamera, TComponentRenderTransform>().each([&](
+        const auto& entity,
+        const auto& cameraComponent,
+        const auto& renderTransform) {
+
+        snapshot.CameraEntity = entity;
+        snapshot.CameraMatrix = renderTransform;
+        snapshot.CameraFieldOfView = cameraComponent.FieldOfView;
+    });
 
-    UpdateAllTransforms(registry);
-    UpdateGlobalTransforms(registry);
+    snapshot.GlobalLights.clear();
+    const auto globalLightsView = registry.view<TComponentGlobalLight>();
+    for (const auto globalLightEntity : globalLightsView) {
+        snapshot.GlobalLights.push_back(globalLightsView.get<TComponentGlobalLight>(globalLightEntity));
+    }
+
+    // every snapshot is rendered, so changes since the previous extraction are all the renderer needs to know
+    auto* renderablesChanged = registry.ctx().find<TRenderablesChanged>();
+    snapshot.IsRenderableSetChanged = renderablesChanged == nullptr || renderablesChanged->IsChanged;
+    if (renderablesChanged != nullptr) {
+        renderablesChanged->IsChanged = false;
+    }
+    snapshot.MovedRenderables.clear();
+
+    // elements are overwritten in place, their strings keep their capacity from frame to frame
+    const auto renderablesView = registry.view<TComponentMesh, TComponentRenderTransform>();
+    std::size_t renderableCount = 0;
+    for (const auto entity : renderablesView) {
+        if (renderableCount == snapshot.Renderables.size()) {
+            snapshot.Renderables.emplace_back();
+        }
+
+        const auto* materialComponent = registry.try_get<TComponentMaterial>(entity);
+        auto& renderable = snapshot.Renderables[renderableCount++];
+        renderable.Entity = entity;
+        renderable.Mesh = renderablesView.get<TComponentMesh>(entity).Mesh;
+        if (materialComponent != nullptr) {
+            renderable.Material = materialComponent->Material;
+        } else {
+            renderable.Material.clear();
+        }
+        renderable.WorldMatrix = renderablesView.get<TComponentRenderTransform>(entity);
+        renderable.IsOccluder = registry.all_of<TComponentOccluder>(entity);
+        renderable.IsPlanet = registry.all_of<TComponentPlanet>(entity);
+        if (registry.all_of<TComponentRenderTransformDirty>(entity)) {
+            snapshot.MovedRenderables.push_back(static_cast<uint32_t>(renderableCount - 1));
+        }
+    }
+    snapshot.Renderables.resize(renderableCount);
+    registry.clear<TComponentRenderTransformDirty>();
+
+    snapshot.LocalLights.clear();
+    registry.view<TComponentPointLight, TComponentRenderTransform>().each([&](
+        const auto& pointLight,
+        const auto& renderTransform) {
+
+        snapshot.LocalLights.push_back(TRenderSnapshotLocalLight{
+            .Position = glm::vec3(renderTransform[3]),
+            .Radius = pointLight.Radius,
+            .Color = pointLight.Color,
+            .Intensity = pointLight.Intensity,
+        });
+    });
+    registry.view<TComponentSpotLight, TComponentRenderTransform>().each([&](
+        const auto& spotLight,
+        const auto& renderTransform) {
+
+        snapshot.LocalLights.push_back(TRenderSnapshotLocalLight{
+            .Position = glm::vec3(renderTransform[3]),
+            .Radius = spotLight.Radius,
+            .Color = spotLight.Color,
+            .Intensity = spotLight.Intensity,
+            .Direction = -glm::normalize(glm::vec3(renderTransform[2])),
+            .CosInnerConeAngle = glm::cos(spotLight.InnerConeAngle),
+            .CosOuterConeAngle = glm::cos(spotLight.OuterConeAngle),
+            .IsSpotLight = true,
+        });
+    });
+}
+
+auto Renderer::Render(
+    TRenderContext& renderContext,
+    const TRenderSnapshot& snapshot,
+    entt::registry& registry) -> void {
+
+    BeginRingBufferFrame(g_frameRingBuffer);
+#ifndef NDEBUG
+    ResetStateCacheStatistics();
+#endif
+    ResetDebugLines();
+
+    UpdateGlobalLights(snapshot);
+    UpdateLocalLights(snapshot);
+    UpdateGlobalTransforms(snapshot);
+    UpdateGpuScene(snapshot);
+    UpdateStreamedTextures(renderContext.FrameCounter);
+    g_virtualTextures.Update(renderContext.FrameCounter);
+    UpdateCpuOcclusion(snapshot);
 
     ResizeFramebuffersIfNecessary();
+    BuildRenderGraph(renderContext, registry);
+    RecordScenePasses(snapshot);
 
-    RenderShadowPass(registry);
-    RenderDepthPrePass(registry);
-    RenderGeometryPass(registry);
-    RenderComposePass();
-    RenderDebugLines();
+    g_renderGraph.Execute();
 
-    RenderFxaaPass();
-    RenderTaaPass();
-    RenderUi(renderContext, registry);
+    EndRingBufferFrame(g_frameRingBuffer);
 }
 
 auto Renderer::ResizeWindowFramebuffer(
@@ -2112,6 +3432,10 @@ auto Renderer::ToggleEditorMode() -> void {
     g_sceneViewerResized = g_isEditor;
 }
 
+auto Renderer::IsEditorMode() -> bool {
+    return g_isEditor;
+}
+
 auto UiUnload() -> void {
 
     ImGui_ImplOpenGL3_Shutdown();
@@ -2208,7 +3532,7 @@ auto UiRender(
 
     if (!g_isEditor) {
         ImGui::SetNextWindowPos({32, 32});
-        ImGui::SetNextWindowSize({168, 212});
+        ImGui::SetNextWindowSize({168, 262});
         auto windowBackgroundColor = ImGui::GetStyleColorVec4(ImGuiCol_WindowBg);
         windowBackgroundColor.w = 0.4f;
         ImGui::PushStyleColor(ImGuiCol_WindowBg, windowBackgroundColor);
@@ -2230,6 +3554,39 @@ auto UiRender(
             ImGui::TextColored(ImColor::HSV(0.16f, 1.0f, 1.0f), "      %.0f Hz (1%%)", renderContext.FramesPerSecond1P);
             ImGui::TextColored(ImColor::HSV(0.18f, 1.0f, 1.0f), "      %.0f Hz (0.1%%)", renderContext.FramesPerSecond01P);
             ImGui::Text("   f: %lu", renderContext.FrameCounter);
+            ImGui::Text(" lat: %.2f ms d: %u", renderContext.InputToPresentLatencyInSeconds * 1000.0f, renderContext.PipelineDepth);
+            ImGui::Text(" obj: %zu grp: %zu bat: %zu", g_indirectDrawData.Objects.size(), g_indirectDrawData.InstanceGroups.size(), g_indirectDrawData.Batches.size());
+            const auto& renderGraphStatistics = g_renderGraph.GetStatistics();
+            ImGui::Text("  rg: %u/%u passes %u/%u textures %u barriers",
+                        renderGraphStatistics.PassCount - renderGraphStatistics.CulledPassCount,
+                        renderGraphStatistics.PassCount,
+                        renderGraphStatistics.PhysicalTextureCount,
+                        renderGraphStatistics.TransientTextureCount,
+                        renderGraphStatistics.MemoryBarrierCount);
+            const auto& textureStreamingStatistics = g_textureStreamer.GetStatistics();
+            ImGui::Text(" tex: %zu/%zu MiB %u pending",
+                        textureStreamingStatistics.ResidentSizeInBytes / (1024 * 1024),
+                        textureStreamingStatistics.BudgetInBytes / (1024 * 1024),
+                        textureStreamingStatistics.PendingTextureCount);
+            const auto& virtualTextureStatistics = g_virtualTextures.GetStatistics();
+            ImGui::Text("  vt: %u pages %u pending %u failed",
+                        virtualTextureStatistics.ResidentPageCount,
+                        virtualTextureStatistics.PendingPageCount,
+                        virtualTextureStatistics.FailedPageCount);
+            if (g_cpuOcclusionPass.IsEnabled) {
+                const auto& occlusionStatistics = g_cpuOcclusionPass.Buffer.GetStatistics();
+                ImGui::Text(" occ: %u/%u (%.1f%%) tri: %u",
+                            occlusionStatistics.OccludedCount,
+                            occlusionStatistics.TestedCount,
+                            occlusionStatistics.GetCullRate() * 100.0f,
+                            occlusionStatistics.RasterizedTriangleCount);
+            }
+#ifndef NDEBUG
+            const auto& stateCacheStatistics = GetStateCacheStatistics();
+            ImGui::Text("  gl: %llu issued %llu skipped",
+                        static_cast<unsigned long long>(stateCacheStatistics.IssuedCallCount),
+                        static_cast<unsigned long long>(stateCacheStatistics.SkippedCallCount));
+#endif
             ImGui::PopFont();
 
             ImGui::PopFont();
@@ -2255,6 +3612,7 @@ auto UiRender(
                 ImGui::RadioButton("GBuffer-Normals", &g_sceneViewerTextureIndex, 3);
                 ImGui::RadioButton("GBuffer-Velocity", &g_sceneViewerTextureIndex, 4);
                 ImGui::RadioButton("GBuffer-Emissive", &g_sceneViewerTextureIndex, 5);
+                ImGui::RadioButton("GBuffer-AoRoughnessMetalness", &g_sceneViewerTextureIndex, 7);
                 if (g_fxaaPass.IsEnabled) {
                     ImGui::RadioButton("FXAA", &g_sceneViewerTextureIndex, 6);
                 }
@@ -2285,24 +3643,7 @@ auto UiRender(
             }();
             UiMagnifier(renderContext, g_sceneViewerScaledSize, g_uiViewportContentOffset, ImGui::IsItemHovered());
 
-            auto GetCurrentSceneViewerTexture = [&](const int32_t sceneViewerTextureIndex) -> uint32_t {
-                switch (sceneViewerTextureIndex) {
-                    case 0: return g_taaPass.IsEnabled
-                        ? g_taaPass.Framebuffers[g_taaPass.HistoryIndex].ColorAttachments[0]->Texture.Id
-                        : g_composePass.Framebuffer.ColorAttachments[0]->Texture.Id;
-                    case 1: return g_depthPrePass.Framebuffer.DepthStencilAttachment->Texture.Id;
-                    case 2: return g_geometryPass.Framebuffer.ColorAttachments[0]->Texture.Id;
-                    case 3: return g_geometryPass.Framebuffer.ColorAttachments[1]->Texture.Id;
-                    case 4: return g_geometryPass.Framebuffer.ColorAttachments[2]->Texture.Id;
-                    case 5: return g_geometryPass.Framebuffer.ColorAttachments[3]->Texture.Id;
-                    case 6: return g_fxaaPass.Framebuffer.ColorAttachments[0]->Texture.Id;
-                    default: std::unreachable();
-                }
-
-                std::unreachable();
-            };
-
-            const auto texture = GetCurrentSceneViewerTexture(g_sceneViewerTextureIndex);
+            const auto texture = g_renderGraph.GetTexture(GetSceneViewerResource(g_sceneViewerTextureIndex)).Id;
             ImGui::Image(texture, currentSceneWindowSize, g_uiUnitY, g_uiUnitX);
 
             if (g_selectedEntity != entt::null) {
@@ -2366,8 +3707,14 @@ auto UiRender(
                 g_sceneViewerResized = g_isEditor;
                 g_windowFramebufferResized = !g_isEditor;
             }
+            if (ImGui::SliderInt("Texture Budget (MiB)", &g_windowSettings.TextureStreamingBudgetInMegabytes, 64, 8192)) {
+                g_textureStreamer.SetBudget(static_cast<std::size_t>(g_windowSettings.TextureStreamingBudgetInMegabytes) * 1024 * 1024);
+            }
             ImGui::Checkbox("Enable FXAA", &g_fxaaPass.IsEnabled);
             ImGui::Checkbox("Enable TAA", &g_taaPass.IsEnabled);
+            ImGui::Checkbox("Enable Frustum Culling", &g_cullingPass.IsEnabled);
+            ImGui::Checkbox("Enable Occlusion Culling", &g_hiZPass.IsEnabled);
+            ImGui::Checkbox("Enable Cpu Occlusion Culling", &g_cpuOcclusionPass.IsEnabled);
             if (g_taaPass.IsEnabled) {
                 ImGui::DragFloat("TAA Blend Factor", &g_taaPass.BlendFactor, 0.01f, 0.01f, 1.0f, "%.2f");
             }
@@ -2440,6 +3787,7 @@ auto UiRender(
             PushDebugGroup("UI-ImGui");
             glViewport(0, 0, g_windowFramebufferSize.x, g_windowFramebufferSize.y);
             ImGui_ImplOpenGL3_RenderDrawData(imGuiDrawData);
+            InvalidateStateCache();
             PopDebugGroup();
         }
     }
@@ -2510,9 +3858,7 @@ auto UiMagnifier(
         const auto uv0{mp - magnifierHalfExtentUv};
         const auto uv1{mp + magnifierHalfExtentUv};
 
-        const auto& magnifierOutput = g_taaPass.IsEnabled
-          ? g_taaPass.Framebuffers[g_taaPass.HistoryIndex].ColorAttachments[0]->Texture.Id
-          : g_composePass.Framebuffer.ColorAttachments[0]->Texture.Id;
+        const auto magnifierOutput = g_renderGraph.GetTexture(g_renderGraphResources.Output).Id;
 
         ImGui::Image(magnifierOutput,
                      magnifierSize,
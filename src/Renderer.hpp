@@ -1,6 +1,10 @@
 #pragma once
 
 #include "WindowSettings.hpp"
+#include "Components.hpp"
+
+#include <string>
+#include <vector>
 
 struct GLFWwindow;
 
@@ -14,6 +18,43 @@ namespace Renderer {
         float FramesPerSecond01P;
         float AverageFramesPerSecond;
         uint64_t FrameCounter;
+        float InputToPresentLatencyInSeconds;
+        uint32_t PipelineDepth;
+    };
+
+    struct TRenderSnapshotRenderable {
+        entt::entity Entity = entt::null;
+        std::string Mesh;
+        std::string Material;
+        glm::mat4 WorldMatrix = glm::mat4{1.0f};
+        bool IsOccluder = false;
+        bool IsPlanet = false;
+    };
+
+    struct TRenderSnapshotLocalLight {
+        glm::vec3 Position = {};
+        float Radius = 0.0f;
+        glm::vec3 Color = {};
+        float Intensity = 0.0f;
+        glm::vec3 Direction = {}; // spot lights only
+        float CosInnerConeAngle = 0.0f;
+        float CosOuterConeAngle = 0.0f;
+        bool IsSpotLight = false;
+    };
+
+    // everything the renderer reads from the scene for one frame, extracted on the game thread right after
+    // the scene update, so the registry can move on to the next frame while this one is rendered
+    struct TRenderSnapshot {
+        uint64_t FrameIndex = 0;
+        double InputTimeInSeconds = 0.0;
+        entt::entity CameraEntity = entt::null;
+        glm::mat4 CameraMatrix = glm::mat4{1.0f};
+        float CameraFieldOfView = 60.0f;
+        std::vector<TComponentGlobalLight> GlobalLights;
+        std::vector<TRenderSnapshotRenderable> Renderables;
+        std::vector<uint32_t> MovedRenderables; // indices into Renderables whose WorldMatrix changed since the last snapshot
+        bool IsRenderableSetChanged = false; // renderables came, went or changed, the renderer rebuilds everything then
+        std::vector<TRenderSnapshotLocalLight> LocalLights;
     };
 
     auto Initialize(
@@ -21,11 +62,17 @@ namespace Renderer {
         GLFWwindow* window,
         const glm::vec2& initialFramebufferSize) -> bool;
     auto Unload() -> void;
+    auto ExtractSnapshot(
+        entt::registry& registry,
+        TRenderSnapshot& snapshot) -> void;
+    // registry is only touched by the editor ui, callers have to keep the game thread idle while editing
     auto Render(
         TRenderContext& renderContext,
+        const TRenderSnapshot& snapshot,
         entt::registry& registry) -> void;
     auto ResizeWindowFramebuffer(
         int32_t width,
         int32_t height) -> void;
     auto ToggleEditorMode() -> void;
+    auto IsEditorMode() -> bool;
 }
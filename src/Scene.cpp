@@ -4,14 +4,31 @@
 #include "Renderer.hpp"
 #include "Input.hpp"
 
+#include <glm/ext/matrix_transform.hpp>
 #include <glm/gtx/euler_angles.hpp>
 #include <glm/gtx/matrix_decompose.hpp>
 #include <glm/trigonometric.hpp>
 
+#include <format>
+
 constexpr auto g_unitX = glm::vec3{1.0f, 0.0f, 0.0f};
 constexpr auto g_unitY = glm::vec3{0.0f, 1.0f, 0.0f};
 constexpr auto g_unitZ = glm::vec3{0.0f, 0.0f, 1.0f};
 
+auto MarkRenderablesChanged(
+    entt::registry& registry,
+    entt::entity) -> void {
+
+    registry.ctx().get<TRenderablesChanged>().IsChanged = true;
+}
+
+template<typename TComponent>
+auto ConnectRenderablesChanged(entt::registry& registry) -> void {
+    registry.on_construct<TComponent>().template connect<&MarkRenderablesChanged>();
+    registry.on_update<TComponent>().template connect<&MarkRenderablesChanged>();
+    registry.on_destroy<TComponent>().template connect<&MarkRenderablesChanged>();
+}
+
 auto TScene::PlayerControlShip(
     Renderer::TRenderContext& renderContext,
     entt::registry& registry,
@@ -165,6 +182,14 @@ auto TScene::Load() -> bool {
     Assets::AddAssetModelFromFile("SM_Cube_x1_y1_z1", "data/basic/SM_Plane_007.glb");
 
     /// Setup Scene ////////////
+    // the renderer rebuilds its object table only when told renderables came, went or changed
+    _registry.ctx().emplace<TRenderablesChanged>();
+    ConnectRenderablesChanged<TComponentMesh>(_registry);
+    ConnectRenderablesChanged<TComponentMaterial>(_registry);
+    ConnectRenderablesChanged<TComponentRenderTransform>(_registry);
+    ConnectRenderablesChanged<TComponentOccluder>(_registry);
+    ConnectRenderablesChanged<TComponentPlanet>(_registry);
+
     _rootEntity = CreateEmpty("Root");
     auto sun1Light = CreateGlobalLight(
         "Sun Purple Light (N)",
@@ -217,6 +242,7 @@ auto TScene::Load() -> bool {
     _landingPadEntity = CreateModel("Landing Pad", "SM_Cube_x1_y1_z1");
     SetParent(_landingPadEntity, _rootEntity);
     SetPosition(_landingPadEntity, glm::vec3{-50.0f, -5.0f, 0.0f});
+    SetOccluder(_landingPadEntity);
 
     _shipEntity = CreateModel("SillyShip", "LessSillyShip");
     SetParent(_shipEntity, _rootEntity);
@@ -226,6 +252,34 @@ auto TScene::Load() -> bool {
     SetParent(capitalEntity, _rootEntity);
     SetScale(capitalEntity, glm::vec3{90.0f});
     SetPosition(capitalEntity, glm::vec3{0.0f, 30.0f, -200.0f});
+    SetOccluder(capitalEntity);
+
+    // running lights along both sides of the landing pad and a lamp above it
+    for (auto lightIndex = 0; lightIndex < 16; ++lightIndex) {
+        const auto side = lightIndex % 2 == 0 ? -1.0f : 1.0f;
+        const auto runningLight = CreatePointLight(
+            std::format("Running Light {}", lightIndex),
+            side < 0.0f ? glm::vec3{1.0f, 0.1f, 0.1f} : glm::vec3{0.1f, 1.0f, 0.1f},
+            4.0f,
+            6.0f);
+        SetParent(runningLight, _rootEntity);
+        SetPosition(runningLight, glm::vec3{-50.0f + side * 8.0f, -4.0f, -28.0f + static_cast<float>(lightIndex / 2) * 8.0f});
+    }
+
+    const auto padLamp = CreateSpotLight("Landing Pad Lamp", glm::vec3{1.0f, 0.9f, 0.7f}, 20.0f, 30.0f);
+    SetParent(padLamp, _rootEntity);
+    SetPosition(padLamp, glm::vec3{-50.0f, 15.0f, 0.0f});
+    SetOrientation(padLamp, glm::radians(-90.0f), 0.0f, 0.0f);
+
+    // base color comes from a virtual texture, see VirtualTexture.hpp
+    _marsEntity = CreateMesh("Mars", "SM_Geodesic", "M_Mars");
+    SetParent(_marsEntity, _rootEntity);
+    SetPosition(_marsEntity, glm::vec3{0.0f, 0.0f, 400.0f});
+    SetScale(_marsEntity, glm::vec3{100.0f});
+    AddComponent<TComponentPlanet>(_marsEntity, TComponentPlanet{
+        .Radius = 100.0,
+        .ResourcesCreated = false,
+    });
 
     return true;
 }
@@ -271,6 +325,55 @@ auto TScene::Update(
     } else {
         PlayerControlPlayer(renderContext, registry, controlState);
     }
+
+    UpdateTransforms(registry);
+}
+
+auto TScene::UpdateTransforms(entt::registry& registry) const -> void {
+
+    PROFILER_ZONESCOPEDN("Update Transforms");
+
+    const auto view = registry.view<TComponentPosition, TComponentOrientationEuler, TComponentScale, TComponentTransform, TComponentHierarchy>();
+    for (auto root : view) {
+        const auto& hierarchy = view.get<TComponentHierarchy>(root);
+        if (hierarchy.Parent != entt::null) {
+            continue;
+        }
+
+        std::stack<std::pair<entt::entity, const glm::mat4*>> stack;
+        stack.emplace(root, nullptr);
+
+        while (!stack.empty()) {
+            auto [entity, parentGlobal] = stack.top();
+            stack.pop();
+
+            auto& localPosition = registry.get<TComponentPosition>(entity);
+            auto& localOrientation = registry.get<TComponentOrientationEuler>(entity);
+            auto& localScale = registry.get<TComponentScale>(entity);
+            auto& globalTransform = registry.get<TComponentTransform>(entity);
+            auto& renderTransform = registry.get<TComponentRenderTransform>(entity);
+
+            glm::mat4 localMatrix = glm::translate(glm::mat4(1.0f), localPosition)
+                                  * glm::eulerAngleYXZ(localOrientation.Yaw, localOrientation.Pitch, localOrientation.Roll)
+                                  * glm::scale(glm::mat4(1.0f), localScale);
+
+            if (parentGlobal) {
+                globalTransform = *parentGlobal * localMatrix;
+            } else {
+                globalTransform = localMatrix;
+            }
+
+            if (static_cast<const glm::mat4&>(renderTransform) != static_cast<const glm::mat4&>(globalTransform)) {
+                renderTransform = globalTransform;
+                registry.emplace_or_replace<TComponentRenderTransformDirty>(entity);
+            }
+
+            const auto& entityHierarchy = registry.get<TComponentHierarchy>(entity);
+            for (auto child : entityHierarchy.Children) {
+                stack.emplace(child, &globalTransform);
+            }
+        }
+    }
 }
 
 auto TScene::GetRegistry() -> entt::registry& {
@@ -303,6 +406,30 @@ auto TScene::CreateGlobalLight(
     return entity;
 }
 
+auto TScene::CreatePointLight(
+    const std::string& name,
+    const glm::vec3& color,
+    const float intensity,
+    const float radius) -> entt::entity {
+
+    const auto entity = CreateEmpty(name);
+    _registry.emplace<TComponentPointLight>(entity, color, intensity, radius);
+    return entity;
+}
+
+auto TScene::CreateSpotLight(
+    const std::string& name,
+    const glm::vec3& color,
+    const float intensity,
+    const float radius,
+    const float innerConeAngle,
+    const float outerConeAngle) -> entt::entity {
+
+    const auto entity = CreateEmpty(name);
+    _registry.emplace<TComponentSpotLight>(entity, color, intensity, radius, innerConeAngle, outerConeAngle);
+    return entity;
+}
+
 auto TScene::CreateCamera(const std::string& name) -> entt::entity {
     const auto entity = CreateEmpty(name);
     _registry.emplace<TComponentCamera>(entity);
@@ -317,7 +444,6 @@ auto TScene::CreateMesh(
     const auto entity = CreateEmpty(name);
     _registry.emplace<TComponentMesh>(entity, assetMeshName);
     _registry.emplace<TComponentMaterial>(entity, assetMaterialName);
-    _registry.emplace<TComponentCreateGpuResourcesNecessary>(entity);
     return entity;
 }
 
@@ -422,3 +548,16 @@ auto TScene::SetScale(
         *scaleComponent = scale;
     }
 }
+
+auto TScene::SetOccluder(const entt::entity entity) -> void {
+
+    if (_registry.all_of<TComponentMesh>(entity)) {
+        _registry.emplace_or_replace<TComponentOccluder>(entity);
+    }
+
+    if (const auto* hierarchy = _registry.try_get<TComponentHierarchy>(entity)) {
+        for (const auto child : hierarchy->Children) {
+            SetOccluder(child);
+        }
+    }
+}
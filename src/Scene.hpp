@@ -24,6 +24,18 @@ public:
         const glm::vec3& color = {1.0f, 1.0f, 1.0f},
         float intensity = 1.0f,
         float canCastShadows = false) -> entt::entity;
+    auto CreatePointLight(
+        const std::string& name = "Point Light",
+        const glm::vec3& color = {1.0f, 1.0f, 1.0f},
+        float intensity = 1.0f,
+        float radius = 10.0f) -> entt::entity;
+    auto CreateSpotLight(
+        const std::string& name = "Spot Light",
+        const glm::vec3& color = {1.0f, 1.0f, 1.0f},
+        float intensity = 1.0f,
+        float radius = 10.0f,
+        float innerConeAngle = 0.35f,
+        float outerConeAngle = 0.5f) -> entt::entity;
     auto CreateCamera(const std::string& name = "Camera") -> entt::entity;
     auto CreateModel(
         const std::string& name,
@@ -42,6 +54,7 @@ public:
     auto SetScale(
         entt::entity entity,
         const glm::vec3& scale) -> void;
+    auto SetOccluder(entt::entity entity) -> void;
 
     template<typename TComponent, typename... Args>
     TComponent& AddComponent(entt::entity entity, Args&&... args) {
@@ -67,6 +80,7 @@ private:
         Renderer::TRenderContext& renderContext,
         entt::registry& registry,
         const TControlState& controlState) -> void;
+    auto UpdateTransforms(entt::registry& registry) const -> void;
 
     auto CreateMesh(
         const std::string& name,
@@ -0,0 +1,434 @@
+#include "TextureStreaming.hpp"
+#include "RHI.hpp"
+#include "Profiler.hpp"
+#include "Images.hpp"
+
+#include <glad/gl.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <format>
+
+namespace {
+
+constexpr auto ToIndex(const TStreamedTextureId textureId) -> std::size_t {
+    return static_cast<std::size_t>(textureId);
+}
+
+constexpr auto GetMipExtent(
+    const uint32_t size,
+    const uint32_t mip) -> uint32_t {
+
+    return std::max(size >> mip, 1u);
+}
+
+}
+
+auto TTextureStreamer::Initialize(const std::size_t budgetInBytes) -> void {
+
+    BudgetInBytes = budgetInBytes;
+    Statistics.BudgetInBytes = budgetInBytes;
+    Worker = std::jthread([this](const std::stop_token stopToken) {
+        WorkerLoop(stopToken);
+    });
+}
+
+auto TTextureStreamer::SetBudget(const std::size_t budgetInBytes) -> void {
+
+    BudgetInBytes = budgetInBytes;
+    Statistics.BudgetInBytes = budgetInBytes;
+}
+
+auto TTextureStreamer::CreateTexture(
+    const std::string_view label,
+    const uint32_t width,
+    const uint32_t height,
+    const void* pixels,
+    const bool isSrgb,
+    const uint32_t sampler) -> TStreamedTextureId {
+
+    PROFILER_ZONESCOPEDN("TextureStreamer::CreateTexture");
+
+    const auto textureId = static_cast<TStreamedTextureId>(Textures.size());
+    auto& texture = Textures.emplace_back(TStreamedTexture{
+        .Label = std::string(label),
+        .Width = width,
+        .Height = height,
+        .MipCount = static_cast<uint32_t>(std::bit_width(std::max(width, height))),
+        .IsSrgb = isSrgb,
+        .Sampler = sampler,
+    });
+
+    while (std::max(GetMipExtent(width, texture.TailMip), GetMipExtent(height, texture.TailMip)) > TEXTURE_STREAMING_TAIL_SIZE) {
+        texture.TailMip++;
+    }
+
+    texture.MipChain = std::make_unique<TMipChain>();
+    texture.MipChain->Width = width;
+    texture.MipChain->Height = height;
+    texture.MipChain->EndMip = texture.MipCount;
+    texture.MipChain->IsSrgb = isSrgb;
+    texture.MipChain->Levels.resize(texture.MipCount);
+    auto& baseLevel = texture.MipChain->Levels[0];
+    baseLevel.resize(static_cast<std::size_t>(width) * height * 4);
+    std::memcpy(baseLevel.data(), pixels, baseLevel.size());
+
+    // sampled straight from the base level so the texture shows up right away, the worker replaces it
+    std::vector<std::vector<std::byte>> tailLevels(texture.MipCount);
+    for (auto mip = texture.TailMip; mip < texture.MipCount; mip++) {
+        tailLevels[mip] = Image::ResampleRgba8(
+            baseLevel,
+            width,
+            height,
+            GetMipExtent(width, mip),
+            GetMipExtent(height, mip),
+            isSrgb);
+    }
+    texture.HasFinalTail = texture.TailMip == 0;
+
+    Reallocate(texture, texture.TailMip, tailLevels);
+
+    // small enough to be resident as a whole, there is nothing left to stream
+    if (texture.HasFinalTail) {
+        baseLevel = std::vector<std::byte>();
+        texture.MipChain->IsReady.store(true, std::memory_order_release);
+        return textureId;
+    }
+
+    QueueMipChain(*texture.MipChain);
+
+    return textureId;
+}
+
+auto TTextureStreamer::RequestMip(
+    const TStreamedTextureId textureId,
+    const float uvPerPixel) -> void {
+
+    auto& texture = Textures[ToIndex(textureId)];
+    const auto texelsPerPixel = uvPerPixel * static_cast<float>(std::max(texture.Width, texture.Height));
+    const auto mip = texelsPerPixel > 1.0f
+        ? std::min(static_cast<uint32_t>(std::log2(texelsPerPixel)), texture.TailMip)
+        : 0u;
+
+    texture.RequestedMip = texture.IsRequested
+        ? std::min(texture.RequestedMip, mip)
+        : mip;
+    texture.IsRequested = true;
+}
+
+auto TTextureStreamer::GetBindlessHandle(const TStreamedTextureId textureId) const -> uint64_t {
+    return Textures[ToIndex(textureId)].BindlessHandle;
+}
+
+auto TTextureStreamer::GetResidentMip(const TStreamedTextureId textureId) const -> uint32_t {
+    return Textures[ToIndex(textureId)].ResidentMip;
+}
+
+auto TTextureStreamer::Update(const uint64_t frameIndex) -> std::vector<TStreamedTextureId> {
+
+    PROFILER_ZONESCOPEDN("TextureStreamer::Update");
+
+    std::vector<TStreamedTextureId> changedTextures;
+    Statistics.UploadedSizeInBytes = 0;
+    Statistics.StreamedInMipCount = 0;
+    Statistics.EvictedMipCount = 0;
+
+    std::erase_if(RetiredTextures, [&](const TRetiredTexture& retiredTexture) {
+        if (retiredTexture.RetiredFrame + RING_BUFFER_FRAME_COUNT > frameIndex) {
+            return false;
+        }
+        glMakeTextureHandleNonResidentARB(retiredTexture.BindlessHandle);
+        glDeleteTextures(1, &retiredTexture.Texture);
+        return true;
+    });
+
+    FrameIndex = frameIndex;
+    for (auto& texture : Textures) {
+        if (texture.IsRequested) {
+            texture.LastRequestedFrame = frameIndex;
+        } else {
+            texture.RequestedMip = texture.TailMip;
+        }
+
+        if (!texture.HasFinalTail && texture.MipChain->IsReady.load(std::memory_order_acquire)) {
+            for (auto mip = texture.TailMip; mip < texture.MipCount; mip++) {
+                glTextureSubImage2D(
+                    texture.Texture,
+                    static_cast<int32_t>(mip - texture.ResidentMip),
+                    0,
+                    0,
+                    static_cast<int32_t>(GetMipExtent(texture.Width, mip)),
+                    static_cast<int32_t>(GetMipExtent(texture.Height, mip)),
+                    GL_RGBA,
+                    GL_UNSIGNED_BYTE,
+                    texture.MipChain->Levels[mip].data());
+                texture.MipChain->Levels[mip] = std::vector<std::byte>();
+            }
+            texture.HasFinalTail = true;
+        }
+    }
+
+    // the budget might have shrunk
+    if (ResidentSizeInBytes > BudgetInBytes) {
+        MakeRoom(0, nullptr, changedTextures);
+    }
+
+    std::vector<std::size_t> pendingTextureIndices;
+    for (auto textureIndex = 0u; textureIndex < Textures.size(); textureIndex++) {
+        const auto& texture = Textures[textureIndex];
+        if (texture.RequestedMip < texture.ResidentMip && texture.MipChain->IsReady.load(std::memory_order_acquire)) {
+            pendingTextureIndices.push_back(textureIndex);
+        }
+    }
+
+    // the textures furthest away from what they need go first
+    std::ranges::stable_sort(pendingTextureIndices, std::ranges::greater{}, [this](const std::size_t textureIndex) {
+        return Textures[textureIndex].ResidentMip - Textures[textureIndex].RequestedMip;
+    });
+
+    for (const auto textureIndex : pendingTextureIndices) {
+        auto& texture = Textures[textureIndex];
+
+        auto targetMip = texture.RequestedMip;
+        while (targetMip + 1 < texture.ResidentMip &&
+               Statistics.UploadedSizeInBytes + GetMipRangeSizeInBytes(texture, targetMip, texture.ResidentMip) > TEXTURE_STREAMING_MAX_UPLOAD_BYTES_PER_FRAME) {
+            targetMip++;
+        }
+
+        if (Statistics.UploadedSizeInBytes > 0 &&
+            Statistics.UploadedSizeInBytes + GetMipRangeSizeInBytes(texture, targetMip, texture.ResidentMip) > TEXTURE_STREAMING_MAX_UPLOAD_BYTES_PER_FRAME) {
+            continue;
+        }
+
+        if (!MakeRoom(GetMipRangeSizeInBytes(texture, targetMip, texture.ResidentMip), &texture, changedTextures)) {
+            while (targetMip < texture.ResidentMip &&
+                   ResidentSizeInBytes + GetMipRangeSizeInBytes(texture, targetMip, texture.ResidentMip) > BudgetInBytes) {
+                targetMip++;
+            }
+            if (targetMip == texture.ResidentMip) {
+                continue;
+            }
+        }
+
+        Statistics.UploadedSizeInBytes += GetMipRangeSizeInBytes(texture, targetMip, texture.ResidentMip);
+        Statistics.StreamedInMipCount += texture.ResidentMip - targetMip;
+        Reallocate(texture, targetMip, texture.MipChain->Levels);
+        changedTextures.push_back(static_cast<TStreamedTextureId>(textureIndex));
+    }
+
+    Statistics.TextureCount = static_cast<uint32_t>(Textures.size());
+    Statistics.PendingTextureCount = 0;
+    for (auto& texture : Textures) {
+        if (texture.RequestedMip < texture.ResidentMip) {
+            Statistics.PendingTextureCount++;
+        }
+        texture.IsRequested = false;
+    }
+    Statistics.ResidentSizeInBytes = ResidentSizeInBytes;
+
+    // a texture can give up mips more than once per update
+    std::ranges::sort(changedTextures);
+    const auto [first, last] = std::ranges::unique(changedTextures);
+    changedTextures.erase(first, last);
+
+    return changedTextures;
+}
+
+auto TTextureStreamer::Destroy() -> void {
+
+    if (Worker.joinable()) {
+        Worker.request_stop();
+        Worker.join();
+    }
+    WorkerQueue.clear();
+
+    for (const auto& texture : Textures) {
+        glMakeTextureHandleNonResidentARB(texture.BindlessHandle);
+        glDeleteTextures(1, &texture.Texture);
+    }
+    for (const auto& retiredTexture : RetiredTextures) {
+        glMakeTextureHandleNonResidentARB(retiredTexture.BindlessHandle);
+        glDeleteTextures(1, &retiredTexture.Texture);
+    }
+
+    Textures.clear();
+    RetiredTextures.clear();
+    ResidentSizeInBytes = 0;
+    Statistics = {};
+}
+
+auto TTextureStreamer::GetMipSizeInBytes(
+    const TStreamedTexture& texture,
+    const uint32_t mip) const -> std::size_t {
+
+    return static_cast<std::size_t>(GetMipExtent(texture.Width, mip)) * GetMipExtent(texture.Height, mip) * 4;
+}
+
+auto TTextureStreamer::GetMipRangeSizeInBytes(
+    const TStreamedTexture& texture,
+    const uint32_t firstMip,
+    const uint32_t lastMip) const -> std::size_t {
+
+    auto sizeInBytes = std::size_t{0};
+    for (auto mip = firstMip; mip < lastMip; mip++) {
+        sizeInBytes += GetMipSizeInBytes(texture, mip);
+    }
+
+    return sizeInBytes;
+}
+
+auto TTextureStreamer::Reallocate(
+    TStreamedTexture& texture,
+    const uint32_t residentMip,
+    std::vector<std::vector<std::byte>>& levels) -> void {
+
+    PROFILER_ZONESCOPEDN("TextureStreamer::Reallocate");
+
+    uint32_t newTexture = 0;
+    glCreateTextures(GL_TEXTURE_2D, 1, &newTexture);
+    glTextureStorage2D(
+        newTexture,
+        static_cast<int32_t>(texture.MipCount - residentMip),
+        texture.IsSrgb ? GL_SRGB8_ALPHA8 : GL_RGBA8,
+        static_cast<int32_t>(GetMipExtent(texture.Width, residentMip)),
+        static_cast<int32_t>(GetMipExtent(texture.Height, residentMip)));
+    SetDebugLabel(newTexture, GL_TEXTURE, std::format("{}-Mip{}", texture.Label, residentMip));
+
+    for (auto mip = residentMip; mip < texture.MipCount; mip++) {
+        const auto mipWidth = static_cast<int32_t>(GetMipExtent(texture.Width, mip));
+        const auto mipHeight = static_cast<int32_t>(GetMipExtent(texture.Height, mip));
+        if (texture.Texture != 0 && mip >= texture.ResidentMip) {
+            glCopyImageSubData(
+                texture.Texture, GL_TEXTURE_2D, static_cast<int32_t>(mip - texture.ResidentMip), 0, 0, 0,
+                newTexture, GL_TEXTURE_2D, static_cast<int32_t>(mip - residentMip), 0, 0, 0,
+                mipWidth, mipHeight, 1);
+        } else {
+            glTextureSubImage2D(
+                newTexture,
+                static_cast<int32_t>(mip - residentMip),
+                0,
+                0,
+                mipWidth,
+                mipHeight,
+                GL_RGBA,
+                GL_UNSIGNED_BYTE,
+                levels[mip].data());
+            if (mip > 0) {
+                levels[mip] = std::vector<std::byte>();
+            }
+        }
+    }
+
+    const auto newBindlessHandle = glGetTextureSamplerHandleARB(newTexture, texture.Sampler);
+    glMakeTextureHandleResidentARB(newBindlessHandle);
+
+    if (texture.Texture != 0) {
+        ResidentSizeInBytes -= GetMipRangeSizeInBytes(texture, texture.ResidentMip, texture.MipCount);
+        RetiredTextures.push_back(TRetiredTexture{
+            .Texture = texture.Texture,
+            .BindlessHandle = texture.BindlessHandle,
+            .RetiredFrame = FrameIndex,
+        });
+    }
+
+    texture.Texture = newTexture;
+    texture.BindlessHandle = newBindlessHandle;
+    texture.ResidentMip = residentMip;
+    ResidentSizeInBytes += GetMipRangeSizeInBytes(texture, texture.ResidentMip, texture.MipCount);
+}
+
+auto TTextureStreamer::MakeRoom(
+    const std::size_t sizeInBytes,
+    const TStreamedTexture* requestingTexture,
+    std::vector<TStreamedTextureId>& changedTextures) -> bool {
+
+    if (ResidentSizeInBytes + sizeInBytes <= BudgetInBytes) {
+        return true;
+    }
+
+    // only mips finer than what a texture needs this frame are up for eviction
+    std::vector<std::size_t> evictableTextureIndices;
+    for (auto textureIndex = 0u; textureIndex < Textures.size(); textureIndex++) {
+        const auto& texture = Textures[textureIndex];
+        // a chain the worker is still filling can't lose more levels until it is done
+        if (&texture != requestingTexture &&
+            texture.ResidentMip < texture.RequestedMip &&
+            texture.MipChain->IsReady.load(std::memory_order_acquire)) {
+            evictableTextureIndices.push_back(textureIndex);
+        }
+    }
+
+    std::ranges::stable_sort(evictableTextureIndices, std::ranges::less{}, [this](const std::size_t textureIndex) {
+        return Textures[textureIndex].LastRequestedFrame;
+    });
+
+    for (const auto textureIndex : evictableTextureIndices) {
+        auto& texture = Textures[textureIndex];
+
+        auto evictedSizeInBytes = std::size_t{0};
+        auto targetMip = texture.ResidentMip;
+        while (targetMip < texture.RequestedMip && ResidentSizeInBytes + sizeInBytes > BudgetInBytes + evictedSizeInBytes) {
+            evictedSizeInBytes += GetMipSizeInBytes(texture, targetMip);
+            targetMip++;
+        }
+
+        Statistics.EvictedMipCount += targetMip - texture.ResidentMip;
+        Reallocate(texture, targetMip, texture.MipChain->Levels);
+        changedTextures.push_back(static_cast<TStreamedTextureId>(textureIndex));
+
+        // the evicted levels were freed when they became resident, the worker derives them again
+        texture.MipChain->EndMip = targetMip;
+        texture.MipChain->IsReady.store(false, std::memory_order_relaxed);
+        QueueMipChain(*texture.MipChain);
+
+        if (ResidentSizeInBytes + sizeInBytes <= BudgetInBytes) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto TTextureStreamer::QueueMipChain(TMipChain& mipChain) -> void {
+
+    {
+        std::lock_guard lock(WorkerMutex);
+        WorkerQueue.push_back(&mipChain);
+    }
+    WorkerCondition.notify_one();
+}
+
+auto TTextureStreamer::WorkerLoop(const std::stop_token stopToken) -> void {
+
+    while (!stopToken.stop_requested()) {
+        TMipChain* mipChain = nullptr;
+        {
+            std::unique_lock lock(WorkerMutex);
+            if (!WorkerCondition.wait(lock, stopToken, [this] { return !WorkerQueue.empty(); })) {
+                return;
+            }
+            mipChain = WorkerQueue.front();
+            WorkerQueue.erase(WorkerQueue.begin());
+        }
+
+        PROFILER_ZONESCOPEDN("TextureStreamer::BuildMipChain");
+        for (auto mip = 1u; mip < mipChain->EndMip; mip++) {
+            if (stopToken.stop_requested()) {
+                return;
+            }
+            if (!mipChain->Levels[mip].empty()) {
+                continue;
+            }
+            mipChain->Levels[mip] = Image::ResampleRgba8(
+                mipChain->Levels[mip - 1],
+                GetMipExtent(mipChain->Width, mip - 1),
+                GetMipExtent(mipChain->Height, mip - 1),
+                GetMipExtent(mipChain->Width, mip),
+                GetMipExtent(mipChain->Height, mip),
+                mipChain->IsSrgb);
+        }
+        mipChain->IsReady.store(true, std::memory_order_release);
+    }
+}
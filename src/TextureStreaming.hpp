@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Core.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using TStreamedTextureId = TId<struct GStreamedTextureId>;
+
+// mips no larger than this are uploaded when a texture is created and never evicted
+constexpr auto TEXTURE_STREAMING_TAIL_SIZE = 64u;
+// upload bytes per Update, a single mip is always allowed through so large base levels still make progress
+constexpr auto TEXTURE_STREAMING_MAX_UPLOAD_BYTES_PER_FRAME = 16u * 1024u * 1024u;
+
+struct TTextureStreamingStatistics {
+    std::size_t BudgetInBytes = 0;
+    std::size_t ResidentSizeInBytes = 0;
+    std::size_t UploadedSizeInBytes = 0; // during the last Update
+    uint32_t TextureCount = 0;
+    uint32_t PendingTextureCount = 0; // with a resident mip coarser than requested
+    uint32_t StreamedInMipCount = 0; // during the last Update
+    uint32_t EvictedMipCount = 0; // during the last Update
+};
+
+// rgba8 textures which start with their mip tail resident, Update streams finer mips in as far as callers
+// ask for them and the budget allows, evicting the least recently needed ones
+struct TTextureStreamer {
+    TTextureStreamer() = default;
+    TTextureStreamer(const TTextureStreamer&) = delete;
+    auto operator=(const TTextureStreamer&) -> TTextureStreamer& = delete;
+
+    auto Initialize(std::size_t budgetInBytes) -> void;
+    auto SetBudget(std::size_t budgetInBytes) -> void;
+
+    // copies the base level, pixels are tightly packed rgba8
+    auto CreateTexture(
+        std::string_view label,
+        uint32_t width,
+        uint32_t height,
+        const void* pixels,
+        bool isSrgb,
+        uint32_t sampler) -> TStreamedTextureId;
+
+    // uvPerPixel is how much of the [0, 1] uv range one screen pixel covers where the texture is sampled,
+    // the finest request per frame wins
+    auto RequestMip(
+        TStreamedTextureId textureId,
+        float uvPerPixel) -> void;
+
+    auto GetBindlessHandle(TStreamedTextureId textureId) const -> uint64_t;
+    auto GetResidentMip(TStreamedTextureId textureId) const -> uint32_t;
+
+    // call once per frame after all requests, returns the textures which got a new bindless handle
+    auto Update(uint64_t frameIndex) -> std::vector<TStreamedTextureId>;
+
+    auto GetStatistics() const -> const TTextureStreamingStatistics& { return Statistics; }
+
+    // deletes all textures and stops the worker, the streamer can be initialized again afterwards
+    auto Destroy() -> void;
+
+private:
+    // the worker fills the empty levels in [1, EndMip) from the base level, which is always kept. the
+    // texture only reads Levels once IsReady is set, resident levels other than the base are freed
+    struct TMipChain {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t EndMip = 0;
+        bool IsSrgb = false;
+        std::vector<std::vector<std::byte>> Levels;
+        std::atomic<bool> IsReady = false;
+    };
+
+    struct TStreamedTexture {
+        std::string Label;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t MipCount = 0;
+        uint32_t TailMip = 0; // first mip no larger than TEXTURE_STREAMING_TAIL_SIZE
+        uint32_t ResidentMip = 0; // finest resident mip, mips [ResidentMip, MipCount) are resident
+        uint32_t RequestedMip = 0; // finest mip requested this frame
+        uint64_t LastRequestedFrame = 0;
+        bool IsRequested = false;
+        bool IsSrgb = false;
+        bool HasFinalTail = false; // the tail uploaded at creation was a quick approximation
+        uint32_t Texture = 0; // a new one with a new bindless handle whenever the resident mips change
+        uint32_t Sampler = 0;
+        uint64_t BindlessHandle = 0;
+        std::unique_ptr<TMipChain> MipChain;
+    };
+
+    // deleted once no frame in flight can sample it anymore
+    struct TRetiredTexture {
+        uint32_t Texture = 0;
+        uint64_t BindlessHandle = 0;
+        uint64_t RetiredFrame = 0;
+    };
+
+    auto GetMipSizeInBytes(
+        const TStreamedTexture& texture,
+        uint32_t mip) const -> std::size_t;
+    auto GetMipRangeSizeInBytes(
+        const TStreamedTexture& texture,
+        uint32_t firstMip,
+        uint32_t lastMip) const -> std::size_t;
+    // moves the resident range of texture to [residentMip, MipCount), mips which are resident already
+    // are copied on the gpu, the others are uploaded from levels and freed, except the base level
+    auto Reallocate(
+        TStreamedTexture& texture,
+        uint32_t residentMip,
+        std::vector<std::vector<std::byte>>& levels) -> void;
+    // evicts mips nobody needs right now until sizeInBytes fits into the budget, least recently requested first
+    auto MakeRoom(
+        std::size_t sizeInBytes,
+        const TStreamedTexture* requestingTexture,
+        std::vector<TStreamedTextureId>& changedTextures) -> bool;
+    auto QueueMipChain(TMipChain& mipChain) -> void;
+    auto WorkerLoop(std::stop_token stopToken) -> void;
+
+    std::vector<TStreamedTexture> Textures;
+    std::vector<TRetiredTexture> RetiredTextures;
+    std::size_t BudgetInBytes = 0;
+    std::size_t ResidentSizeInBytes = 0;
+    uint64_t FrameIndex = 0;
+    TTextureStreamingStatistics Statistics = {};
+
+    std::mutex WorkerMutex;
+    std::condition_variable_any WorkerCondition;
+    std::vector<TMipChain*> WorkerQueue;
+    std::jthread Worker;
+};
@@ -0,0 +1,596 @@
+#include "VirtualTexture.hpp"
+#include "Cache.hpp"
+#include "Images.hpp"
+#include "Profiler.hpp"
+
+#include <glad/gl.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <unordered_map>
+
+namespace {
+
+constexpr auto VIRTUAL_TEXTURE_CACHE_CATEGORY = "virtualtextures";
+constexpr auto VIRTUAL_TEXTURE_FILE_MAGIC = 0x58545456u; // "VTTX"
+constexpr auto VIRTUAL_TEXTURE_FILE_VERSION = 1u;
+constexpr auto VIRTUAL_TEXTURE_PAGE_SIZE_IN_BYTES = static_cast<std::size_t>(VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER) * VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER * 4;
+constexpr auto VIRTUAL_TEXTURE_INVALID_SLOT = std::numeric_limits<uint32_t>::max();
+
+// followed by the pages of every mip, finest first, row by row
+struct TVirtualTextureFileHeader {
+    uint32_t Magic = 0;
+    uint32_t Version = 0;
+    uint32_t Width = 0;
+    uint32_t Height = 0;
+    uint32_t PageSize = 0;
+    uint32_t PageBorder = 0;
+    uint32_t MipCount = 0;
+    uint32_t PageCount = 0;
+};
+
+constexpr auto GetMipExtent(
+    const uint32_t size,
+    const uint32_t mip) -> uint32_t {
+
+    return std::max(size >> mip, 1u);
+}
+
+constexpr auto GetMipPageCount(
+    const uint32_t size,
+    const uint32_t mip) -> uint32_t {
+
+    return (GetMipExtent(size, mip) + VIRTUAL_TEXTURE_PAGE_SIZE - 1) / VIRTUAL_TEXTURE_PAGE_SIZE;
+}
+
+// mips stop at the first one which fits into a single page
+constexpr auto GetVirtualTextureMipCount(
+    const uint32_t width,
+    const uint32_t height) -> uint32_t {
+
+    auto mipCount = 1u;
+    while (GetMipPageCount(width, mipCount - 1) > 1 || GetMipPageCount(height, mipCount - 1) > 1) {
+        mipCount++;
+    }
+
+    return mipCount;
+}
+
+auto GetPageFileOffset(const uint32_t page) -> uint64_t {
+    return sizeof(TVirtualTextureFileHeader) + static_cast<uint64_t>(page) * VIRTUAL_TEXTURE_PAGE_SIZE_IN_BYTES;
+}
+
+// borders wrap horizontally and clamp vertically, which is what equirectangular planet maps need
+auto CreatePageFile(
+    const uint32_t width,
+    const uint32_t height,
+    const uint32_t mipCount,
+    const uint32_t pageCount,
+    const std::span<const std::byte> pixels) -> std::vector<std::byte> {
+
+    PROFILER_ZONESCOPEDN("Create Virtual Texture Page File");
+
+    std::vector<std::byte> pageFile(GetPageFileOffset(pageCount));
+    const auto header = TVirtualTextureFileHeader{
+        .Magic = VIRTUAL_TEXTURE_FILE_MAGIC,
+        .Version = VIRTUAL_TEXTURE_FILE_VERSION,
+        .Width = width,
+        .Height = height,
+        .PageSize = VIRTUAL_TEXTURE_PAGE_SIZE,
+        .PageBorder = VIRTUAL_TEXTURE_PAGE_BORDER,
+        .MipCount = mipCount,
+        .PageCount = pageCount,
+    };
+    std::memcpy(pageFile.data(), &header, sizeof(header));
+
+    std::vector<std::byte> level(pixels.begin(), pixels.end());
+    auto page = 0u;
+    for (auto mip = 0u; mip < mipCount; mip++) {
+        const auto mipWidth = GetMipExtent(width, mip);
+        const auto mipHeight = GetMipExtent(height, mip);
+        if (mip > 0) {
+            level = Image::ResampleRgba8(level, GetMipExtent(width, mip - 1), GetMipExtent(height, mip - 1), mipWidth, mipHeight, true);
+        }
+
+        for (auto pageY = 0u; pageY < GetMipPageCount(height, mip); pageY++) {
+            for (auto pageX = 0u; pageX < GetMipPageCount(width, mip); pageX++) {
+                auto* pageTexels = pageFile.data() + GetPageFileOffset(page++);
+                for (auto y = 0u; y < VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER; y++) {
+                    const auto sourceY = std::clamp(
+                        static_cast<int64_t>(pageY * VIRTUAL_TEXTURE_PAGE_SIZE + y) - VIRTUAL_TEXTURE_PAGE_BORDER,
+                        int64_t{0},
+                        static_cast<int64_t>(mipHeight) - 1);
+                    for (auto x = 0u; x < VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER; x++) {
+                        const auto sourceX = (static_cast<int64_t>(pageX * VIRTUAL_TEXTURE_PAGE_SIZE + x) - VIRTUAL_TEXTURE_PAGE_BORDER + mipWidth) % mipWidth;
+                        std::memcpy(
+                            pageTexels + (static_cast<std::size_t>(y) * VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER + x) * 4,
+                            level.data() + (static_cast<std::size_t>(sourceY) * mipWidth + sourceX) * 4,
+                            4);
+                    }
+                }
+            }
+        }
+    }
+
+    return pageFile;
+}
+
+auto ReadPage(
+    std::ifstream& file,
+    const uint64_t fileOffset) -> std::optional<std::vector<std::byte>> {
+
+    std::vector<std::byte> texels(VIRTUAL_TEXTURE_PAGE_SIZE_IN_BYTES);
+    file.seekg(static_cast<std::streamoff>(fileOffset));
+    file.read(reinterpret_cast<char*>(texels.data()), static_cast<std::streamsize>(texels.size()));
+    if (!file || file.gcount() != static_cast<std::streamsize>(texels.size())) {
+        file.clear();
+        return std::nullopt;
+    }
+
+    return texels;
+}
+
+}
+
+auto TVirtualTextureSystem::Initialize() -> void {
+
+    constexpr auto physicalPagesSize = VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE * VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER;
+    PhysicalPagesTexture = ::CreateTexture(TCreateTextureDescriptor{
+        .TextureType = TTextureType::Texture2D,
+        .Format = TFormat::R8G8B8A8_SRGB,
+        .Extent = TExtent3D{physicalPagesSize, physicalPagesSize, 1u},
+        .MipMapLevels = 1,
+        .Layers = 1,
+        .SampleCount = TSampleCount::One,
+        .Label = "Virtual Texture Physical Pages",
+    });
+    const auto samplerId = GetOrCreateSampler(TSamplerDescriptor{
+        .Label = "Virtual Texture Physical Pages",
+        .AddressModeU = TTextureAddressMode::ClampToEdge,
+        .AddressModeV = TTextureAddressMode::ClampToEdge,
+        .MagFilter = TTextureMagFilter::Linear,
+        .MinFilter = TTextureMinFilter::Linear,
+    });
+    PhysicalPagesHandle = MakeTextureResident(PhysicalPagesTexture, samplerId);
+    PhysicalSlots.assign(VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE * VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE, {});
+
+    VirtualTexturesBuffer = CreateBuffer("TGpuVirtualTextures", sizeof(TGpuVirtualTexture) * VIRTUAL_TEXTURE_MAX_TEXTURES, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    PageTableBuffer = CreateBuffer("Virtual Texture Page Table", sizeof(uint32_t) * VIRTUAL_TEXTURE_MAX_PAGES, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    FeedbackBuffer = CreateBuffer("Virtual Texture Feedback", sizeof(uint32_t) * VIRTUAL_TEXTURE_MAX_PAGES, nullptr, GL_DYNAMIC_STORAGE_BIT);
+    for (auto& feedbackReadback : FeedbackReadbacks) {
+        constexpr auto readbackFlags = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        feedbackReadback.Buffer = CreateBuffer("Virtual Texture Feedback Readback", sizeof(uint32_t) * VIRTUAL_TEXTURE_MAX_PAGES, nullptr, readbackFlags | GL_CLIENT_STORAGE_BIT);
+        feedbackReadback.Data = static_cast<const uint32_t*>(glMapNamedBufferRange(feedbackReadback.Buffer, 0, sizeof(uint32_t) * VIRTUAL_TEXTURE_MAX_PAGES, readbackFlags));
+    }
+
+    Worker = std::jthread([this](const std::stop_token stopToken) {
+        WorkerLoop(stopToken);
+    });
+}
+
+auto TVirtualTextureSystem::Destroy() -> void {
+
+    if (Worker.joinable()) {
+        Worker.request_stop();
+        Worker.join();
+    }
+    PageRequests.clear();
+    LoadedPages.clear();
+
+    for (auto& feedbackReadback : FeedbackReadbacks) {
+        if (feedbackReadback.Fence != nullptr) {
+            glDeleteSync(static_cast<GLsync>(feedbackReadback.Fence));
+        }
+        if (feedbackReadback.Buffer != 0) {
+            glUnmapNamedBuffer(feedbackReadback.Buffer);
+            DeleteBuffer(feedbackReadback.Buffer);
+        }
+        feedbackReadback = {};
+    }
+    DeleteBuffer(FeedbackBuffer);
+    DeleteBuffer(PageTableBuffer);
+    DeleteBuffer(VirtualTexturesBuffer);
+
+    if (PhysicalPagesTexture != TTextureId::Invalid) {
+        glMakeTextureHandleNonResidentARB(PhysicalPagesHandle);
+        DeleteTexture(PhysicalPagesTexture);
+        PhysicalPagesTexture = TTextureId::Invalid;
+    }
+
+    Textures.clear();
+    GpuTextures.clear();
+    PhysicalSlots.clear();
+    PageCount = 0;
+    Statistics = {};
+}
+
+auto TVirtualTextureSystem::CreateTexture(
+    const std::string_view label,
+    const uint32_t width,
+    const uint32_t height,
+    const std::span<const std::byte> pixels) -> std::expected<TVirtualTextureId, std::string> {
+
+    PROFILER_ZONESCOPEDN("VirtualTextureSystem::CreateTexture");
+
+    if (Textures.size() >= VIRTUAL_TEXTURE_MAX_TEXTURES) {
+        return std::unexpected(std::format("Unable to create more than {} virtual textures", VIRTUAL_TEXTURE_MAX_TEXTURES));
+    }
+
+    auto virtualTexture = TVirtualTexture{
+        .Label = std::string(label),
+        .Width = width,
+        .Height = height,
+        .MipCount = GetVirtualTextureMipCount(width, height),
+        .FirstPage = PageCount,
+    };
+
+    auto texturePageCount = 0u;
+    for (auto mip = 0u; mip < virtualTexture.MipCount; mip++) {
+        virtualTexture.MipFirstPages.push_back(texturePageCount);
+        texturePageCount += GetMipPageCount(width, mip) * GetMipPageCount(height, mip);
+    }
+    if (PageCount + texturePageCount > VIRTUAL_TEXTURE_MAX_PAGES) {
+        return std::unexpected(std::format("Virtual texture {} needs {} pages, only {} are left", label, texturePageCount, VIRTUAL_TEXTURE_MAX_PAGES - PageCount));
+    }
+
+    // the key covers the pixels and the page layout, the header check catches truncated files
+    const auto layout = std::array{width, height, VIRTUAL_TEXTURE_PAGE_SIZE, VIRTUAL_TEXTURE_PAGE_BORDER, VIRTUAL_TEXTURE_FILE_VERSION};
+    const auto cacheKey = Cache::HashBytes(pixels, Cache::HashBytes(std::as_bytes(std::span(layout))));
+    virtualTexture.FilePath = Cache::GetFilePath(VIRTUAL_TEXTURE_CACHE_CATEGORY, cacheKey);
+
+    auto isPageFileValid = false;
+    {
+        std::ifstream file{virtualTexture.FilePath, std::ifstream::binary};
+        TVirtualTextureFileHeader header = {};
+        std::error_code errorCode;
+        isPageFileValid = file.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            header.Magic == VIRTUAL_TEXTURE_FILE_MAGIC &&
+            header.Version == VIRTUAL_TEXTURE_FILE_VERSION &&
+            header.PageCount == texturePageCount &&
+            std::filesystem::file_size(virtualTexture.FilePath, errorCode) == GetPageFileOffset(texturePageCount);
+    }
+
+    if (!isPageFileValid) {
+        const auto pageFile = CreatePageFile(width, height, virtualTexture.MipCount, texturePageCount, pixels);
+        if (!Cache::Store(VIRTUAL_TEXTURE_CACHE_CATEGORY, cacheKey, pageFile)) {
+            return std::unexpected(std::format("Unable to write the page file of virtual texture {}", label));
+        }
+        spdlog::info("VirtualTexture: Created page file for {} with {} pages in {} mips", label, texturePageCount, virtualTexture.MipCount);
+    }
+
+    virtualTexture.PageStates.assign(texturePageCount, TPageState::NotResident);
+    virtualTexture.PagePhysicalSlots.assign(texturePageCount, VIRTUAL_TEXTURE_INVALID_SLOT);
+    virtualTexture.PageTable.assign(texturePageCount, 0u);
+
+    const auto textureIndex = static_cast<uint32_t>(Textures.size());
+    Textures.push_back(std::move(virtualTexture));
+    PageCount += texturePageCount;
+
+    // the coarsest mip is loaded right away and never leaves, every lookup falls back to it
+    auto& createdTexture = Textures.back();
+    const auto coarsestPage = createdTexture.MipFirstPages.back();
+    std::ifstream file{createdTexture.FilePath, std::ifstream::binary};
+    const auto texels = ReadPage(file, GetPageFileOffset(coarsestPage));
+    if (!texels || !UploadPage(textureIndex, coarsestPage, *texels, 0, true)) {
+        Textures.pop_back();
+        PageCount -= texturePageCount;
+        return std::unexpected(std::format("Unable to load the coarsest mip of virtual texture {}", label));
+    }
+    UpdatePageTable(createdTexture);
+
+    const auto& gpuTexture = GpuTextures.emplace_back(TGpuVirtualTexture{
+        .PhysicalPages = PhysicalPagesHandle,
+        .Width = width,
+        .Height = height,
+        .MipCount = createdTexture.MipCount,
+        .FirstPage = createdTexture.FirstPage,
+        ._padding1 = 0,
+        ._padding2 = 0,
+    });
+    UpdateBuffer(VirtualTexturesBuffer, sizeof(TGpuVirtualTexture) * textureIndex, sizeof(TGpuVirtualTexture), &gpuTexture);
+
+    return static_cast<TVirtualTextureId>(textureIndex);
+}
+
+auto TVirtualTextureSystem::BeginFeedback() -> void {
+
+    ClearBuffer(FeedbackBuffer, 0, sizeof(uint32_t) * PageCount);
+}
+
+auto TVirtualTextureSystem::EndFeedback(const uint64_t frameIndex) -> void {
+
+    // still in flight when the gpu runs more than RING_BUFFER_FRAME_COUNT frames behind, skip this one
+    auto& feedbackReadback = FeedbackReadbacks[frameIndex % RING_BUFFER_FRAME_COUNT];
+    if (feedbackReadback.Fence != nullptr) {
+        return;
+    }
+
+    glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+    glCopyNamedBufferSubData(FeedbackBuffer, feedbackReadback.Buffer, 0, 0, sizeof(uint32_t) * PageCount);
+    feedbackReadback.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    feedbackReadback.FrameIndex = frameIndex;
+}
+
+auto TVirtualTextureSystem::Update(const uint64_t frameIndex) -> void {
+
+    PROFILER_ZONESCOPEDN("VirtualTextureSystem::Update");
+
+    Statistics.UploadedPageCount = 0;
+    Statistics.EvictedPageCount = 0;
+
+    // oldest finished feedback first, so the newest one decides what counts as needed
+    std::array<TFeedbackReadback*, RING_BUFFER_FRAME_COUNT> finishedReadbacks = {};
+    auto finishedReadbackCount = 0u;
+    for (auto& feedbackReadback : FeedbackReadbacks) {
+        if (feedbackReadback.Fence == nullptr) {
+            continue;
+        }
+        const auto waitResult = glClientWaitSync(static_cast<GLsync>(feedbackReadback.Fence), 0, 0);
+        if (waitResult == GL_ALREADY_SIGNALED || waitResult == GL_CONDITION_SATISFIED) {
+            finishedReadbacks[finishedReadbackCount++] = &feedbackReadback;
+        }
+    }
+    std::ranges::sort(std::span(finishedReadbacks.data(), finishedReadbackCount), std::ranges::less{}, &TFeedbackReadback::FrameIndex);
+    for (auto readbackIndex = 0u; readbackIndex < finishedReadbackCount; readbackIndex++) {
+        auto& feedbackReadback = *finishedReadbacks[readbackIndex];
+        ProcessFeedback(feedbackReadback.Data, frameIndex);
+        glDeleteSync(static_cast<GLsync>(feedbackReadback.Fence));
+        feedbackReadback.Fence = nullptr;
+    }
+
+    std::vector<TLoadedPage> loadedPages;
+    {
+        std::lock_guard lock(WorkerMutex);
+        const auto uploadCount = std::min(LoadedPages.size(), static_cast<std::size_t>(VIRTUAL_TEXTURE_MAX_PAGE_UPLOADS_PER_FRAME));
+        loadedPages.assign(
+            std::make_move_iterator(LoadedPages.begin()),
+            std::make_move_iterator(LoadedPages.begin() + static_cast<std::ptrdiff_t>(uploadCount)));
+        LoadedPages.erase(LoadedPages.begin(), LoadedPages.begin() + static_cast<std::ptrdiff_t>(uploadCount));
+    }
+
+    for (const auto& loadedPage : loadedPages) {
+        // pages which do not fit are requested again by the next feedback that still needs them,
+        // the worker already reported pages which failed to load, asking again would fail the same way
+        if (loadedPage.Texels.empty()) {
+            Textures[loadedPage.Texture].PageStates[loadedPage.Page] = TPageState::Failed;
+        } else if (!UploadPage(loadedPage.Texture, loadedPage.Page, loadedPage.Texels, frameIndex, false)) {
+            Textures[loadedPage.Texture].PageStates[loadedPage.Page] = TPageState::NotResident;
+        }
+    }
+
+    Statistics.TextureCount = static_cast<uint32_t>(Textures.size());
+    Statistics.ResidentPageCount = 0;
+    Statistics.PendingPageCount = 0;
+    Statistics.FailedPageCount = 0;
+    for (auto& virtualTexture : Textures) {
+        if (virtualTexture.IsPageTableDirty) {
+            UpdatePageTable(virtualTexture);
+        }
+        for (const auto pageState : virtualTexture.PageStates) {
+            Statistics.ResidentPageCount += pageState == TPageState::Resident ? 1 : 0;
+            Statistics.PendingPageCount += pageState == TPageState::Pending ? 1 : 0;
+            Statistics.FailedPageCount += pageState == TPageState::Failed ? 1 : 0;
+        }
+    }
+}
+
+auto TVirtualTextureSystem::ProcessFeedback(
+    const uint32_t* requestedPages,
+    const uint64_t frameIndex) -> void {
+
+    PROFILER_ZONESCOPEDN("VirtualTextureSystem::ProcessFeedback");
+
+    LastFeedbackFrame = frameIndex;
+
+    std::vector<TPageRequest> pageRequests;
+    for (auto textureIndex = 0u; textureIndex < Textures.size(); textureIndex++) {
+        const auto& virtualTexture = Textures[textureIndex];
+        for (auto mip = 0u; mip < virtualTexture.MipCount; mip++) {
+            const auto pageCountX = GetMipPageCount(virtualTexture.Width, mip);
+            const auto pageCountY = GetMipPageCount(virtualTexture.Height, mip);
+            const auto* mipRequestedPages = requestedPages + virtualTexture.FirstPage + virtualTexture.MipFirstPages[mip];
+            for (auto pageY = 0u; pageY < pageCountY; pageY++) {
+                for (auto pageX = 0u; pageX < pageCountX; pageX++) {
+                    if (mipRequestedPages[pageY * pageCountX + pageX] != 0) {
+                        RequestPage(textureIndex, mip, pageX, pageY, frameIndex, pageRequests);
+                    }
+                }
+            }
+        }
+    }
+
+    if (pageRequests.empty()) {
+        return;
+    }
+
+    // coarse pages first, they cover the most screen while the finer ones are on their way
+    std::ranges::stable_sort(pageRequests, std::ranges::greater{}, &TPageRequest::FileOffset);
+    {
+        std::lock_guard lock(WorkerMutex);
+        for (auto& pageRequest : pageRequests) {
+            PageRequests.push_back(std::move(pageRequest));
+        }
+    }
+    WorkerCondition.notify_one();
+}
+
+auto TVirtualTextureSystem::RequestPage(
+    const uint32_t textureIndex,
+    const uint32_t mip,
+    const uint32_t pageX,
+    const uint32_t pageY,
+    const uint64_t frameIndex,
+    std::vector<TPageRequest>& pageRequests) -> void {
+
+    auto& virtualTexture = Textures[textureIndex];
+
+    // ancestors are needed as well, they are what gets sampled until this page arrives
+    for (auto ancestorMip = mip; ancestorMip < virtualTexture.MipCount; ancestorMip++) {
+        const auto shift = ancestorMip - mip;
+        const auto page = virtualTexture.MipFirstPages[ancestorMip] +
+            (pageY >> shift) * GetMipPageCount(virtualTexture.Width, ancestorMip) +
+            (pageX >> shift);
+
+        switch (virtualTexture.PageStates[page]) {
+            case TPageState::Resident:
+                PhysicalSlots[virtualTexture.PagePhysicalSlots[page]].LastNeededFrame = frameIndex;
+                break;
+            case TPageState::NotResident:
+                virtualTexture.PageStates[page] = TPageState::Pending;
+                pageRequests.push_back(TPageRequest{
+                    .Texture = textureIndex,
+                    .Page = page,
+                    .FilePath = virtualTexture.FilePath,
+                    .FileOffset = GetPageFileOffset(page),
+                });
+                break;
+            case TPageState::Pending:
+            case TPageState::Failed:
+                break;
+        }
+    }
+}
+
+auto TVirtualTextureSystem::AllocatePhysicalSlot() -> std::optional<uint32_t> {
+
+    // a free slot, otherwise the page needed least recently which the newest feedback did not ask for
+    std::optional<uint32_t> evictableSlot = std::nullopt;
+    for (auto slot = 0u; slot < PhysicalSlots.size(); slot++) {
+        const auto& physicalSlot = PhysicalSlots[slot];
+        if (!physicalSlot.IsUsed) {
+            return slot;
+        }
+        if (physicalSlot.IsPinned || physicalSlot.LastNeededFrame >= LastFeedbackFrame) {
+            continue;
+        }
+        if (!evictableSlot || physicalSlot.LastNeededFrame < PhysicalSlots[*evictableSlot].LastNeededFrame) {
+            evictableSlot = slot;
+        }
+    }
+
+    if (evictableSlot) {
+        auto& physicalSlot = PhysicalSlots[*evictableSlot];
+        auto& virtualTexture = Textures[physicalSlot.Texture];
+        virtualTexture.PageStates[physicalSlot.Page] = TPageState::NotResident;
+        virtualTexture.PagePhysicalSlots[physicalSlot.Page] = VIRTUAL_TEXTURE_INVALID_SLOT;
+        virtualTexture.IsPageTableDirty = true;
+        physicalSlot = {};
+        Statistics.EvictedPageCount++;
+    }
+
+    return evictableSlot;
+}
+
+auto TVirtualTextureSystem::UploadPage(
+    const uint32_t textureIndex,
+    const uint32_t page,
+    const std::span<const std::byte> texels,
+    const uint64_t frameIndex,
+    const bool isPinned) -> bool {
+
+    const auto slot = AllocatePhysicalSlot();
+    if (!slot) {
+        return false;
+    }
+
+    UploadTexture(PhysicalPagesTexture, TUploadTextureDescriptor{
+        .Level = 0,
+        .Offset = TOffset3D{
+            (*slot % VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE) * VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER,
+            (*slot / VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE) * VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER,
+            0u
+        },
+        .Extent = TExtent3D{VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER, VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER, 1u},
+        .UploadFormat = TUploadFormat::Auto,
+        .UploadType = TUploadType::Auto,
+        .PixelData = texels.data(),
+    });
+
+    PhysicalSlots[*slot] = TPhysicalSlot{
+        .Texture = textureIndex,
+        .Page = page,
+        .LastNeededFrame = frameIndex,
+        .IsUsed = true,
+        .IsPinned = isPinned,
+    };
+
+    auto& virtualTexture = Textures[textureIndex];
+    virtualTexture.PageStates[page] = TPageState::Resident;
+    virtualTexture.PagePhysicalSlots[page] = *slot;
+    virtualTexture.IsPageTableDirty = true;
+    Statistics.UploadedPageCount++;
+
+    return true;
+}
+
+auto TVirtualTextureSystem::UpdatePageTable(TVirtualTexture& virtualTexture) -> void {
+
+    // coarse to fine, so pages which are not resident can inherit their parent's entry
+    for (auto mip = virtualTexture.MipCount; mip-- > 0;) {
+        const auto pageCountX = GetMipPageCount(virtualTexture.Width, mip);
+        const auto pageCountY = GetMipPageCount(virtualTexture.Height, mip);
+        for (auto pageY = 0u; pageY < pageCountY; pageY++) {
+            for (auto pageX = 0u; pageX < pageCountX; pageX++) {
+                const auto page = virtualTexture.MipFirstPages[mip] + pageY * pageCountX + pageX;
+                const auto slot = virtualTexture.PagePhysicalSlots[page];
+                if (slot != VIRTUAL_TEXTURE_INVALID_SLOT) {
+                    virtualTexture.PageTable[page] =
+                        (slot % VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE) |
+                        (slot / VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE) << 8 |
+                        mip << 16;
+                } else if (mip + 1 < virtualTexture.MipCount) {
+                    const auto parentPage = virtualTexture.MipFirstPages[mip + 1] +
+                        (pageY / 2) * GetMipPageCount(virtualTexture.Width, mip + 1) +
+                        pageX / 2;
+                    virtualTexture.PageTable[page] = virtualTexture.PageTable[parentPage];
+                }
+            }
+        }
+    }
+
+    UpdateBuffer(
+        PageTableBuffer,
+        sizeof(uint32_t) * virtualTexture.FirstPage,
+        sizeof(uint32_t) * virtualTexture.PageTable.size(),
+        virtualTexture.PageTable.data());
+    virtualTexture.IsPageTableDirty = false;
+}
+
+auto TVirtualTextureSystem::WorkerLoop(const std::stop_token stopToken) -> void {
+
+    std::unordered_map<std::string, std::ifstream> files;
+    while (!stopToken.stop_requested()) {
+        TPageRequest pageRequest;
+        {
+            std::unique_lock lock(WorkerMutex);
+            if (!WorkerCondition.wait(lock, stopToken, [this] { return !PageRequests.empty(); })) {
+                return;
+            }
+            pageRequest = std::move(PageRequests.front());
+            PageRequests.pop_front();
+        }
+
+        PROFILER_ZONESCOPEDN("VirtualTextureSystem::LoadPage");
+
+        auto& file = files[pageRequest.FilePath.string()];
+        if (!file.is_open()) {
+            file.open(pageRequest.FilePath, std::ifstream::binary);
+        }
+
+        // an empty page tells Update the load failed
+        auto texels = ReadPage(file, pageRequest.FileOffset);
+        if (!texels) {
+            spdlog::error("VirtualTexture: Unable to read page {} from {}", pageRequest.Page, pageRequest.FilePath.string());
+        }
+
+        std::lock_guard lock(WorkerMutex);
+        LoadedPages.push_back(TLoadedPage{
+            .Texture = pageRequest.Texture,
+            .Page = pageRequest.Page,
+            .Texels = texels.value_or(std::vector<std::byte>{}),
+        });
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include "RHI.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <expected>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using TVirtualTextureId = TId<struct GVirtualTextureId>;
+
+// mirrored in Include.VirtualTexture.glsl
+constexpr auto VIRTUAL_TEXTURE_PAGE_SIZE = 128u;
+// texels every page repeats from its neighbours, so bilinear filtering never reads across pages
+constexpr auto VIRTUAL_TEXTURE_PAGE_BORDER = 4u;
+constexpr auto VIRTUAL_TEXTURE_PAGE_SIZE_WITH_BORDER = VIRTUAL_TEXTURE_PAGE_SIZE + 2 * VIRTUAL_TEXTURE_PAGE_BORDER;
+// the physical page cache holds this many pages per side and never grows
+constexpr auto VIRTUAL_TEXTURE_PHYSICAL_PAGES_PER_SIDE = 24u;
+
+constexpr auto VIRTUAL_TEXTURE_MAX_TEXTURES = 64u;
+constexpr auto VIRTUAL_TEXTURE_MAX_PAGES = 64u * 1024u; // over all mips of all virtual textures
+constexpr auto VIRTUAL_TEXTURE_MAX_PAGE_UPLOADS_PER_FRAME = 16u;
+// the feedback pass renders at 1 / VIRTUAL_TEXTURE_FEEDBACK_SCALE of the framebuffer resolution
+constexpr auto VIRTUAL_TEXTURE_FEEDBACK_SCALE = 8u;
+
+// mirrors TGpuVirtualTexture in Include.VirtualTexture.glsl
+struct TGpuVirtualTexture {
+    uint64_t PhysicalPages;
+    uint32_t Width;
+    uint32_t Height;
+    uint32_t MipCount;
+    uint32_t FirstPage; // into the page table and the feedback buffer
+    uint32_t _padding1;
+    uint32_t _padding2;
+};
+
+struct TVirtualTextureStatistics {
+    uint32_t TextureCount = 0;
+    uint32_t ResidentPageCount = 0;
+    uint32_t PendingPageCount = 0;
+    uint32_t FailedPageCount = 0;
+    uint32_t UploadedPageCount = 0; // during the last Update
+    uint32_t EvictedPageCount = 0; // during the last Update
+};
+
+// color textures far larger than anything that fits into vram at once. every virtual texture is cut into
+// bordered pages per mip and written into a page file in the cache. a feedback pass renders the scene at
+// low resolution and flags every page the virtual textured materials would sample, Update reads the flags
+// a few frames later, a worker thread reads missing pages from their file and Update copies them into the
+// physical page cache, evicting the least recently needed pages. the page table points every page at
+// the physical page holding it or its closest resident ancestor, the coarsest mip is always resident
+struct TVirtualTextureSystem {
+    TVirtualTextureSystem() = default;
+    TVirtualTextureSystem(const TVirtualTextureSystem&) = delete;
+    auto operator=(const TVirtualTextureSystem&) -> TVirtualTextureSystem& = delete;
+
+    auto Initialize() -> void;
+    auto Destroy() -> void;
+
+    // pixels are tightly packed srgb rgba8, the page file is only written when the cache has none for them
+    auto CreateTexture(
+        std::string_view label,
+        uint32_t width,
+        uint32_t height,
+        std::span<const std::byte> pixels) -> std::expected<TVirtualTextureId, std::string>;
+
+    auto IsEmpty() const -> bool { return Textures.empty(); }
+
+    // bound at 6, 7 and 8, see Include.VirtualTexture.glsl
+    auto GetVirtualTexturesBuffer() const -> uint32_t { return VirtualTexturesBuffer; }
+    auto GetPageTableBuffer() const -> uint32_t { return PageTableBuffer; }
+    auto GetFeedbackBuffer() const -> uint32_t { return FeedbackBuffer; }
+
+    // around the feedback draws, clears the flags and copies them out to be read back by a later Update
+    auto BeginFeedback() -> void;
+    auto EndFeedback(uint64_t frameIndex) -> void;
+
+    // reads back finished feedback, queues missing pages and uploads the ones the worker has loaded
+    auto Update(uint64_t frameIndex) -> void;
+
+    auto GetStatistics() const -> const TVirtualTextureStatistics& { return Statistics; }
+
+private:
+    enum class TPageState : uint8_t {
+        NotResident,
+        Pending,
+        Resident,
+        Failed, // unreadable from the page file, not requested again, its ancestors are sampled instead
+    };
+
+    struct TVirtualTexture {
+        std::string Label = {};
+        std::filesystem::path FilePath = {};
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        uint32_t MipCount = 0;
+        uint32_t FirstPage = 0;
+        std::vector<uint32_t> MipFirstPages = {};
+        std::vector<TPageState> PageStates = {};
+        std::vector<uint32_t> PagePhysicalSlots = {};
+        std::vector<uint32_t> PageTable = {};
+        bool IsPageTableDirty = true;
+    };
+
+    struct TPhysicalSlot {
+        uint32_t Texture = 0;
+        uint32_t Page = 0;
+        uint64_t LastNeededFrame = 0;
+        bool IsUsed = false;
+        bool IsPinned = false; // coarsest mip
+    };
+
+    struct TPageRequest {
+        uint32_t Texture = 0;
+        uint32_t Page = 0;
+        std::filesystem::path FilePath;
+        uint64_t FileOffset = 0;
+    };
+
+    struct TLoadedPage {
+        uint32_t Texture = 0;
+        uint32_t Page = 0;
+        std::vector<std::byte> Texels;
+    };
+
+    struct TFeedbackReadback {
+        uint32_t Buffer = 0;
+        const uint32_t* Data = nullptr;
+        void* Fence = nullptr;
+        uint64_t FrameIndex = 0;
+    };
+
+    auto ProcessFeedback(
+        const uint32_t* requestedPages,
+        uint64_t frameIndex) -> void;
+    auto RequestPage(
+        uint32_t textureIndex,
+        uint32_t mip,
+        uint32_t pageX,
+        uint32_t pageY,
+        uint64_t frameIndex,
+        std::vector<TPageRequest>& pageRequests) -> void;
+    auto AllocatePhysicalSlot() -> std::optional<uint32_t>;
+    auto UploadPage(
+        uint32_t textureIndex,
+        uint32_t page,
+        std::span<const std::byte> texels,
+        uint64_t frameIndex,
+        bool isPinned) -> bool;
+    auto UpdatePageTable(TVirtualTexture& virtualTexture) -> void;
+    auto WorkerLoop(std::stop_token stopToken) -> void;
+
+    std::vector<TVirtualTexture> Textures;
+    std::vector<TGpuVirtualTexture> GpuTextures;
+    uint32_t PageCount = 0;
+
+    TTextureId PhysicalPagesTexture = TTextureId::Invalid;
+    uint64_t PhysicalPagesHandle = 0;
+    std::vector<TPhysicalSlot> PhysicalSlots;
+
+    uint32_t VirtualTexturesBuffer = 0;
+    uint32_t PageTableBuffer = 0;
+    uint32_t FeedbackBuffer = 0;
+    std::array<TFeedbackReadback, RING_BUFFER_FRAME_COUNT> FeedbackReadbacks = {};
+    uint64_t LastFeedbackFrame = 0;
+
+    TVirtualTextureStatistics Statistics = {};
+
+    std::mutex WorkerMutex;
+    std::condition_variable_any WorkerCondition;
+    std::deque<TPageRequest> PageRequests;
+    std::vector<TLoadedPage> LoadedPages;
+    std::jthread Worker;
+};
@@ -12,6 +12,7 @@ struct TWindowSettings {
     int32_t ResolutionWidth;
     int32_t ResolutionHeight;
     float ResolutionScale;
+    int32_t TextureStreamingBudgetInMegabytes;
     TWindowStyle WindowStyle;
     bool IsDebug;
     bool IsVSyncEnabled;